@@ -8,6 +8,19 @@
 #define UART0_CONF_BAUD_RATE       NRF_UART_BAUDRATE_115200
 #endif
 /*---------------------------------------------------------------------------*/
+/*
+ * Timer and PPI channel driving background RSSI capture in the IEEE radio
+ * driver. TIMER0 belongs to rtimer, and ble_dtm claims TIMER1 and PPI
+ * channels 0 and 1.
+ */
+#ifndef NRF52840_CONF_RSSI_CAPTURE_TIMER
+#define NRF52840_CONF_RSSI_CAPTURE_TIMER       NRF_TIMER2
+#endif
+
+#ifndef NRF52840_CONF_RSSI_CAPTURE_PPI_CHANNEL
+#define NRF52840_CONF_RSSI_CAPTURE_PPI_CHANNEL NRF_PPI_CHANNEL2
+#endif
+/*---------------------------------------------------------------------------*/
 #if NRF52840_NATIVE_USB
 
 #ifndef DBG_CONF_USB
@@ -176,6 +176,24 @@ typedef struct rx_buf_s {
 
 static rx_buf_t rx_buf;
 /*---------------------------------------------------------------------------*/
+/*
+ * Background RSSI capture. The capture timer counts at 1 MHz and clears
+ * itself on COMPARE0. PPI connects COMPARE0 to RADIO->RSSISTART so the radio
+ * samples without CPU involvement, and the RSSIEND interrupt stores each
+ * sample. A full batch pauses sampling and is handed to batch() from the
+ * driver process, which resumes sampling if asked to. Turning the radio off
+ * or changing channel may happen from interrupt context under TSCH, so it
+ * only marks the capture as ending and leaves the final batch to the process.
+ */
+#define RSSI_CAPTURE_TIMER       NRF52840_CONF_RSSI_CAPTURE_TIMER
+#define RSSI_CAPTURE_PPI_CHANNEL NRF52840_CONF_RSSI_CAPTURE_PPI_CHANNEL
+
+static radio_rssi_capture_t *volatile rssi_capture;
+static volatile uint16_t rssi_capture_cnt;
+static volatile bool rssi_capture_full;
+static volatile bool rssi_capture_ending;
+static volatile int8_t rssi_capture_last;
+/*---------------------------------------------------------------------------*/
 typedef struct rf_cfg_s {
   bool poll_mode;
   nrf_radio_txpower_t txpower;
@@ -286,6 +304,11 @@ setup_interrupts(void)
     interrupts |= NRF_RADIO_INT_CRCOK_MASK | NRF_RADIO_INT_CRCERROR_MASK;
   }
 
+  if(rssi_capture != NULL && !rssi_capture_ending) {
+    nrf_radio_event_clear(NRF_RADIO_EVENT_RSSIEND);
+    interrupts |= NRF_RADIO_INT_RSSIEND_MASK;
+  }
+
   /* Make sure all interrupts are disabled before we enable selectively */
   nrf_radio_int_disable(0xFFFFFFFF);
   NVIC_ClearPendingIRQ(RADIO_IRQn);
@@ -425,12 +448,174 @@ enter_rx(void)
           (uint32_t)nrf_radio_packetptr_get(), (uint32_t)&rx_buf);
 }
 /*---------------------------------------------------------------------------*/
+/* (Re)start sampling into an empty buffer */
+static void
+rssi_capture_resume(void)
+{
+  rssi_capture_cnt = 0;
+  rssi_capture_full = false;
+
+  nrf_timer_task_trigger(RSSI_CAPTURE_TIMER, NRF_TIMER_TASK_CLEAR);
+  nrf_ppi_channel_enable(RSSI_CAPTURE_PPI_CHANNEL);
+  nrf_timer_task_trigger(RSSI_CAPTURE_TIMER, NRF_TIMER_TASK_START);
+}
+/*---------------------------------------------------------------------------*/
+/* Stop sampling, leaving the request attached */
+static void
+rssi_capture_pause(void)
+{
+  nrf_ppi_channel_disable(RSSI_CAPTURE_PPI_CHANNEL);
+  nrf_timer_task_trigger(RSSI_CAPTURE_TIMER, NRF_TIMER_TASK_STOP);
+}
+/*---------------------------------------------------------------------------*/
+/* Stop the capture hardware and detach the request. Returns the request */
+static radio_rssi_capture_t *
+rssi_capture_halt(void)
+{
+  radio_rssi_capture_t *capture = rssi_capture;
+
+  rssi_capture_pause();
+  rssi_capture = NULL;
+  rssi_capture_full = false;
+  rssi_capture_ending = false;
+  setup_interrupts();
+
+  return capture;
+}
+/*---------------------------------------------------------------------------*/
+static radio_result_t
+rssi_capture_start(radio_rssi_capture_t *capture)
+{
+  if(capture->buf == NULL || capture->len == 0 || capture->batch == NULL ||
+     capture->interval_us == 0) {
+    return RADIO_RESULT_INVALID_VALUE;
+  }
+
+  if(rssi_capture != NULL || radio_is_powered() == false) {
+    return RADIO_RESULT_ERROR;
+  }
+
+  capture->active = 1;
+  rssi_capture = capture;
+  setup_interrupts();
+
+  nrf_timer_task_trigger(RSSI_CAPTURE_TIMER, NRF_TIMER_TASK_STOP);
+  nrf_timer_mode_set(RSSI_CAPTURE_TIMER, NRF_TIMER_MODE_TIMER);
+  nrf_timer_bit_width_set(RSSI_CAPTURE_TIMER, NRF_TIMER_BIT_WIDTH_16);
+  nrf_timer_frequency_set(RSSI_CAPTURE_TIMER, NRF_TIMER_FREQ_1MHz);
+  nrf_timer_cc_write(RSSI_CAPTURE_TIMER, NRF_TIMER_CC_CHANNEL0,
+                     capture->interval_us);
+  nrf_timer_shorts_enable(RSSI_CAPTURE_TIMER,
+                          NRF_TIMER_SHORT_COMPARE0_CLEAR_MASK);
+
+  nrf_ppi_channel_endpoint_setup(
+    RSSI_CAPTURE_PPI_CHANNEL,
+    (uint32_t)nrf_timer_event_address_get(RSSI_CAPTURE_TIMER,
+                                          NRF_TIMER_EVENT_COMPARE0),
+    (uint32_t)nrf_radio_task_address_get(NRF_RADIO_TASK_RSSISTART));
+
+  rssi_capture_resume();
+
+  return RADIO_RESULT_OK;
+}
+/*---------------------------------------------------------------------------*/
+/* Hand a full or final batch to its owner. Called from the driver process */
+static void
+rssi_capture_deliver(void)
+{
+  radio_rssi_capture_t *capture = rssi_capture;
+  int_master_status_t stat;
+  uint16_t count;
+  int more;
+
+  if(capture == NULL || !rssi_capture_full) {
+    return;
+  }
+
+  if(rssi_capture_ending) {
+    stat = critical_enter();
+    count = rssi_capture_cnt;
+    rssi_capture_halt();
+    critical_exit(stat);
+
+    capture->batch(capture->buf, count, capture->ptr);
+    capture->active = 0;
+    return;
+  }
+
+  more = capture->batch(capture->buf, capture->len, capture->ptr);
+
+  /*
+   * The request may have been dropped or ended from within batch(). All of
+   * its samples have just been handed over, so there is nothing left for a
+   * final batch.
+   */
+  stat = critical_enter();
+  if(rssi_capture == capture) {
+    if(more && !rssi_capture_ending) {
+      rssi_capture_resume();
+    } else {
+      rssi_capture_halt();
+      capture->active = 0;
+    }
+  }
+  critical_exit(stat);
+}
+/*---------------------------------------------------------------------------*/
+/*
+ * End a capture because the radio turns off or changes channel. This may run
+ * from interrupt context, so the samples collected so far are left in place
+ * and handed over by the driver process.
+ */
+static void
+rssi_capture_end(void)
+{
+  int_master_status_t stat;
+
+  stat = critical_enter();
+  if(rssi_capture != NULL && !rssi_capture_ending) {
+    rssi_capture_pause();
+    rssi_capture_ending = true;
+    rssi_capture_full = true;
+    setup_interrupts();
+    process_poll(&nrf52840_ieee_rf_process);
+  }
+  critical_exit(stat);
+}
+/*---------------------------------------------------------------------------*/
+/*
+ * Stop a capture on request of its owner: hand over the samples collected
+ * so far and release the request.
+ */
+static void
+rssi_capture_stop(void)
+{
+  int_master_status_t stat;
+  radio_rssi_capture_t *capture;
+  uint16_t count;
+
+  stat = critical_enter();
+  count = rssi_capture_cnt;
+  capture = rssi_capture_halt();
+  critical_exit(stat);
+
+  if(capture != NULL) {
+    capture->batch(capture->buf, count, capture->ptr);
+    capture->active = 0;
+  }
+}
+/*---------------------------------------------------------------------------*/
 /* Retrieve an RSSI sample. The radio must be in RX mode */
 static int8_t
 rssi_read(void)
 {
   uint8_t rssi_sample;
 
+  /* The capture interrupt consumes RSSIEND, return its latest sample */
+  if(rssi_capture != NULL && !rssi_capture_ending) {
+    return rssi_capture_last;
+  }
+
   nrf_radio_task_trigger(NRF_RADIO_TASK_RSSISTART);
 
   while(nrf_radio_event_check(NRF_RADIO_EVENT_RSSIEND) == false);
@@ -758,6 +943,8 @@ pending_packet(void)
 static int
 off(void)
 {
+  rssi_capture_end();
+
   nrf_radio_power_set(false);
 
   ENERGEST_OFF(ENERGEST_TYPE_LISTEN);
@@ -939,6 +1126,17 @@ get_object(radio_param_t param, void *dest, size_t size)
 static radio_result_t
 set_object(radio_param_t param, const void *src, size_t size)
 {
+  if(param == RADIO_PARAM_RSSI_CAPTURE) {
+    if(src == NULL) {
+      rssi_capture_stop();
+      return RADIO_RESULT_OK;
+    }
+    if(size != sizeof(radio_rssi_capture_t)) {
+      return RADIO_RESULT_INVALID_VALUE;
+    }
+    return rssi_capture_start((radio_rssi_capture_t *)src);
+  }
+
   /* The radio does not support h/w frame filtering based on addresses */
   return RADIO_RESULT_NOT_SUPPORTED;
 }
@@ -970,6 +1168,8 @@ PROCESS_THREAD(nrf52840_ieee_rf_process, ev, data)
 
     LOG_DBG("Polled\n");
 
+    rssi_capture_deliver();
+
     if(pending_packet()) {
       watchdog_periodic();
       packetbuf_clear();
@@ -996,6 +1196,22 @@ __attribute__((weak)) void
 // void
 RADIO_IRQHandler(void)
 {
+  radio_rssi_capture_t *capture = rssi_capture;
+
+  if(capture != NULL && nrf_radio_event_check(NRF_RADIO_EVENT_RSSIEND)) {
+    nrf_radio_event_clear(NRF_RADIO_EVENT_RSSIEND);
+    /* A sample already in flight may end after the batch has filled */
+    if(!rssi_capture_full && rssi_capture_cnt < capture->len) {
+      rssi_capture_last = -((int8_t)nrf_radio_rssi_sample_get());
+      capture->buf[rssi_capture_cnt++] = rssi_capture_last;
+      if(rssi_capture_cnt == capture->len) {
+        rssi_capture_pause();
+        rssi_capture_full = true;
+        process_poll(&nrf52840_ieee_rf_process);
+      }
+    }
+  }
+
   if(!rf_config.poll_mode) {
     if(nrf_radio_event_check(NRF_RADIO_EVENT_CRCOK)) {
       nrf_radio_event_clear(NRF_RADIO_EVENT_CRCOK);
@@ -87,6 +87,16 @@ clock_seconds(void)
   return ts.tv_sec;
 }
 /*---------------------------------------------------------------------------*/
+uint32_t
+clock_usecs(void)
+{
+  clock_timespec_t ts;
+
+  get_time(&ts);
+
+  return ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+/*---------------------------------------------------------------------------*/
 void
 clock_delay(unsigned int d)
 {
@@ -102,6 +102,14 @@ typedef unsigned long clock_time_t;
 
 #define CLOCK_CONF_SECOND 1000
 
+/* Profile with microsecond timestamps rather than rtimer ticks */
+uint32_t clock_usecs(void);
+#ifndef PROFILE_CONF_NOW
+#define PROFILE_CONF_NOW()   clock_usecs()
+#define PROFILE_CONF_SECOND  1000000
+#define PROFILE_CONF_TIME_T  uint32_t
+#endif /* PROFILE_CONF_NOW */
+
 #define LOG_CONF_ENABLED 1
 
 #define PLATFORM_SUPPORTS_BUTTON_HAL 1
@@ -54,6 +54,7 @@
 
 #include "contiki.h"
 #include "net/netstack.h"
+#include "sys/energest.h"
 
 #include "dev/serial-line.h"
 #include "dev/button-hal.h"
@@ -314,7 +315,9 @@ platform_main_loop()
       }
     }
 
+    ENERGEST_SWITCH(ENERGEST_TYPE_CPU, ENERGEST_TYPE_LPM);
     retval = select(maxfd + 1, &fdr, &fdw, NULL, &tv);
+    ENERGEST_SWITCH(ENERGEST_TYPE_LPM, ENERGEST_TYPE_CPU);
     if(retval < 0) {
       if(errno != EINTR) {
         perror("select");
@@ -48,6 +48,7 @@
 #include "constant_jammer.h"
 #include "random_jammer.h"
 #include "sfd_jammer.h"
+#include "jam_report.h"
 //#include "sfd_debugger.h"
 //#include "jammer_node.h"
 
@@ -103,6 +104,7 @@ PROCESS_THREAD(hello_world_process, ev, data)
   if (node_id == 11896 || node_id == 13282 || node_id == 59953)
   {
     NETSTACK_ROUTING.root_start();
+    jam_report_init();
   }
   else if (node_id == 00000)
   {
@@ -126,6 +128,8 @@ PROCESS_THREAD(hello_world_process, ev, data)
   // }
   else
   {
+    jam_report_init();
+
     /* initialize the packet generation timer */
     etimer_set(&periodic_timer, APP_WARM_UP_PERIOD_SEC * CLOCK_SECOND
         + random_rand() % (APP_SEND_INTERVAL_SEC * CLOCK_SECOND));
@@ -0,0 +1,111 @@
+/**
+ * \file
+ *          Reports jamsense verdicts to the TSCH coordinator, which moves
+ *          the hopping sequence away from jammed channels. The new sequence
+ *          reaches the other nodes in EBs.
+ */
+
+#include "contiki.h"
+
+#include <stdio.h>
+#include <string.h>
+#include "net/ipv6/simple-udp.h"
+#include "net/routing/routing.h"
+#include "net/mac/tsch/tsch.h"
+#include "services/tsch-cs/tsch-cs.h"
+#include "jam_report.h"
+
+#include "sys/log.h"
+#define LOG_MODULE "Jam report"
+#define LOG_LEVEL LOG_LEVEL_INFO
+
+#define JAM_REPORT_PORT 8766
+#define JAM_REPORT_FIRST_CHANNEL 11
+#define JAM_REPORT_NUM_CHANNELS 16
+
+/* Message sent to the root, one per verdict */
+struct jam_report_msg {
+  uint8_t channel;
+  uint8_t type;
+  uint16_t age_sec;
+};
+/*---------------------------------------------------------------------------*/
+PROCESS(jam_report_process, "jam report process");
+/*---------------------------------------------------------------------------*/
+static struct simple_udp_connection report_conn;
+/* Verdicts not sent yet, by channel */
+static uint8_t pending_type[JAM_REPORT_NUM_CHANNELS];
+static unsigned long pending_time[JAM_REPORT_NUM_CHANNELS];
+/*---------------------------------------------------------------------------*/
+void jam_report_jammer_detected(int channel, int type)
+{
+  channel -= JAM_REPORT_FIRST_CHANNEL;
+  if(channel < 0 || channel >= JAM_REPORT_NUM_CHANNELS) {
+    return;
+  }
+  pending_type[channel] = type;
+  pending_time[channel] = clock_seconds();
+  process_poll(&jam_report_process);
+}
+/*---------------------------------------------------------------------------*/
+static void
+report_rx_callback(struct simple_udp_connection *c,
+         const uip_ipaddr_t *sender_addr,
+         uint16_t sender_port,
+         const uip_ipaddr_t *receiver_addr,
+         uint16_t receiver_port,
+         const uint8_t *data,
+         uint16_t datalen)
+{
+  struct jam_report_msg msg;
+
+  if(datalen != sizeof(msg)) {
+    return;
+  }
+  memcpy(&msg, data, sizeof(msg));
+  LOG_INFO("CH%u: jammer type %u reported by ", msg.channel, msg.type);
+  LOG_INFO_6ADDR(sender_addr);
+  LOG_INFO_("\n");
+  tsch_cs_channel_jammed(msg.channel, msg.type, msg.age_sec);
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(jam_report_process, ev, data)
+{
+  static int i;
+  struct jam_report_msg msg;
+  uip_ipaddr_t root;
+
+  PROCESS_BEGIN();
+
+  simple_udp_register(&report_conn, JAM_REPORT_PORT, NULL,
+                      JAM_REPORT_PORT, report_rx_callback);
+
+  while(1) {
+    PROCESS_YIELD_UNTIL(ev == PROCESS_EVENT_POLL);
+
+    if(!NETSTACK_ROUTING.node_is_reachable()
+       || !NETSTACK_ROUTING.get_root_ipaddr(&root)) {
+      /* verdicts older than the blacklist period are dropped by the root */
+      continue;
+    }
+
+    for(i = 0; i < JAM_REPORT_NUM_CHANNELS; i++) {
+      if(pending_type[i] == 0) {
+        continue;
+      }
+      msg.channel = i + JAM_REPORT_FIRST_CHANNEL;
+      msg.type = pending_type[i];
+      msg.age_sec = clock_seconds() - pending_time[i];
+      pending_type[i] = 0;
+      simple_udp_sendto(&report_conn, &msg, sizeof(msg), &root);
+    }
+  }
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
+void jam_report_init(void)
+{
+  process_start(&jam_report_process, NULL);
+}
+/*---------------------------------------------------------------------------*/
@@ -0,0 +1,19 @@
+#ifndef JAM_REPORT_H
+#define JAM_REPORT_H
+
+#include <stdint.h>
+
+/**
+ * \brief Start sending jamsense verdicts to the root, and applying the
+ *        verdicts received at the root to the TSCH hopping sequence
+ */
+void jam_report_init(void);
+
+/**
+ * \brief SPECKSENSE_CALLBACK_JAMMER_DETECTED, queues a report for the root
+ * \param channel     jammed channel
+ * \param type        1 for proactive jammer, 2 for reactive jammer
+ */
+void jam_report_jammer_detected(int channel, int type);
+
+#endif
@@ -14,6 +14,22 @@ extern bool jammer_node(void);
 #define SELECT_MAC_FUNCTION jammer_node
 //#define TSCH_CONF_DEFAULT_HOPPING_SEQUENCE	   TSCH_HOPPING_SEQUENCE_16_16
 
+/* Jammer-aware channel selection: nodes report jamsense verdicts to the
+ * root, which replaces jammed channels in the hopping sequence */
+extern void jam_report_jammer_detected(int channel, int type);
+#define SPECKSENSE_CALLBACK_JAMMER_DETECTED jam_report_jammer_detected
+
+/* TSCH statistics feed the channel selection, see tsch-cs */
+#define TSCH_STATS_CONF_ON 1
+#define TSCH_STATS_CONF_SAMPLE_NOISE_RSSI 1
+extern bool tsch_cs_process(void);
+#define TSCH_CALLBACK_SELECT_CHANNELS tsch_cs_process
+
+/* The coordinator updates the network nodes with new hopping sequences */
+#define TSCH_PACKET_CONF_EB_WITH_HOPPING_SEQUENCE 1
+#define TSCH_CONF_EB_PERIOD     (4 * CLOCK_SECOND)
+#define TSCH_CONF_MAX_EB_PERIOD (4 * CLOCK_SECOND)
+
 /* Enable printing of packet counters */
 #define LINK_STATS_CONF_PACKET_COUNTERS          1
 
@@ -0,0 +1,327 @@
+/*
+ * Copyright (c) 2026, Contiki-NG contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *         Replays recorded RSSI traces through the specksense RLE sampler
+ *         and classifier on the native target, and reports detection
+ *         latency, CPU time, peak RAM and accuracy per trace. Peak RAM
+ *         is the static sampler and classifier buffers plus the deepest
+ *         stack reached, found by painting the stack before each replay.
+ *
+ *         Usage:
+ *           jamsense-replay.native <trace> [<trace> ...]
+ *           jamsense-replay.native -g <none|constant|reactive> <file.csv>
+ *
+ *         A CSV trace holds RSSI samples in dBm, separated by commas or
+ *         white space. Lines starting with '#' are comments, except
+ *         "# expect=<none|proactive|reactive>" which sets the label used
+ *         for accuracy. A binary trace starts with the magic "JSRT", a
+ *         version byte (1), the expected verdict (0 none, 1 proactive,
+ *         2 reactive) and two reserved bytes, followed by int8 samples.
+ */
+
+#include "contiki.h"
+#include "lib/random.h"
+#include "services/jamsense/specksense.h"
+#include "replay-radio.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+/*---------------------------------------------------------------------------*/
+#define REPLAY_MAX_SAMPLES (1UL << 20)
+#define REPLAY_CHANNEL     26
+#define GENERATE_SAMPLES   300000
+#define EXPECT_UNKNOWN     -1
+
+/* Stack below the replay loop painted to find the peak usage, as in stack-check */
+#define STACK_PAINT_SIZE   (64 * 1024)
+#define STACK_FILL         0xcd
+/*---------------------------------------------------------------------------*/
+extern int contiki_argc;
+extern char **contiki_argv;
+
+static int8_t samples[REPLAY_MAX_SAMPLES];
+static const char *verdict_names[] = { "none", "proactive", "reactive" };
+static uintptr_t stack_paint_low;
+/*---------------------------------------------------------------------------*/
+PROCESS(jamsense_replay_process, "JamSense replay process");
+AUTOSTART_PROCESSES(&jamsense_replay_process);
+/*---------------------------------------------------------------------------*/
+static int
+verdict_from_name(const char *name)
+{
+  int i;
+
+  for(i = 0; i < 3; i++) {
+    if(strncmp(name, verdict_names[i], strlen(verdict_names[i])) == 0) {
+      return i;
+    }
+  }
+  return EXPECT_UNKNOWN;
+}
+/*---------------------------------------------------------------------------*/
+static uint64_t
+cpu_time_ns(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+/*---------------------------------------------------------------------------*/
+static uint64_t
+cpu_cycles(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+  return __builtin_ia32_rdtsc();
+#else
+  return 0;
+#endif
+}
+/*---------------------------------------------------------------------------*/
+/* Fills the stack below the caller's frame with a known pattern */
+static void __attribute__((noinline))
+stack_paint(void)
+{
+  volatile uint8_t area[STACK_PAINT_SIZE];
+  size_t i;
+
+  for(i = 0; i < sizeof(area); i++) {
+    area[i] = STACK_FILL;
+  }
+  stack_paint_low = (uintptr_t)area;
+}
+/*---------------------------------------------------------------------------*/
+/* Returns how far below top the stack was written since stack_paint() */
+static size_t __attribute__((noinline))
+stack_peak(const volatile uint8_t *top)
+{
+  const volatile uint8_t *low = (const volatile uint8_t *)stack_paint_low;
+  const volatile uint8_t *p = low;
+
+  while(p < top && *p == STACK_FILL) {
+    p++;
+  }
+  if(p == low) {
+    printf("stack paint area overrun, peak is a lower bound\n");
+  }
+  return top - p;
+}
+/*---------------------------------------------------------------------------*/
+/* Loads a trace, returns the number of samples or -1 on error */
+static long
+load_trace(const char *path, int *expect)
+{
+  FILE *fp;
+  long count = 0;
+  unsigned char header[8];
+  char line[256];
+
+  *expect = EXPECT_UNKNOWN;
+  fp = fopen(path, "rb");
+  if(fp == NULL) {
+    return -1;
+  }
+
+  if(fread(header, 1, sizeof(header), fp) == sizeof(header)
+     && memcmp(header, "JSRT", 4) == 0) {
+    if(header[4] != 1) {
+      fclose(fp);
+      return -1;
+    }
+    *expect = header[5] <= 2 ? header[5] : EXPECT_UNKNOWN;
+    count = fread(samples, 1, sizeof(samples), fp);
+    fclose(fp);
+    return count;
+  }
+
+  rewind(fp);
+  while(fgets(line, sizeof(line), fp) != NULL && count < REPLAY_MAX_SAMPLES) {
+    char *p = line;
+    char *end;
+    long val;
+
+    if(line[0] == '#') {
+      p = strstr(line, "expect=");
+      if(p != NULL) {
+        *expect = verdict_from_name(p + strlen("expect="));
+      }
+      continue;
+    }
+    for(;;) {
+      while(*p == ',' || *p == ' ' || *p == '\t') {
+        p++;
+      }
+      val = strtol(p, &end, 10);
+      if(end == p) {
+        break;
+      }
+      samples[count++] = val < INT8_MIN ? INT8_MIN : (val > INT8_MAX ? INT8_MAX : val);
+      p = end;
+      if(count >= REPLAY_MAX_SAMPLES) {
+        break;
+      }
+    }
+  }
+  fclose(fp);
+  return count;
+}
+/*---------------------------------------------------------------------------*/
+/* Writes a synthetic trace: noise floor around -95 dBm plus the jammer */
+static int
+generate_trace(const char *type, const char *path)
+{
+  FILE *fp;
+  int expect = verdict_from_name(type);
+  int constant = strcmp(type, "constant") == 0;
+  long i;
+  int burst = 0;
+
+  if(expect == EXPECT_UNKNOWN && !constant) {
+    return -1;
+  }
+  fp = fopen(path, "w");
+  if(fp == NULL) {
+    return -1;
+  }
+
+  fprintf(fp, "# synthetic %s trace\n", type);
+  fprintf(fp, "# expect=%s\n", constant ? "proactive" : type);
+  for(i = 0; i < GENERATE_SAMPLES; i++) {
+    int rssi = -95 + (int)(random_rand() % 5) - 2;
+
+    if(constant) {
+      /* Continuous carrier with small fluctuations */
+      rssi = -45 + (int)(random_rand() % 3) - 1;
+    } else if(expect == 2) {
+      /* Short bursts triggered by the (simulated) SFD of other frames */
+      if(burst == 0 && random_rand() % 200 == 0) {
+        burst = 20;
+      }
+      if(burst > 0) {
+        rssi = -50;
+        burst--;
+      }
+    }
+    fprintf(fp, "%d\n", rssi);
+  }
+  fclose(fp);
+  return 0;
+}
+/*---------------------------------------------------------------------------*/
+/* Replays one trace, returns the verdict */
+static int
+replay_trace(const char *path, int expect)
+{
+  volatile uint8_t stack_top = 0;
+  uint64_t ns_start, cyc_start, ns, cycles;
+  size_t latency = 0;
+  size_t stack;
+  int verdict = 0;
+
+  specksense_reset();
+  stack_paint();
+  ns_start = cpu_time_ns();
+  cyc_start = cpu_cycles();
+  while(replay_radio_remaining() > 0) {
+    specksense_process();
+    verdict = specksense_jammer_type(REPLAY_CHANNEL);
+    if(verdict != 0) {
+      latency = replay_radio_consumed();
+      break;
+    }
+  }
+  ns = cpu_time_ns() - ns_start;
+  cycles = cpu_cycles() - cyc_start;
+  stack = stack_peak(&stack_top);
+
+  printf("%s: verdict %s expected %s latency %lu samples"
+         " cpu %lu us %lu cycles static %lu bytes stack %lu bytes"
+         " peak RAM %lu bytes\n",
+         path, verdict_names[verdict],
+         expect == EXPECT_UNKNOWN ? "?" : verdict_names[expect],
+         (unsigned long)latency, (unsigned long)(ns / 1000),
+         (unsigned long)cycles, (unsigned long)specksense_state_size(),
+         (unsigned long)stack,
+         (unsigned long)(specksense_state_size() + stack));
+  return verdict;
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(jamsense_replay_process, ev, data)
+{
+  int i, first = 1, expect, labelled = 0, correct = 0;
+  long count;
+
+  PROCESS_BEGIN();
+
+  if(contiki_argc == 4 && strcmp(contiki_argv[1], "-g") == 0) {
+    if(generate_trace(contiki_argv[2], contiki_argv[3]) < 0) {
+      printf("cannot generate %s trace %s\n", contiki_argv[2], contiki_argv[3]);
+      exit(1);
+    }
+    exit(0);
+  }
+
+  if(contiki_argc > 1 && strcmp(contiki_argv[1], "-c") == 0) {
+    replay_radio_set_capture(true);
+    first++;
+  }
+
+  if(contiki_argc <= first) {
+    printf("usage: %s [-c] <trace> [<trace> ...]\n"
+           "       %s -g <none|constant|reactive> <file.csv>\n",
+           contiki_argv[0], contiki_argv[0]);
+    exit(1);
+  }
+
+  for(i = first; i < contiki_argc; i++) {
+    count = load_trace(contiki_argv[i], &expect);
+    if(count < 0) {
+      printf("%s: cannot read trace\n", contiki_argv[i]);
+      continue;
+    }
+    replay_radio_load(samples, count);
+    if(replay_trace(contiki_argv[i], expect) == expect) {
+      correct++;
+    }
+    if(expect != EXPECT_UNKNOWN) {
+      labelled++;
+    }
+  }
+
+  printf("Accuracy: %d/%d\n", correct, labelled);
+  exit(correct == labelled ? 0 : 1);
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
@@ -0,0 +1,238 @@
+/*
+ * Copyright (c) 2026, Contiki-NG contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *         Radio driver that plays back a recorded RSSI trace
+ */
+
+#include "contiki.h"
+#include "replay-radio.h"
+
+/* specksense subtracts this from every RSSI reading, see rssi_sampler() */
+#define RSSI_COMPENSATION_OFFSET 45
+
+static const int8_t *trace;
+static size_t trace_len;
+static size_t trace_pos;
+static radio_value_t channel = 26;
+static bool capture_enabled;
+/*---------------------------------------------------------------------------*/
+void
+replay_radio_load(const int8_t *samples, size_t count)
+{
+  trace = samples;
+  trace_len = count;
+  trace_pos = 0;
+}
+/*---------------------------------------------------------------------------*/
+size_t
+replay_radio_consumed(void)
+{
+  return trace_pos;
+}
+/*---------------------------------------------------------------------------*/
+size_t
+replay_radio_remaining(void)
+{
+  return trace_len - trace_pos;
+}
+/*---------------------------------------------------------------------------*/
+void
+replay_radio_set_capture(bool enable)
+{
+  capture_enabled = enable;
+}
+/*---------------------------------------------------------------------------*/
+/*
+ * There are no interrupts on the host, so the whole capture runs before
+ * set_object() returns: batches are handed over until the callback asks
+ * to stop or the trace runs out.
+ */
+static radio_result_t
+rssi_capture(radio_rssi_capture_t *capture)
+{
+  uint16_t cnt = 0;
+  int more = 1;
+
+  if(capture->buf == NULL || capture->len == 0 || capture->batch == NULL) {
+    return RADIO_RESULT_INVALID_VALUE;
+  }
+
+  capture->active = 1;
+  while(more && trace_pos < trace_len) {
+    capture->buf[cnt++] = trace[trace_pos++] + RSSI_COMPENSATION_OFFSET;
+    if(cnt == capture->len) {
+      more = capture->batch(capture->buf, cnt, capture->ptr);
+      cnt = 0;
+    }
+  }
+  if(more) {
+    capture->batch(capture->buf, cnt, capture->ptr);
+  }
+  capture->active = 0;
+
+  return RADIO_RESULT_OK;
+}
+/*---------------------------------------------------------------------------*/
+static int
+init(void)
+{
+  return 0;
+}
+/*---------------------------------------------------------------------------*/
+static int
+prepare(const void *payload, unsigned short payload_len)
+{
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+static int
+transmit(unsigned short transmit_len)
+{
+  return RADIO_TX_OK;
+}
+/*---------------------------------------------------------------------------*/
+static int
+send(const void *payload, unsigned short payload_len)
+{
+  prepare(payload, payload_len);
+  return transmit(payload_len);
+}
+/*---------------------------------------------------------------------------*/
+static int
+radio_read(void *buf, unsigned short buf_len)
+{
+  return 0;
+}
+/*---------------------------------------------------------------------------*/
+static int
+channel_clear(void)
+{
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+static int
+receiving_packet(void)
+{
+  return 0;
+}
+/*---------------------------------------------------------------------------*/
+static int
+pending_packet(void)
+{
+  return 0;
+}
+/*---------------------------------------------------------------------------*/
+static int
+on(void)
+{
+  return 0;
+}
+/*---------------------------------------------------------------------------*/
+static int
+off(void)
+{
+  return 0;
+}
+/*---------------------------------------------------------------------------*/
+static radio_result_t
+get_value(radio_param_t param, radio_value_t *value)
+{
+  if(!value) {
+    return RADIO_RESULT_INVALID_VALUE;
+  }
+
+  switch(param) {
+  case RADIO_PARAM_CHANNEL:
+    *value = channel;
+    return RADIO_RESULT_OK;
+  case RADIO_PARAM_RSSI:
+    if(trace_pos >= trace_len) {
+      return RADIO_RESULT_ERROR;
+    }
+    *value = trace[trace_pos++] + RSSI_COMPENSATION_OFFSET;
+    return RADIO_RESULT_OK;
+  default:
+    return RADIO_RESULT_NOT_SUPPORTED;
+  }
+}
+/*---------------------------------------------------------------------------*/
+static radio_result_t
+set_value(radio_param_t param, radio_value_t value)
+{
+  switch(param) {
+  case RADIO_PARAM_CHANNEL:
+    channel = value;
+    return RADIO_RESULT_OK;
+  default:
+    return RADIO_RESULT_NOT_SUPPORTED;
+  }
+}
+/*---------------------------------------------------------------------------*/
+static radio_result_t
+get_object(radio_param_t param, void *dest, size_t size)
+{
+  return RADIO_RESULT_NOT_SUPPORTED;
+}
+/*---------------------------------------------------------------------------*/
+static radio_result_t
+set_object(radio_param_t param, const void *src, size_t size)
+{
+  if(param == RADIO_PARAM_RSSI_CAPTURE && capture_enabled) {
+    if(src == NULL) {
+      return RADIO_RESULT_OK;
+    }
+    if(size != sizeof(radio_rssi_capture_t)) {
+      return RADIO_RESULT_INVALID_VALUE;
+    }
+    return rssi_capture((radio_rssi_capture_t *)src);
+  }
+  return RADIO_RESULT_NOT_SUPPORTED;
+}
+/*---------------------------------------------------------------------------*/
+const struct radio_driver replay_radio_driver =
+  {
+    init,
+    prepare,
+    transmit,
+    send,
+    radio_read,
+    channel_clear,
+    receiving_packet,
+    pending_packet,
+    on,
+    off,
+    get_value,
+    set_value,
+    get_object,
+    set_object
+  };
+/*---------------------------------------------------------------------------*/
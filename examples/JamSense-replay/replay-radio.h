@@ -0,0 +1,76 @@
+/*
+ * Copyright (c) 2026, Contiki-NG contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *         Radio driver that plays back a recorded RSSI trace
+ */
+
+#ifndef REPLAY_RADIO_H_
+#define REPLAY_RADIO_H_
+
+#include "contiki.h"
+#include "dev/radio.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+extern const struct radio_driver replay_radio_driver;
+
+/**
+ * \brief Start playing back a trace
+ * \param samples     RSSI samples in dBm
+ * \param count       number of samples
+ *
+ * Each RADIO_PARAM_RSSI read returns the next sample until the trace is
+ * exhausted, after which reads fail with RADIO_RESULT_ERROR.
+ */
+void replay_radio_load(const int8_t *samples, size_t count);
+
+/**
+ * \brief Number of samples read since the trace was loaded
+ */
+size_t replay_radio_consumed(void);
+
+/**
+ * \brief Number of samples left in the trace
+ */
+size_t replay_radio_remaining(void);
+
+/**
+ * \brief Enable or disable RADIO_PARAM_RSSI_CAPTURE
+ *
+ * When disabled, the driver reports the capture as not supported and
+ * specksense polls RADIO_PARAM_RSSI instead.
+ */
+void replay_radio_set_capture(bool enable);
+
+#endif /* REPLAY_RADIO_H_ */
@@ -0,0 +1,483 @@
+/*
+ * Copyright (c) 2026, Contiki-NG contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *         Benchmarks 6LoWPAN reassembly on the native target. Fragmented
+ *         datagrams from several senders are fed to the 6LoWPAN layer
+ *         interleaved, shuffled and with duplicates, and every
+ *         reassembled datagram is compared to the one that was sent.
+ */
+
+#include "contiki.h"
+#include "net/netstack.h"
+#include "net/packetbuf.h"
+#include "net/ipv6/uip.h"
+#include "net/ipv6/uip-ds6.h"
+#include "net/ipv6/sicslowpan.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+/*---------------------------------------------------------------------------*/
+#define MAX_SENDERS      32
+#define MIN_DATAGRAM     100
+#define MAX_DATAGRAM     400
+#define NUM_ROUNDS       200
+
+/* Uncompressed IPv6 dispatch, then 40 + 56 bytes in the first fragment */
+#define FRAG1_HDR_LEN    5
+#define FRAGN_HDR_LEN    5
+#define FRAG1_PAYLOAD    96
+#define FRAGN_PAYLOAD    96
+#define MAX_FRAGS        (1 + (MAX_DATAGRAM - FRAG1_PAYLOAD + FRAGN_PAYLOAD - 1) / FRAGN_PAYLOAD)
+/* Fragment buffers taken by a datagram of MAX_DATAGRAM bytes */
+#define MAX_BUFS         MAX_FRAGS
+
+/* A datagram of UIP_BUFSIZE bytes as a sender using IPHC would split
+   it, the first fragment growing from 3 to 40 bytes of IPv6 header */
+#define MTU_FRAG_PAYLOAD 104
+#define MTU_DATAGRAMS    5
+
+#ifdef SICSLOWPAN_CONF_FRAGMENT_BUFFERS
+#define FRAGMENT_BUFFERS SICSLOWPAN_CONF_FRAGMENT_BUFFERS
+#else
+/* The default of sicslowpan.c for 127-byte frames */
+#define FRAGMENT_BUFFERS ((UIP_BUFSIZE + 103) / 104 + 1)
+#endif
+
+#ifdef SICSLOWPAN_CONF_REASS_CONTEXTS
+#define REASS_CONTEXTS   SICSLOWPAN_CONF_REASS_CONTEXTS
+#else
+#define REASS_CONTEXTS   (FRAGMENT_BUFFERS / 2)
+#endif
+/*---------------------------------------------------------------------------*/
+struct frame {
+  uint8_t sender;
+  uint8_t len;
+  uint8_t data[127];
+};
+
+struct datagram {
+  uint16_t len;
+  uint16_t tag;
+  uint8_t delivered;
+  uint8_t data[UIP_BUFSIZE];
+};
+
+enum order {
+  ORDER_INTERLEAVED,
+  ORDER_SHUFFLED,
+  ORDER_DUPLICATES,
+};
+
+static const char *order_names[] = { "interleaved", "shuffled", "duplicates" };
+static const int sender_counts[] = { 1, 2, 4, 8, 16, MAX_SENDERS };
+
+static struct datagram datagrams[MAX_SENDERS];
+static struct frame frames[MAX_SENDERS * MAX_FRAGS];
+static uint16_t order[2 * MAX_SENDERS * MAX_FRAGS];
+static int num_frames;
+static int num_order;
+static uint32_t rand_state = 1;
+static int delivered;
+static int failures;
+/*---------------------------------------------------------------------------*/
+PROCESS(reassembly_process, "6LoWPAN reassembly benchmark");
+AUTOSTART_PROCESSES(&reassembly_process);
+/*---------------------------------------------------------------------------*/
+static uint32_t
+next_rand(void)
+{
+  rand_state = rand_state * 1103515245 + 12345;
+  return rand_state >> 8;
+}
+/*---------------------------------------------------------------------------*/
+static uint64_t
+cpu_time_ns(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+/*---------------------------------------------------------------------------*/
+static void
+sender_lladdr(linkaddr_t *addr, int sender)
+{
+  memset(addr, 0, sizeof(*addr));
+  addr->u8[LINKADDR_SIZE - 1] = sender + 1;
+}
+/*---------------------------------------------------------------------------*/
+/* Called with the reassembled datagram in uip_buf */
+static void
+input_callback(void)
+{
+  struct datagram *d;
+  int sender;
+
+  sender = UIP_IP_BUF->srcipaddr.u8[15] - 1;
+  if(sender < 0 || sender >= MAX_SENDERS) {
+    printf("Datagram from unknown sender %d\n", sender);
+    failures++;
+    return;
+  }
+
+  d = &datagrams[sender];
+  if(d->delivered || uip_len != d->len || memcmp(uip_buf, d->data, d->len)) {
+    printf("Datagram from sender %d (tag %u) is %s\n", sender, d->tag,
+           d->delivered ? "delivered twice" : "corrupted");
+    failures++;
+    return;
+  }
+  d->delivered = 1;
+  delivered++;
+}
+
+NETSTACK_SNIFFER(reassembly_sniffer, input_callback, NULL);
+/*---------------------------------------------------------------------------*/
+static void
+add_frame(int sender, const uint8_t *hdr, int hdr_len,
+          const uint8_t *payload, int len)
+{
+  struct frame *f = &frames[num_frames++];
+
+  f->sender = sender;
+  f->len = hdr_len + len;
+  memcpy(f->data, hdr, hdr_len);
+  memcpy(f->data + hdr_len, payload, len);
+}
+/*---------------------------------------------------------------------------*/
+/* A new datagram from sender, split in a FRAG1 and FRAGN frames */
+static void
+make_datagram(int sender)
+{
+  struct datagram *d = &datagrams[sender];
+  uint8_t hdr[FRAGN_HDR_LEN];
+  uint16_t off;
+  int len;
+  int i;
+
+  d->len = MIN_DATAGRAM + next_rand() % (MAX_DATAGRAM - MIN_DATAGRAM + 1);
+  d->tag++;
+  d->delivered = 0;
+
+  /* IPv6 header, no next header, fe80::sender -> fe80::1 */
+  memset(d->data, 0, UIP_IPH_LEN);
+  d->data[0] = 0x60;
+  d->data[4] = (d->len - UIP_IPH_LEN) >> 8;
+  d->data[5] = (d->len - UIP_IPH_LEN) & 0xff;
+  d->data[6] = UIP_PROTO_NONE;
+  d->data[7] = 64;
+  d->data[8] = 0xfe;
+  d->data[9] = 0x80;
+  d->data[23] = sender + 1;
+  d->data[24] = 0xfe;
+  d->data[25] = 0x80;
+  d->data[39] = 1;
+  for(i = UIP_IPH_LEN; i < d->len; i++) {
+    d->data[i] = next_rand();
+  }
+
+  hdr[0] = SICSLOWPAN_DISPATCH_FRAG1 | (d->len >> 8);
+  hdr[1] = d->len & 0xff;
+  hdr[2] = d->tag >> 8;
+  hdr[3] = d->tag & 0xff;
+  hdr[4] = SICSLOWPAN_DISPATCH_IPV6;
+  add_frame(sender, hdr, FRAG1_HDR_LEN, d->data, FRAG1_PAYLOAD);
+
+  hdr[0] = SICSLOWPAN_DISPATCH_FRAGN | (d->len >> 8);
+  for(off = FRAG1_PAYLOAD; off < d->len; off += len) {
+    len = MIN(d->len - off, FRAGN_PAYLOAD);
+    hdr[4] = off >> 3;
+    add_frame(sender, hdr, FRAGN_HDR_LEN, d->data + off, len);
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+shuffle(void)
+{
+  uint16_t tmp;
+  int i;
+  int j;
+
+  for(i = num_order - 1; i > 0; i--) {
+    j = next_rand() % (i + 1);
+    tmp = order[i];
+    order[i] = order[j];
+    order[j] = tmp;
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* Duplicate one frame in eight. A copy arrives after the original but
+   before the datagram is complete, later ones would start a new
+   reassembly that never completes. */
+static void
+add_duplicates(void)
+{
+  int last[MAX_SENDERS];
+  int n = num_order;
+  int p;
+  int q;
+  int i;
+
+  for(p = n - 1; p >= 0; p--) {
+    for(i = 0; i < MAX_SENDERS; i++) {
+      last[i] = -1;
+    }
+    for(i = 0; i < num_order; i++) {
+      last[frames[order[i]].sender] = i;
+    }
+    q = last[frames[order[p]].sender];
+    if(p < q && next_rand() % 8 == 0) {
+      q = p + 1 + next_rand() % (q - p);
+      memmove(&order[q + 1], &order[q], (num_order - q) * sizeof(order[0]));
+      order[q] = order[p];
+      num_order++;
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+make_round(int senders, enum order mode)
+{
+  int per_sender[MAX_SENDERS];
+  int first[MAX_SENDERS];
+  int left;
+  int s;
+  int i;
+
+  num_frames = 0;
+  for(s = 0; s < senders; s++) {
+    first[s] = num_frames;
+    make_datagram(s);
+    per_sender[s] = num_frames - first[s];
+  }
+
+  /* Round robin over the senders, each in order */
+  num_order = 0;
+  for(i = 0, left = num_frames; left > 0; i++) {
+    for(s = 0; s < senders; s++) {
+      if(i < per_sender[s]) {
+        order[num_order++] = first[s] + i;
+        left--;
+      }
+    }
+  }
+
+  if(mode != ORDER_INTERLEAVED) {
+    shuffle();
+  }
+  if(mode == ORDER_DUPLICATES) {
+    add_duplicates();
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+feed_round(void)
+{
+  linkaddr_t sender;
+  struct frame *f;
+  int i;
+
+  for(i = 0; i < num_order; i++) {
+    f = &frames[order[i]];
+    packetbuf_clear();
+    memcpy(packetbuf_dataptr(), f->data, f->len);
+    packetbuf_set_datalen(f->len);
+    sender_lladdr(&sender, f->sender);
+    packetbuf_set_addr(PACKETBUF_ADDR_SENDER, &sender);
+    packetbuf_set_addr(PACKETBUF_ADDR_RECEIVER, &linkaddr_node_addr);
+    sicslowpan_driver.input();
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* A sender that gives up on a datagram and reuses its tag for one of
+   another size must get the new datagram through */
+static void
+check_tag_reuse(void)
+{
+  struct datagram *d = &datagrams[0];
+  uint16_t len;
+
+  /* Only the first fragment of the abandoned datagram is sent */
+  make_round(1, ORDER_INTERLEAVED);
+  num_order = 1;
+  feed_round();
+  len = d->len;
+
+  do {
+    d->tag--;
+    make_round(1, ORDER_INTERLEAVED);
+  } while(d->len == len);
+  delivered = 0;
+  feed_round();
+
+  printf("Tag reused with another size: %d/1 delivered\n", delivered);
+  if(delivered != 1) {
+    failures++;
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* Datagrams of UIP_BUFSIZE bytes, one at a time, must fit any pool */
+static void
+check_mtu_datagrams(void)
+{
+  struct datagram *d = &datagrams[0];
+  linkaddr_t sender;
+  uip_ipaddr_t addr;
+  uint8_t hdr[FRAGN_HDR_LEN];
+  uint8_t frag1[3 + MTU_FRAG_PAYLOAD];
+  uint16_t off;
+  int len;
+  int i;
+  int n;
+
+  delivered = 0;
+  for(n = 0; n < MTU_DATAGRAMS; n++) {
+    d->len = UIP_BUFSIZE;
+    d->tag++;
+    d->delivered = 0;
+
+    /* IPv6 header that IPHC elides but for the next header */
+    memset(d->data, 0, UIP_IPH_LEN);
+    d->data[0] = 0x60;
+    d->data[4] = (d->len - UIP_IPH_LEN) >> 8;
+    d->data[5] = (d->len - UIP_IPH_LEN) & 0xff;
+    d->data[6] = UIP_PROTO_NONE;
+    d->data[7] = 64;
+    sender_lladdr(&sender, 0);
+    uip_ip6addr(&addr, 0xfe80, 0, 0, 0, 0, 0, 0, 0);
+    uip_ds6_set_addr_iid(&addr, (uip_lladdr_t *)&sender);
+    memcpy(&d->data[8], &addr, sizeof(addr));
+    uip_ds6_set_addr_iid(&addr, (uip_lladdr_t *)&linkaddr_node_addr);
+    memcpy(&d->data[24], &addr, sizeof(addr));
+    for(i = UIP_IPH_LEN; i < d->len; i++) {
+      d->data[i] = next_rand();
+    }
+
+    /* FRAG1 with TF, HLIM and both addresses elided */
+    frag1[0] = SICSLOWPAN_DISPATCH_IPHC | SICSLOWPAN_IPHC_FL_C |
+      SICSLOWPAN_IPHC_TC_C | SICSLOWPAN_IPHC_TTL_64;
+    frag1[1] = SICSLOWPAN_IPHC_SAM_11 | SICSLOWPAN_IPHC_DAM_11;
+    frag1[2] = UIP_PROTO_NONE;
+    memcpy(&frag1[3], d->data + UIP_IPH_LEN, MTU_FRAG_PAYLOAD);
+    num_frames = 0;
+    hdr[0] = SICSLOWPAN_DISPATCH_FRAG1 | (d->len >> 8);
+    hdr[1] = d->len & 0xff;
+    hdr[2] = d->tag >> 8;
+    hdr[3] = d->tag & 0xff;
+    add_frame(0, hdr, SICSLOWPAN_FRAG1_HDR_LEN, frag1, sizeof(frag1));
+
+    hdr[0] = SICSLOWPAN_DISPATCH_FRAGN | (d->len >> 8);
+    for(off = UIP_IPH_LEN + MTU_FRAG_PAYLOAD; off < d->len; off += len) {
+      len = MIN(d->len - off, MTU_FRAG_PAYLOAD);
+      hdr[4] = off >> 3;
+      add_frame(0, hdr, FRAGN_HDR_LEN, d->data + off, len);
+    }
+
+    for(num_order = 0; num_order < num_frames; num_order++) {
+      order[num_order] = num_order;
+    }
+    feed_round();
+  }
+
+  printf("%d-byte datagrams: %d/%d delivered\n",
+         UIP_BUFSIZE, delivered, MTU_DATAGRAMS);
+  if(delivered != MTU_DATAGRAMS) {
+    failures++;
+  }
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(reassembly_process, ev, data)
+{
+  static struct etimer et;
+  static uint64_t elapsed;
+  static int fed;
+  static int mode;
+  static int total;
+  static int s;
+  uint64_t start;
+  int r;
+
+  PROCESS_BEGIN();
+
+  printf("Fragment buffers: %d, reassembly contexts: %d\n",
+         FRAGMENT_BUFFERS, REASS_CONTEXTS);
+
+  /* The native network stack is tun6, set up 6LoWPAN here */
+  sicslowpan_driver.init();
+  netstack_sniffer_add(&reassembly_sniffer);
+
+  for(mode = ORDER_INTERLEAVED; mode <= ORDER_DUPLICATES; mode++) {
+    for(s = 0; s < sizeof(sender_counts) / sizeof(sender_counts[0]); s++) {
+      delivered = 0;
+      total = 0;
+      fed = 0;
+      elapsed = 0;
+      for(r = 0; r < NUM_ROUNDS; r++) {
+        make_round(sender_counts[s], mode);
+        start = cpu_time_ns();
+        feed_round();
+        elapsed += cpu_time_ns() - start;
+        fed += num_order;
+        total += sender_counts[s];
+      }
+
+      printf("%-11s %2d senders: %5d/%5d delivered, %6.1f ns/fragment\n",
+             order_names[mode], sender_counts[s], delivered, total,
+             (double)elapsed / fed);
+
+      /* All datagrams fit in the reassembly buffers, none may be lost */
+      if(delivered != total &&
+         sender_counts[s] <= REASS_CONTEXTS &&
+         sender_counts[s] * MAX_BUFS <= FRAGMENT_BUFFERS) {
+        printf("Lost %d datagrams\n", total - delivered);
+        failures++;
+      }
+
+      /* Let incomplete reassemblies time out before the next run */
+      if(delivered != total) {
+        etimer_set(&et, SICSLOWPAN_REASS_MAXAGE * CLOCK_SECOND / 16 + 1);
+        PROCESS_WAIT_EVENT_UNTIL(etimer_expired(&et));
+      }
+    }
+  }
+
+  check_tag_reuse();
+  check_mtu_datagrams();
+
+  printf("Result: %s\n", failures == 0 ? "OK" : "FAIL");
+  exit(failures == 0 ? 0 : 1);
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
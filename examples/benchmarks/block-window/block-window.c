@@ -0,0 +1,212 @@
+/*
+ * Copyright (c) 2026, Contiki-NG contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *         Checks windowed block-wise transfers on the native target. A
+ *         server emulated in the same process answers each round of
+ *         block requests in reverse order; the benchmark checks that
+ *         the payload is reassembled by offset and counts the round
+ *         trips against stop-and-wait transfers.
+ */
+
+#include "contiki.h"
+#include "coap-engine.h"
+#include "coap-callback-api.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+/*---------------------------------------------------------------------------*/
+#define CONTENT_SIZE 1000
+
+static uint8_t content[CONTENT_SIZE];
+static uint8_t reassembled[CONTENT_SIZE];
+static coap_window_request_state_t state;
+static coap_endpoint_t server;
+static coap_message_t request[1];
+static uint8_t done;
+static int failures;
+
+/* Behaviour of the emulated server */
+static uint16_t server_block_size;
+static uint8_t server_size2;
+static uint8_t server_not_found;
+/*---------------------------------------------------------------------------*/
+PROCESS(block_window_process, "Windowed block-wise check");
+AUTOSTART_PROCESSES(&block_window_process);
+/*---------------------------------------------------------------------------*/
+static void
+sink(coap_window_request_state_t *s, uint32_t offset,
+     const uint8_t *data, uint16_t len)
+{
+  if(offset + len > sizeof(reassembled)) {
+    printf("Block at %lu overflows\n", (unsigned long)offset);
+    failures++;
+    return;
+  }
+  memcpy(reassembled + offset, data, len);
+}
+/*---------------------------------------------------------------------------*/
+static void
+callback(coap_window_request_state_t *s)
+{
+  done = 1;
+}
+/*---------------------------------------------------------------------------*/
+/* Answers a request that was sent in transaction t */
+static void
+answer(coap_transaction_t *t)
+{
+  static uint8_t copy[COAP_MAX_PACKET_SIZE + 1];
+  static uint8_t buffer[COAP_MAX_PACKET_SIZE + 1];
+  coap_message_t req[1];
+  coap_message_t res[1];
+  uint32_t num = 0;
+  uint16_t size = 0;
+  uint32_t offset;
+  uint16_t block_size;
+  uint16_t len;
+
+  memcpy(copy, t->message, t->message_len);
+  coap_parse_message(req, copy, t->message_len);
+  coap_get_header_block2(req, &num, NULL, &size, NULL);
+  /* Block numbers count in the size of the first block */
+  block_size = MIN(size, server_block_size);
+  offset = num * block_size;
+
+  coap_init_message(res, COAP_TYPE_ACK, CONTENT_2_05, req->mid);
+  if(server_not_found) {
+    res->code = NOT_FOUND_4_04;
+  } else if(offset >= CONTENT_SIZE) {
+    res->code = BAD_OPTION_4_02;
+    coap_set_payload(res, "BlockOutOfScope", 15);
+  } else {
+    len = MIN(block_size, CONTENT_SIZE - offset);
+    coap_set_header_block2(res, num, offset + len < CONTENT_SIZE, block_size);
+    if(server_size2 && num == 0) {
+      coap_set_header_size2(res, CONTENT_SIZE);
+    }
+    coap_set_payload(res, content + offset, len);
+  }
+  coap_receive(&server, buffer, coap_serialize_message(res, buffer));
+}
+/*---------------------------------------------------------------------------*/
+/* Runs a transfer and returns the number of round trips it took */
+static int
+transfer(const char *name, uint8_t window, coap_request_status_t expected)
+{
+  coap_transaction_t *in_flight[COAP_BLOCK2_WINDOW];
+  int rounds = 0;
+  int n;
+  int i;
+
+  memset(reassembled, 0, sizeof(reassembled));
+  done = 0;
+  coap_init_message(request, COAP_TYPE_CON, COAP_GET, 0);
+  coap_set_header_uri_path(request, "fw");
+  if(!coap_send_window_request(&state, &server, request, window,
+                               sink, callback)) {
+    printf("%s: not started\n", name);
+    failures++;
+    return 0;
+  }
+
+  while(!done && rounds < 100) {
+    /* Answer the requests of one round trip, last first */
+    n = 0;
+    for(i = 0; i < COAP_BLOCK2_WINDOW; i++) {
+      if(state.slots[i].transaction != NULL) {
+        in_flight[n++] = state.slots[i].transaction;
+      }
+    }
+    while(n-- > 0 && !done) {
+      answer(in_flight[n]);
+    }
+    rounds++;
+  }
+
+  if(state.status != expected
+     || (expected == COAP_REQUEST_STATUS_FINISHED
+         && (state.size != CONTENT_SIZE
+             || memcmp(reassembled, content, CONTENT_SIZE) != 0))) {
+    printf("%s: status %u code %u, %lu bytes\n", name, state.status,
+           state.code, (unsigned long)state.size);
+    failures++;
+  }
+  printf("%-28s %2d round trips\n", name, rounds);
+  return rounds;
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(block_window_process, ev, data)
+{
+  int stop_and_wait;
+  int windowed;
+  int i;
+
+  PROCESS_BEGIN();
+
+  /* Let the CoAP engine open its socket */
+  PROCESS_PAUSE();
+
+  for(i = 0; i < CONTENT_SIZE; i++) {
+    content[i] = i * 7 + (i >> 8);
+  }
+  uip_ip6addr(&server.ipaddr, 0xfd00, 0, 0, 0, 0, 0, 0, 9);
+  server.port = UIP_HTONS(COAP_DEFAULT_PORT);
+
+  server_block_size = COAP_MAX_CHUNK_SIZE;
+  stop_and_wait = transfer("Stop-and-wait", 1, COAP_REQUEST_STATUS_FINISHED);
+  windowed = transfer("Window of 4", 4, COAP_REQUEST_STATUS_FINISHED);
+  if(windowed * 2 >= stop_and_wait) {
+    printf("Window did not cut the round trips\n");
+    failures++;
+  }
+
+  server_size2 = 1;
+  transfer("Window of 4, Size2", 4, COAP_REQUEST_STATUS_FINISHED);
+  server_size2 = 0;
+
+  server_block_size = COAP_MAX_CHUNK_SIZE / 2;
+  transfer("Window of 4, smaller blocks", 4, COAP_REQUEST_STATUS_FINISHED);
+
+  server_not_found = 1;
+  transfer("Not found", 4, COAP_REQUEST_STATUS_BLOCK_ERROR);
+  if(state.code != NOT_FOUND_4_04) {
+    printf("Not found: code %u\n", state.code);
+    failures++;
+  }
+
+  printf("Result: %s\n", failures == 0 ? "OK" : "FAIL");
+  exit(failures == 0 ? 0 : 1);
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
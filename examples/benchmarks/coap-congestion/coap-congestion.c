@@ -0,0 +1,208 @@
+/*
+ * Copyright (c) 2026, Contiki-NG contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *         Checks CoCoA congestion control on the native target: the RTO
+ *         estimators converge on measured RTTs, back off by the variable
+ *         backoff factor and age, and confirmable transactions beyond
+ *         NSTART are held back until an earlier exchange completes.
+ */
+
+#include "contiki.h"
+#include "coap-engine.h"
+#include "coap-cocoa.h"
+#include "coap-transactions.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+/*---------------------------------------------------------------------------*/
+static int failures;
+
+#define CHECK(cond, ...) do {                   \
+    if(!(cond)) {                               \
+      printf("Check failed: " __VA_ARGS__);     \
+      printf("\n");                             \
+      failures++;                               \
+    }                                           \
+  } while(0)
+/*---------------------------------------------------------------------------*/
+PROCESS(coap_congestion_process, "CoCoA check");
+AUTOSTART_PROCESSES(&coap_congestion_process);
+/*---------------------------------------------------------------------------*/
+static void
+endpoint(coap_endpoint_t *ep, uint16_t id)
+{
+  memset(ep, 0, sizeof(*ep));
+  uip_ip6addr(&ep->ipaddr, 0xfd00, 0, 0, 0, 0, 0, 0, id);
+  ep->port = UIP_HTONS(COAP_DEFAULT_PORT);
+}
+/*---------------------------------------------------------------------------*/
+static void
+check_estimators(void)
+{
+  coap_endpoint_t near, far;
+  coap_cocoa_rtt_t *r;
+  uint32_t rto;
+  int i;
+
+  endpoint(&near, 1);
+  endpoint(&far, 2);
+
+  CHECK(coap_cocoa_get_rto(&near) == COAP_COCOA_INITIAL_RTO,
+        "unmeasured RTO %lu", (unsigned long)coap_cocoa_get_rto(&near));
+
+  /* One hop: 50 ms answered at once */
+  for(i = 0; i < 16; i++) {
+    coap_cocoa_update(&near, 50, 0);
+  }
+  rto = coap_cocoa_get_rto(&near);
+  CHECK(rto >= COAP_COCOA_MIN_RTO && rto < 250, "near RTO %lu",
+        (unsigned long)rto);
+  CHECK(coap_cocoa_backoff(rto, 300) == 900, "short RTO backoff");
+
+  /* Deep in the tree: 4 s, answered after a retransmission */
+  for(i = 0; i < 16; i++) {
+    coap_cocoa_update(&far, 4000, 1);
+  }
+  rto = coap_cocoa_get_rto(&far);
+  CHECK(rto > 4000, "far RTO %lu", (unsigned long)rto);
+  CHECK(coap_cocoa_backoff(rto, 6000) == 9000, "long RTO backoff");
+  CHECK(coap_cocoa_backoff(2000, 2000) == 4000, "default backoff");
+
+  /* Ambiguous samples are ignored */
+  r = coap_cocoa_get(&far);
+  coap_cocoa_update(&far, 60000, 3);
+  CHECK(r->last_rtt == 4000 && r->weak.samples == 16 && r->strong.samples == 0,
+        "sample after 3 retransmissions used");
+
+  /* Estimates drift back towards the initial RTO when not refreshed */
+  r = coap_cocoa_get(&near);
+  rto = r->rto;
+  r->updated -= 16 * rto;
+  CHECK(coap_cocoa_get_rto(&near) == 2 * rto, "near RTO did not age");
+  r = coap_cocoa_get(&far);
+  rto = r->rto;
+  r->updated -= 4 * rto;
+  CHECK(coap_cocoa_get_rto(&far) == (rto + 2000) / 2, "far RTO did not age");
+
+  /* The endpoint updated least recently makes room for a new one */
+  for(i = 0; i < COAP_COCOA_ENDPOINTS - 1; i++) {
+    coap_endpoint_t other;
+    endpoint(&other, 100 + i);
+    coap_cocoa_update(&other, 100, 0);
+  }
+  CHECK(coap_cocoa_get(&near) == NULL, "least recent endpoint kept");
+  CHECK(coap_cocoa_get(&far) != NULL, "recent endpoint replaced");
+}
+/*---------------------------------------------------------------------------*/
+static coap_transaction_t *
+new_request(const coap_endpoint_t *ep)
+{
+  coap_message_t request[1];
+  coap_transaction_t *t;
+
+  t = coap_new_transaction(coap_get_mid(), ep);
+  if(t != NULL) {
+    coap_init_message(request, COAP_TYPE_CON, COAP_GET, t->mid);
+    coap_set_header_uri_path(request, "sensors/temp");
+    t->message_len = coap_serialize_message(request, t->message);
+  }
+  return t;
+}
+/*---------------------------------------------------------------------------*/
+static void
+check_nstart(void)
+{
+  coap_endpoint_t ep, other;
+  coap_transaction_t *t[COAP_NSTART + 2];
+  coap_transaction_t *o;
+  coap_cocoa_rtt_t *r;
+  uint32_t rto;
+  int i;
+
+  endpoint(&ep, 3);
+  endpoint(&other, 4);
+  for(i = 0; i < COAP_NSTART + 2; i++) {
+    t[i] = new_request(&ep);
+    coap_send_transaction(t[i]);
+  }
+  o = new_request(&other);
+  coap_send_transaction(o);
+
+  for(i = 0; i < COAP_NSTART + 2; i++) {
+    CHECK(t[i]->state == (i < COAP_NSTART ? COAP_TRANSACTION_OUTSTANDING
+                          : COAP_TRANSACTION_DEFERRED),
+          "transaction %d in state %u", i, t[i]->state);
+  }
+  CHECK(o->state == COAP_TRANSACTION_OUTSTANDING,
+        "transaction to another endpoint held back");
+
+  /* The first transmission waits for the dithered initial RTO */
+  rto = coap_cocoa_get_rto(&ep);
+  CHECK(t[0]->retrans_interval >= rto && t[0]->retrans_interval <= rto * 3 / 2,
+        "initial interval %lu for RTO %lu",
+        (unsigned long)t[0]->retrans_interval, (unsigned long)rto);
+
+  /* An answer completes one exchange and releases one held back */
+  coap_transaction_acknowledged(t[0]);
+  coap_clear_transaction(t[0]);
+  r = coap_cocoa_get(&ep);
+  CHECK(r != NULL && r->strong.samples == 1, "answer not sampled");
+  CHECK(t[COAP_NSTART]->state == COAP_TRANSACTION_OUTSTANDING,
+        "answer did not release a transaction");
+  CHECK(t[COAP_NSTART + 1]->state == COAP_TRANSACTION_DEFERRED,
+        "answer released two transactions");
+
+  /* A transaction held back and cancelled releases nothing */
+  coap_clear_transaction(t[COAP_NSTART + 1]);
+  for(i = 1; i <= COAP_NSTART; i++) {
+    coap_clear_transaction(t[i]);
+  }
+  coap_clear_transaction(o);
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(coap_congestion_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  /* Let the CoAP engine open its socket */
+  PROCESS_PAUSE();
+
+  check_estimators();
+  check_nstart();
+
+  printf("Result: %s\n", failures == 0 ? "OK" : "FAIL");
+  exit(failures == 0 ? 0 : 1);
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
@@ -0,0 +1,256 @@
+/*
+ * Copyright (c) 2026, Contiki-NG contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *         Benchmarks CoAP resource dispatch on the native target. Checks
+ *         coap_find_resource() against a walk of the resource list,
+ *         including sub-resource matches and reactivated resources,
+ *         checks the /.well-known/core payload served in blocks, and
+ *         times both.
+ */
+
+#include "contiki.h"
+#include "coap-engine.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+/*---------------------------------------------------------------------------*/
+#define NUM_OBJECTS    10
+#define NUM_INSTANCES  4
+#define NUM_RESOURCES  (NUM_OBJECTS * NUM_INSTANCES)
+#define NUM_LOOKUPS    1000000
+#define NUM_GETS       20000
+#define BLOCK_SIZE     64
+
+extern coap_resource_t res_well_known_core;
+
+static coap_resource_t resources[NUM_RESOURCES];
+static char urls[NUM_RESOURCES][8];
+static PARENT_RESOURCE(res_sub, "title=\"Sub\"", NULL, NULL, NULL, NULL);
+static RESOURCE(res_leaf, "title=\"Leaf\"", NULL, NULL, NULL, NULL);
+
+static char link_format[2048];
+static int failures;
+/*---------------------------------------------------------------------------*/
+PROCESS(coap_dispatch_bench_process, "CoAP dispatch benchmark");
+AUTOSTART_PROCESSES(&coap_dispatch_bench_process);
+/*---------------------------------------------------------------------------*/
+static uint64_t
+cpu_time_ns(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+/*---------------------------------------------------------------------------*/
+/* The list walk that dispatch used to do, preferring the longest match */
+static coap_resource_t *
+find_linear(const char *url, int url_len)
+{
+  coap_resource_t *resource;
+  coap_resource_t *match = NULL;
+  int len;
+
+  for(resource = coap_get_first_resource(); resource;
+      resource = coap_get_next_resource(resource)) {
+    len = strlen(resource->url);
+    if((url_len == len
+        || (url_len > len && (resource->flags & HAS_SUB_RESOURCES)
+            && url[len] == '/'))
+       && strncmp(resource->url, url, len) == 0) {
+      if(len == url_len) {
+        return resource;
+      }
+      if(match == NULL || len > strlen(match->url)) {
+        match = resource;
+      }
+    }
+  }
+  return match;
+}
+/*---------------------------------------------------------------------------*/
+static void
+check_find(const char *url, coap_resource_t *expected)
+{
+  coap_resource_t *found = coap_find_resource(url, strlen(url));
+
+  if(found != expected || find_linear(url, strlen(url)) != expected) {
+    printf("Lookup of \"%s\": got %s, expected %s\n", url,
+           found != NULL ? found->url : "none",
+           expected != NULL ? expected->url : "none");
+    failures++;
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+check_lookups(void)
+{
+  int i;
+
+  for(i = 0; i < NUM_RESOURCES; i++) {
+    check_find(urls[i], &resources[i]);
+  }
+  check_find(".well-known/core", &res_well_known_core);
+  check_find("sub", &res_sub);
+  check_find("sub/", &res_sub);
+  check_find("sub/x/y", &res_sub);
+  check_find("sub/leaf", &res_leaf);
+  check_find("sub/leaf/z", &res_sub);
+  check_find("sublime", NULL);
+  check_find("3300", NULL);
+  check_find("3300/", NULL);
+  check_find("3300/0/1", NULL);
+  check_find("/3300/0", NULL);
+  check_find("", NULL);
+}
+/*---------------------------------------------------------------------------*/
+/* Fetches /.well-known/core block by block into link_format */
+static size_t
+get_well_known_core(void)
+{
+  coap_message_t request;
+  coap_message_t response;
+  uint8_t buffer[BLOCK_SIZE + 1];
+  const uint8_t *payload;
+  int32_t offset = 0;
+  size_t total = 0;
+  int len;
+
+  coap_init_message(&request, COAP_TYPE_CON, COAP_GET, 0);
+  do {
+    coap_init_message(&response, COAP_TYPE_ACK, CONTENT_2_05, 0);
+    res_well_known_core.get_handler(&request, &response, buffer, BLOCK_SIZE,
+                                    &offset);
+    len = coap_get_payload(&response, &payload);
+    if(len > BLOCK_SIZE || total + len >= sizeof(link_format)) {
+      printf("Link-format block of %d bytes at %zu\n", len, total);
+      failures++;
+      break;
+    }
+    memcpy(link_format + total, payload, len);
+    total += len;
+  } while(offset != -1 && len > 0);
+  link_format[total] = '\0';
+  return total;
+}
+/*---------------------------------------------------------------------------*/
+static void
+check_well_known_core(void)
+{
+  char expected[sizeof(link_format)];
+  coap_resource_t *resource;
+  size_t len = 0;
+
+  for(resource = coap_get_first_resource(); resource;
+      resource = coap_get_next_resource(resource)) {
+    len += snprintf(expected + len, sizeof(expected) - len, "%s</%s>",
+                    len > 0 ? "," : "", resource->url);
+    if(resource->attributes != NULL && resource->attributes[0]) {
+      len += snprintf(expected + len, sizeof(expected) - len, ";%s",
+                      resource->attributes);
+    }
+  }
+
+  get_well_known_core();
+  if(strcmp(link_format, expected) != 0) {
+    printf("Link-format mismatch:\n  got      %s\n  expected %s\n",
+           link_format, expected);
+    failures++;
+  }
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(coap_dispatch_bench_process, ev, data)
+{
+  static coap_resource_t *sink;
+  uint64_t start;
+  uint64_t trie_ns;
+  uint64_t linear_ns;
+  size_t link_len;
+  int i;
+
+  PROCESS_BEGIN();
+
+  for(i = 0; i < NUM_RESOURCES; i++) {
+    snprintf(urls[i], sizeof(urls[i]), "%u/%u",
+             3300 + i / NUM_INSTANCES, i % NUM_INSTANCES);
+    resources[i].attributes = "rt=\"ipso\"";
+    coap_activate_resource(&resources[i], urls[i]);
+  }
+  coap_activate_resource(&res_sub, "sub");
+  check_well_known_core();
+  coap_activate_resource(&res_leaf, "sub/leaf");
+
+  check_lookups();
+  check_well_known_core();
+
+  start = cpu_time_ns();
+  for(i = 0; i < NUM_LOOKUPS; i++) {
+    sink = coap_find_resource(urls[i % NUM_RESOURCES],
+                              strlen(urls[i % NUM_RESOURCES]));
+  }
+  trie_ns = cpu_time_ns() - start;
+
+  start = cpu_time_ns();
+  for(i = 0; i < NUM_LOOKUPS; i++) {
+    sink = find_linear(urls[i % NUM_RESOURCES],
+                       strlen(urls[i % NUM_RESOURCES]));
+  }
+  linear_ns = cpu_time_ns() - start;
+  (void)sink;
+
+  printf("Resources: %d\n", NUM_RESOURCES + 3);
+  printf("Dispatch lookup: %6.1f ns, list walk %6.1f ns\n",
+         (double)trie_ns / NUM_LOOKUPS, (double)linear_ns / NUM_LOOKUPS);
+
+  start = cpu_time_ns();
+  for(i = 0; i < NUM_GETS; i++) {
+    link_len = get_well_known_core();
+  }
+  printf("/.well-known/core: %zu bytes in %zu blocks, %6.1f us/payload\n",
+         link_len, (link_len + BLOCK_SIZE - 1) / BLOCK_SIZE,
+         (double)(cpu_time_ns() - start) / NUM_GETS / 1000);
+
+  /* A reactivated resource moves to a new path and to the list tail */
+  coap_activate_resource(&resources[0], "moved/0");
+  check_find("moved/0", &resources[0]);
+  check_find("3300/0", NULL);
+  check_find(urls[1], &resources[1]);
+  check_well_known_core();
+
+  printf("Result: %s\n", failures == 0 ? "OK" : "FAIL");
+  exit(failures == 0 ? 0 : 1);
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
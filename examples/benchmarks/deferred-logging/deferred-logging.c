@@ -0,0 +1,298 @@
+/*
+ * Copyright (c) 2026, Contiki-NG contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *         Benchmarks deferred logging on the native target. Checks that
+ *         records stored in the log ring render to the same text as
+ *         formatting at the call site, that a full ring drops records and
+ *         reports them, and compares the cost of a LOG_INFO() call with
+ *         and without deferred formatting.
+ */
+
+#include "contiki.h"
+#include "sys/log.h"
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define LOG_MODULE "Bench"
+#define LOG_LEVEL LOG_LEVEL_INFO
+/*---------------------------------------------------------------------------*/
+#define NUM_CALLS 200000
+#define BATCH     64
+
+static char capture[512];
+static size_t capture_len;
+static char expected[512];
+static int failures;
+/*---------------------------------------------------------------------------*/
+PROCESS(log_deferred_bench_process, "Deferred log benchmark");
+AUTOSTART_PROCESSES(&log_deferred_bench_process);
+/*---------------------------------------------------------------------------*/
+int
+log_capture(const char *fmt, ...)
+{
+  va_list ap;
+  int ret;
+
+  va_start(ap, fmt);
+  ret = vsnprintf(capture + capture_len, sizeof(capture) - capture_len,
+                  fmt, ap);
+  va_end(ap);
+  if(ret > 0) {
+    capture_len = MIN(capture_len + ret, sizeof(capture) - 1);
+  }
+  return ret;
+}
+/*---------------------------------------------------------------------------*/
+static void
+capture_reset(void)
+{
+  capture_len = 0;
+  capture[0] = '\0';
+}
+/*---------------------------------------------------------------------------*/
+static uint64_t
+cpu_time_ns(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+/*---------------------------------------------------------------------------*/
+static void
+compare(int line)
+{
+  if(strcmp(capture, expected) != 0) {
+    printf("Line %d: rendered \"%s\", expected \"%s\"\n",
+           line, capture, expected);
+    failures++;
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* Format directly and through the ring, and compare the results */
+#define CHECK(...) do { \
+    capture_reset(); \
+    LOG_OUTPUT_DIRECT(__VA_ARGS__); \
+    strcpy(expected, capture); \
+    capture_reset(); \
+    log_deferred_printf(__VA_ARGS__); \
+    log_deferred_flush(); \
+    compare(__LINE__); \
+  } while(0)
+/*---------------------------------------------------------------------------*/
+static void
+check_formats(void)
+{
+  char str[64];
+  uint64_t big = 0x123456789abcdefULL;
+
+  CHECK("plain text\n");
+  CHECK("%d %i %u %x %X %o %c", -42, 7, 42u, 0xbeef, 0xbeef, 8, 'z');
+  CHECK("%hhu %hx %.2hx", 300, 0x12345, 0x5);
+  CHECK("%ld %lu %lx", -100000L, 100000UL, 0xdeadbeefUL);
+  CHECK("%lld %llu %llx", -(long long)big, (unsigned long long)big,
+        (unsigned long long)big);
+  CHECK("%zu %zd", sizeof(str), (ssize_t)-3);
+  CHECK("%8d|%-8d|%08x|%+d|% d|%#x", 5, 5, 5, 5, 5, 5);
+  CHECK("%*d|%-*d|%.*d|%*.*d", 6, 1, 6, 2, 4, 3, 8, 3, 4);
+  CHECK("%f %.3f %e %g %a", 3.25, -0.5, 12345.678, 1e-5, 1.0);
+  CHECK("%p", (void *)&failures);
+  CHECK("100%% %s", "done");
+  CHECK("%s|%10s|%-10s|%.3s", "abc", "right", "left", "truncated");
+
+  /* Copy the string argument at the call site */
+  strcpy(str, "before");
+  capture_reset();
+  log_deferred_printf("%s\n", str);
+  strcpy(str, "after");
+  log_deferred_flush();
+  strcpy(expected, "before\n");
+  compare(__LINE__);
+
+  /* Truncate long string arguments */
+  memset(str, 'x', sizeof(str) - 1);
+  str[sizeof(str) - 1] = '\0';
+  capture_reset();
+  log_deferred_printf("%s", str);
+  log_deferred_flush();
+  str[LOG_DEFERRED_MAX_STRLEN] = '\0';
+  strcpy(expected, str);
+  compare(__LINE__);
+
+  capture_reset();
+  LOG_INFO("x=%u\n", 5);
+  log_deferred_flush();
+  strcpy(expected, "[INFO: Bench     ] x=5\n");
+  compare(__LINE__);
+}
+/*---------------------------------------------------------------------------*/
+/* Records of 16 bytes, the header, the format string and a string
+   argument, fill the ring exactly */
+#define EXACT_RECORD_LEN 16
+#define EXACT_STRLEN     (EXACT_RECORD_LEN - 2 - sizeof(char *) - 1)
+/*---------------------------------------------------------------------------*/
+/* Log record i of a drop check */
+static void
+log_record(int i, int exact)
+{
+  char str[EXACT_STRLEN + 1];
+
+  if(exact) {
+    snprintf(str, sizeof(str), "%0*d", (int)EXACT_STRLEN, i);
+    log_deferred_printf("%s", str);
+  } else {
+    log_deferred_printf("record %d\n", i);
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* Append the text of record i to the expected output */
+static void
+expect_record(int i, int exact)
+{
+  size_t len = strlen(expected);
+
+  if(exact) {
+    snprintf(expected + len, sizeof(expected) - len, "%0*d",
+             (int)EXACT_STRLEN, i);
+  } else {
+    snprintf(expected + len, sizeof(expected) - len, "record %d\n", i);
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* Overflow the ring and check that the drops are counted and reported */
+static void
+check_drops(int exact)
+{
+  uint32_t records = log_deferred_stats.records;
+  uint32_t dropped = log_deferred_stats.dropped;
+  int stored;
+  int i;
+
+  log_deferred_stats.max_used = 0;
+  for(i = 0; i < LOG_DEFERRED_BUF_SIZE; i++) {
+    log_record(i, exact);
+  }
+  stored = log_deferred_stats.records - records;
+  if(stored == 0 || stored + log_deferred_stats.dropped - dropped
+     != LOG_DEFERRED_BUF_SIZE ||
+     (exact && stored != LOG_DEFERRED_BUF_SIZE / EXACT_RECORD_LEN)) {
+    printf("Drops: %d records stored, %lu dropped\n", stored,
+           (unsigned long)(log_deferred_stats.dropped - dropped));
+    failures++;
+  }
+  if(log_deferred_stats.max_used > LOG_DEFERRED_BUF_SIZE) {
+    printf("Drops: ring used beyond its size (%u bytes)\n",
+           log_deferred_stats.max_used);
+    failures++;
+  }
+
+  capture_reset();
+  log_deferred_render();
+  snprintf(expected, sizeof(expected), "[log: %d records dropped]\n",
+           LOG_DEFERRED_BUF_SIZE - stored);
+  expect_record(0, exact);
+  compare(__LINE__);
+  for(i = 1; i < stored; i++) {
+    capture_reset();
+    log_deferred_render();
+    expected[0] = '\0';
+    expect_record(i, exact);
+    compare(__LINE__);
+  }
+  if(log_deferred_render() != 0) {
+    printf("Drops: ring not empty\n");
+    failures++;
+  }
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(log_deferred_bench_process, ev, data)
+{
+  uint64_t start;
+  uint64_t inline_ns;
+  uint64_t store_ns = 0;
+  uint64_t render_ns = 0;
+  uint32_t dropped;
+  int i;
+
+  PROCESS_BEGIN();
+
+  /* Discard the startup logs */
+  log_deferred_flush();
+
+  check_formats();
+  check_drops(0);
+  check_drops(1);
+
+  start = cpu_time_ns();
+  for(i = 0; i < NUM_CALLS; i++) {
+    capture_reset();
+    LOG_OUTPUT_DIRECT("[%-4s: %-10s] ", "INFO", LOG_MODULE);
+    LOG_OUTPUT_DIRECT("seq %u rssi %d from %s\n", i, -70, "fe80::212:7401:1:101");
+  }
+  inline_ns = cpu_time_ns() - start;
+
+  dropped = log_deferred_stats.dropped;
+  for(i = 0; i < NUM_CALLS; i += BATCH) {
+    int j;
+    start = cpu_time_ns();
+    for(j = 0; j < BATCH; j++) {
+      LOG_INFO("seq %u rssi %d from %s\n", i + j, -70, "fe80::212:7401:1:101");
+    }
+    store_ns += cpu_time_ns() - start;
+    start = cpu_time_ns();
+    while(log_deferred_render()) {
+      capture_reset();
+    }
+    render_ns += cpu_time_ns() - start;
+  }
+  if(log_deferred_stats.dropped != dropped) {
+    printf("Benchmark: %lu records dropped\n",
+           (unsigned long)(log_deferred_stats.dropped - dropped));
+    failures++;
+  }
+
+  printf("Inline LOG_INFO:   %6.1f ns/call\n", (double)inline_ns / NUM_CALLS);
+  printf("Deferred LOG_INFO: %6.1f ns/call, rendering %.1f ns/call\n",
+         (double)store_ns / NUM_CALLS, (double)render_ns / NUM_CALLS);
+  printf("Ring high-water mark: %u of %u bytes\n",
+         log_deferred_stats.max_used, LOG_DEFERRED_BUF_SIZE);
+
+  printf("Result: %s\n", failures == 0 ? "OK" : "FAIL");
+  exit(failures == 0 ? 0 : 1);
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
@@ -0,0 +1,206 @@
+/*
+ * Copyright (c) 2026, Contiki-NG contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *         Benchmarks event timers on the native target. Timers with
+ *         random intervals are set, half of them stopped and set again,
+ *         then all are left to expire, with 16 to 1024 timers pending.
+ *         Every timer must fire once and not early.
+ */
+
+#include "contiki.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+/*---------------------------------------------------------------------------*/
+#define MAX_TIMERS      1024
+#define NUM_NEXT        100000
+/*---------------------------------------------------------------------------*/
+static const int timer_counts[] = { 16, 64, 256, MAX_TIMERS };
+static struct etimer timers[MAX_TIMERS];
+static uint8_t fired[MAX_TIMERS];
+static uint32_t rand_state = 1;
+static int failures;
+/*---------------------------------------------------------------------------*/
+PROCESS(etimer_expiry_process, "Event timer benchmark");
+AUTOSTART_PROCESSES(&etimer_expiry_process);
+/*---------------------------------------------------------------------------*/
+static uint32_t
+next_rand(void)
+{
+  rand_state = rand_state * 1103515245 + 12345;
+  return rand_state >> 8;
+}
+/*---------------------------------------------------------------------------*/
+static uint64_t
+cpu_time_ns(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+/*---------------------------------------------------------------------------*/
+/* Between a quarter and half a second */
+static clock_time_t
+random_interval(void)
+{
+  return CLOCK_SECOND / 4 + next_rand() % (CLOCK_SECOND / 4);
+}
+/*---------------------------------------------------------------------------*/
+/* Check a fired timer, returns its index */
+static int
+check_fired(struct etimer *et, clock_time_t *last)
+{
+  int i = et - timers;
+
+  if(i < 0 || i >= MAX_TIMERS) {
+    printf("Unknown timer fired\n");
+    failures++;
+    return -1;
+  }
+  if(fired[i]++) {
+    printf("Timer %d fired twice\n", i);
+    failures++;
+  }
+  if(!timer_expired(&et->timer)) {
+    printf("Timer %d fired early\n", i);
+    failures++;
+  }
+  /* The heap fires timers in expiration order */
+  if(ETIMER_WITH_HEAP && etimer_expiration_time(et) - *last > CLOCK_SECOND) {
+    printf("Timer %d fired out of order\n", i);
+    failures++;
+  }
+  *last = etimer_expiration_time(et);
+  return i;
+}
+/*---------------------------------------------------------------------------*/
+#if ETIMER_WITH_HEAP
+/* A timer that is not in the heap but names a process, for instance
+   with leftovers from an earlier use of its memory, must not have its
+   links followed, even if the leftovers claim it is in the heap */
+static struct etimer stale;
+
+static void
+make_stale(int in_heap)
+{
+  memset(&stale, 0, sizeof(stale));
+  stale.p = &etimer_expiry_process;
+  stale.in_heap = in_heap;
+  if(!in_heap) {
+    stale.prev = (struct etimer *)(uintptr_t)1;
+  }
+  stale.child = (struct etimer *)(uintptr_t)1;
+  stale.next = (struct etimer *)(uintptr_t)1;
+}
+#endif /* ETIMER_WITH_HEAP */
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(etimer_expiry_process, ev, data)
+{
+  static clock_time_t last;
+  static int remaining;
+  static int s;
+  volatile clock_time_t sink;
+  uint64_t set_ns;
+  uint64_t next_ns;
+  uint64_t reset_ns;
+  uint64_t start;
+  int n;
+  int i;
+
+  PROCESS_BEGIN();
+
+  printf("Timer heap: %s\n", ETIMER_WITH_HEAP ? "on" : "off");
+  printf("Timers  set (ns)  next (ns)  stop+set (ns)\n");
+
+  for(s = 0; s < sizeof(timer_counts) / sizeof(timer_counts[0]); s++) {
+    n = timer_counts[s];
+    memset(fired, 0, sizeof(fired));
+
+    start = cpu_time_ns();
+    for(i = 0; i < n; i++) {
+      etimer_set(&timers[i], random_interval());
+    }
+    set_ns = cpu_time_ns() - start;
+
+    start = cpu_time_ns();
+    for(i = 0; i < NUM_NEXT; i++) {
+      sink = etimer_next_expiration_time();
+    }
+    (void)sink;
+    next_ns = cpu_time_ns() - start;
+
+    /* Stop every other timer, then set them again */
+    start = cpu_time_ns();
+    for(i = 0; i < n; i += 2) {
+      etimer_stop(&timers[i]);
+    }
+    for(i = 0; i < n; i += 2) {
+      etimer_set(&timers[i], random_interval());
+    }
+    reset_ns = cpu_time_ns() - start;
+
+    printf("%6d  %8.1f  %9.1f  %14.1f\n", n, (double)set_ns / n,
+           (double)next_ns / NUM_NEXT, (double)reset_ns / n);
+
+    /* Wait for all timers to fire */
+    last = clock_time();
+    for(remaining = n; remaining > 0;) {
+      PROCESS_WAIT_EVENT_UNTIL(ev == PROCESS_EVENT_TIMER);
+      if(check_fired(data, &last) >= 0) {
+        remaining--;
+      }
+    }
+  }
+
+#if ETIMER_WITH_HEAP
+  for(s = 0; s < 2; s++) {
+    make_stale(s);
+    etimer_stop(&stale);
+    make_stale(s);
+    etimer_adjust(&stale, 1);
+    make_stale(s);
+    etimer_set(&stale, 1);
+    PROCESS_WAIT_EVENT_UNTIL(ev == PROCESS_EVENT_TIMER && data == &stale);
+    printf("Stale timer%s: stopped, adjusted and set\n",
+           s ? " with in_heap set" : "");
+  }
+#endif /* ETIMER_WITH_HEAP */
+
+  printf("Result: %s\n", failures == 0 ? "OK" : "FAIL");
+  exit(failures == 0 ? 0 : 1);
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
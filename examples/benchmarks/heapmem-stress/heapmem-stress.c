@@ -0,0 +1,302 @@
+/*
+ * Copyright (c) 2026, Contiki-NG contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * \file
+ *         Stress test for the heapmem allocator on the native target. A
+ *         trace of allocations, reallocations and deallocations with the
+ *         sizes of protocol payloads and options is generated, then
+ *         replayed while timing every call. The contents of all chunks
+ *         and the heap statistics are checked along the way.
+ */
+
+#include "contiki.h"
+#include "lib/heapmem.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+/*---------------------------------------------------------------------------*/
+#define NUM_SLOTS      256
+#define NUM_OPS        200000
+#define STATS_INTERVAL 1000
+
+enum op_type { OP_ALLOC, OP_REALLOC, OP_FREE };
+
+struct op {
+  uint8_t type;
+  uint16_t slot;
+  uint16_t size;
+};
+
+struct slot {
+  uint8_t *ptr;
+  uint16_t size;
+};
+
+struct timing {
+  uint64_t total_ns;
+  unsigned long count;
+};
+
+static struct op trace[NUM_OPS];
+static struct slot slots[NUM_SLOTS];
+static struct timing timings[3];
+static uint64_t clock_overhead_ns;
+static unsigned long alloc_failures;
+static uint32_t rand_state = 1;
+static int failures;
+/*---------------------------------------------------------------------------*/
+PROCESS(heapmem_stress_process, "Heapmem stress test");
+AUTOSTART_PROCESSES(&heapmem_stress_process);
+/*---------------------------------------------------------------------------*/
+static uint32_t
+next_rand(void)
+{
+  rand_state = rand_state * 1103515245 + 12345;
+  return rand_state >> 8;
+}
+/*---------------------------------------------------------------------------*/
+static uint64_t
+cpu_time_ns(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+/*---------------------------------------------------------------------------*/
+/* The least time measured between two readings of the clock */
+static uint64_t
+measure_clock_overhead(void)
+{
+  uint64_t min = UINT64_MAX;
+  uint64_t ns;
+  int i;
+
+  for(i = 0; i < 1000; i++) {
+    ns = cpu_time_ns();
+    ns = cpu_time_ns() - ns;
+    if(ns < min) {
+      min = ns;
+    }
+  }
+  return min;
+}
+/*---------------------------------------------------------------------------*/
+/* Mostly option and property sized chunks, some payloads and a few
+   large block-wise transfers */
+static uint16_t
+random_size(void)
+{
+  uint32_t r = next_rand() % 10;
+
+  if(r < 6) {
+    return 8 + next_rand() % 56;
+  } else if(r < 9) {
+    return 64 + next_rand() % 448;
+  }
+  return 512 + next_rand() % 688;
+}
+/*---------------------------------------------------------------------------*/
+static void
+generate_trace(void)
+{
+  static uint8_t live[NUM_SLOTS];
+  struct op *op;
+  int i;
+
+  for(i = 0; i < NUM_OPS; i++) {
+    op = &trace[i];
+    op->slot = next_rand() % NUM_SLOTS;
+    if(!live[op->slot]) {
+      op->type = OP_ALLOC;
+      op->size = random_size();
+      live[op->slot] = 1;
+    } else if(next_rand() % 5 == 0) {
+      op->type = OP_REALLOC;
+      op->size = random_size();
+    } else {
+      op->type = OP_FREE;
+      op->size = 0;
+      live[op->slot] = 0;
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+fill(struct slot *s, int slot, uint16_t from)
+{
+  uint16_t i;
+
+  for(i = from; i < s->size; i++) {
+    s->ptr[i] = (uint8_t)(slot * 31 + i);
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+check(const struct slot *s, int slot, uint16_t len)
+{
+  uint16_t i;
+
+  for(i = 0; i < len; i++) {
+    if(s->ptr[i] != (uint8_t)(slot * 31 + i)) {
+      printf("Chunk %d corrupted at %u\n", slot, i);
+      failures++;
+      return;
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+check_stats(heapmem_stats_t *stats)
+{
+  heapmem_stats(stats);
+  if(stats->allocated + stats->overhead + stats->available !=
+     HEAPMEM_CONF_ARENA_SIZE) {
+    printf("Inconsistent statistics\n");
+    failures++;
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+replay(const struct op *op)
+{
+  struct slot *s = &slots[op->slot];
+  uint8_t *ptr;
+  uint64_t start, ns;
+
+  if(op->type != OP_ALLOC && s->ptr == NULL) {
+    /* The allocation failed */
+    return;
+  }
+  if(s->ptr != NULL) {
+    check(s, op->slot, s->size);
+  }
+
+  start = cpu_time_ns();
+  switch(op->type) {
+  case OP_ALLOC:
+    ptr = heapmem_alloc(op->size);
+    break;
+  case OP_REALLOC:
+    ptr = heapmem_realloc(s->ptr, op->size);
+    break;
+  default:
+    heapmem_free(s->ptr);
+    ptr = NULL;
+    break;
+  }
+  ns = cpu_time_ns() - start;
+  ns = ns > clock_overhead_ns ? ns - clock_overhead_ns : 0;
+
+  timings[op->type].total_ns += ns;
+  timings[op->type].count++;
+
+  if(op->type == OP_FREE) {
+    s->ptr = NULL;
+  } else if(ptr == NULL) {
+    /* A failed reallocation leaves the chunk as it was */
+    alloc_failures++;
+  } else {
+    if(op->type == OP_REALLOC) {
+      s->ptr = ptr;
+      check(s, op->slot, s->size < op->size ? s->size : op->size);
+    }
+    s->ptr = ptr;
+    s->size = op->size;
+    fill(s, op->slot, 0);
+  }
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(heapmem_stress_process, ev, data)
+{
+  static const char *names[] = { "alloc", "realloc", "free" };
+  heapmem_stats_t stats;
+  size_t min_largest;
+  int i;
+
+  PROCESS_BEGIN();
+
+  printf("TLSF: %s, arena %u bytes, %d operations\n",
+         HEAPMEM_WITH_TLSF ? "on" : "off", HEAPMEM_CONF_ARENA_SIZE, NUM_OPS);
+
+  generate_trace();
+  clock_overhead_ns = measure_clock_overhead();
+
+  min_largest = HEAPMEM_CONF_ARENA_SIZE;
+  for(i = 0; i < NUM_OPS; i++) {
+    replay(&trace[i]);
+    if(i % STATS_INTERVAL == 0) {
+      check_stats(&stats);
+      if(stats.largest_free < min_largest) {
+        min_largest = stats.largest_free;
+      }
+    }
+  }
+
+  printf("Call      calls  avg (ns)\n");
+  for(i = 0; i < 3; i++) {
+    printf("%-7s  %6lu  %8.1f\n", names[i], timings[i].count,
+           timings[i].count ? (double)timings[i].total_ns / timings[i].count : 0);
+  }
+  printf("Failed allocations: %lu\n", alloc_failures);
+  printf("Smallest largest free chunk: %lu\n", (unsigned long)min_largest);
+
+  check_stats(&stats);
+  printf("End of trace: %lu allocated, %lu free in %lu chunks, "
+         "largest %lu, fragmentation %u%%\n",
+         (unsigned long)stats.allocated, (unsigned long)stats.available,
+         (unsigned long)stats.free_chunks, (unsigned long)stats.largest_free,
+         stats.fragmentation);
+  printf("Free chunks per class:");
+  for(i = 0; i < HEAPMEM_CLASSES; i++) {
+    printf(" %lu", (unsigned long)stats.class_free_chunks[i]);
+  }
+  printf("\n");
+
+  for(i = 0; i < NUM_SLOTS; i++) {
+    if(slots[i].ptr != NULL) {
+      check(&slots[i], i, slots[i].size);
+      heapmem_free(slots[i].ptr);
+    }
+  }
+  check_stats(&stats);
+  if(stats.allocated != 0) {
+    printf("Memory left allocated\n");
+    failures++;
+  }
+
+  printf("Result: %s\n", failures == 0 ? "OK" : "FAIL");
+  exit(failures == 0 ? 0 : 1);
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
@@ -0,0 +1,210 @@
+/*
+ * Copyright (c) 2026, Contiki-NG contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *         Benchmarks memb_alloc() and memb_free() on the native target,
+ *         with MEMB() and MEMB_FREELIST() pools of 8 to 256 blocks. Each
+ *         pool is kept three quarters full while random blocks are freed
+ *         and allocated again, and every result is checked against the
+ *         set of blocks that should be allocated.
+ */
+
+#include "contiki.h"
+#include "lib/memb.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+/*---------------------------------------------------------------------------*/
+#define MAX_BLOCKS     256
+#define NUM_OPS        200000
+
+struct block {
+  uint8_t data[32];
+};
+
+#define POOLS(n) \
+  MEMB(memb_##n, struct block, n); \
+  MEMB_FREELIST(freelist_##n, struct block, n)
+
+POOLS(8);
+POOLS(16);
+POOLS(32);
+POOLS(64);
+POOLS(128);
+POOLS(256);
+
+static struct memb *pools[][2] = {
+  { &memb_8, &freelist_8 },
+  { &memb_16, &freelist_16 },
+  { &memb_32, &freelist_32 },
+  { &memb_64, &freelist_64 },
+  { &memb_128, &freelist_128 },
+  { &memb_256, &freelist_256 },
+};
+
+static void *allocated[MAX_BLOCKS];
+static int num_allocated;
+static uint32_t rand_state = 1;
+static int failures;
+/*---------------------------------------------------------------------------*/
+PROCESS(memb_alloc_process, "MEMB benchmark");
+AUTOSTART_PROCESSES(&memb_alloc_process);
+/*---------------------------------------------------------------------------*/
+static uint32_t
+next_rand(void)
+{
+  rand_state = rand_state * 1103515245 + 12345;
+  return rand_state >> 8;
+}
+/*---------------------------------------------------------------------------*/
+static uint64_t
+cpu_time_ns(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+/*---------------------------------------------------------------------------*/
+static void
+fail(struct memb *m, const char *what)
+{
+  printf("%s pool of %d blocks: %s\n", m->freelist != NULL ? "Free list" : "Plain",
+         m->num, what);
+  failures++;
+}
+/*---------------------------------------------------------------------------*/
+/* Allocate until the pool is full and check every block and count */
+static void
+check_pool(struct memb *m)
+{
+  void *p;
+  int i;
+
+  memb_init(m);
+  for(num_allocated = 0; num_allocated < m->num; num_allocated++) {
+    p = memb_alloc(m);
+    if(p == NULL || !memb_inmemb(m, p)) {
+      fail(m, "allocation failed");
+      return;
+    }
+    for(i = 0; i < num_allocated; i++) {
+      if(allocated[i] == p) {
+        fail(m, "block allocated twice");
+      }
+    }
+    allocated[num_allocated] = p;
+    if(memb_numfree(m) != m->num - num_allocated - 1) {
+      fail(m, "wrong number of free blocks");
+    }
+  }
+  if(memb_alloc(m) != NULL) {
+    fail(m, "allocated more blocks than declared");
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* Free and allocate random blocks of a three quarters full pool */
+static uint64_t
+run_pool(struct memb *m, int check)
+{
+  uint64_t start;
+  void *p;
+  int i;
+  int j;
+  int k;
+
+  memb_init(m);
+  for(num_allocated = 0; num_allocated < m->num * 3 / 4; num_allocated++) {
+    allocated[num_allocated] = memb_alloc(m);
+  }
+
+  start = cpu_time_ns();
+  for(i = 0; i < NUM_OPS; i++) {
+    j = next_rand() % num_allocated;
+    if(memb_free(m, allocated[j]) != 0) {
+      fail(m, "free failed");
+    }
+    if(check) {
+      if(memb_free(m, allocated[j]) != -1) {
+        fail(m, "double free not detected");
+      }
+      if(memb_free(m, (char *)allocated[j] + 1) != -1) {
+        fail(m, "free of an unaligned pointer not detected");
+      }
+      if(memb_numfree(m) != m->num - num_allocated + 1) {
+        fail(m, "wrong number of free blocks");
+      }
+    }
+    p = memb_alloc(m);
+    if(check) {
+      /* Any free block may come back, but none still allocated */
+      for(k = 0; k < num_allocated; k++) {
+        if(k != j && allocated[k] == p) {
+          fail(m, "block allocated twice");
+        }
+      }
+      if(p == NULL) {
+        fail(m, "allocation failed");
+      }
+    }
+    allocated[j] = p;
+  }
+  return cpu_time_ns() - start;
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(memb_alloc_process, ev, data)
+{
+  uint64_t elapsed[2];
+  int s;
+  int mode;
+
+  PROCESS_BEGIN();
+
+  printf("Blocks  MEMB (ns/op)  MEMB_FREELIST (ns/op)\n");
+  for(s = 0; s < sizeof(pools) / sizeof(pools[0]); s++) {
+    for(mode = 0; mode < 2; mode++) {
+      check_pool(pools[s][mode]);
+      run_pool(pools[s][mode], 1);
+      elapsed[mode] = run_pool(pools[s][mode], 0);
+    }
+    printf("%6d  %12.1f  %21.1f\n", pools[s][0]->num,
+           (double)elapsed[0] / (2 * NUM_OPS),
+           (double)elapsed[1] / (2 * NUM_OPS));
+  }
+
+  printf("Result: %s\n", failures == 0 ? "OK" : "FAIL");
+  exit(failures == 0 ? 0 : 1);
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
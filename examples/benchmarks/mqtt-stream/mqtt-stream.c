@@ -0,0 +1,214 @@
+/*
+ * Copyright (c) 2026, Contiki-NG contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *         Checks streaming MQTT publishes on the native target. A payload
+ *         larger than 64 KB is published through a producer callback and
+ *         one of the same size from the broker is taken in through the
+ *         PUBLISH stream callback, neither of them ever held in one buffer.
+ *         tests/08-native-runs/25-mqtt-stream.sh runs the broker side.
+ */
+
+#include "contiki.h"
+#include "mqtt.h"
+#include "mqtt-prop.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+/*---------------------------------------------------------------------------*/
+#define BROKER_IP_ADDR "fd00::1"
+#define BROKER_PORT 1883
+/* Past 16 bit lengths and two byte Remaining Length fields */
+#define PAYLOAD_SIZE 70000UL
+
+/* Both directions carry the same pattern, derived from the offset */
+#define PATTERN(offset) ((uint8_t)((offset) * 7 + ((offset) >> 8)))
+/*---------------------------------------------------------------------------*/
+static struct mqtt_connection conn;
+static uint16_t producer_calls;
+static uint16_t producer_max_len;
+static uint16_t chunks;
+static uint16_t chunk_max_len;
+static uint32_t received;
+static uint8_t subscribe_sent;
+static uint8_t subscribed;
+static uint8_t published;
+static uint8_t done;
+static int failures;
+/*---------------------------------------------------------------------------*/
+PROCESS(mqtt_stream_process, "MQTT stream check");
+AUTOSTART_PROCESSES(&mqtt_stream_process);
+/*---------------------------------------------------------------------------*/
+static int
+producer(struct mqtt_connection *m, uint8_t *buf, uint16_t len,
+         uint32_t offset, void *ptr)
+{
+  uint16_t i;
+
+  producer_calls++;
+  producer_max_len = MAX(producer_max_len, len);
+  for(i = 0; i < len; i++) {
+    buf[i] = PATTERN(offset + i);
+  }
+  return len;
+}
+/*---------------------------------------------------------------------------*/
+static void
+stream_callback(struct mqtt_connection *m, struct mqtt_message *msg)
+{
+  uint32_t offset;
+  uint16_t i;
+
+  if(msg->first_chunk) {
+    received = 0;
+    if(strcmp(msg->topic, "bench/in") != 0 ||
+       msg->payload_length != PAYLOAD_SIZE) {
+      printf("Unexpected message on '%s', %lu bytes\n",
+             msg->topic, (unsigned long)msg->payload_length);
+      failures++;
+    }
+  }
+
+  offset = msg->payload_length - msg->payload_left -
+    msg->payload_chunk_length;
+  if(offset != received) {
+    printf("Chunk at %lu, expected %lu\n",
+           (unsigned long)offset, (unsigned long)received);
+    failures++;
+  }
+  for(i = 0; i < msg->payload_chunk_length; i++) {
+    if(msg->payload_chunk[i] != PATTERN(offset + i)) {
+      printf("Payload differs at %lu\n", (unsigned long)(offset + i));
+      failures++;
+      break;
+    }
+  }
+  received += msg->payload_chunk_length;
+  chunks++;
+  chunk_max_len = MAX(chunk_max_len, msg->payload_chunk_length);
+
+  if(msg->payload_left == 0) {
+    done = 1;
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+mqtt_event(struct mqtt_connection *m, mqtt_event_t event, void *data)
+{
+  switch(event) {
+  case MQTT_EVENT_CONNECTED:
+    printf("Connected\n");
+    break;
+  case MQTT_EVENT_DISCONNECTED:
+    printf("Disconnected\n");
+    failures++;
+    done = 1;
+    break;
+  case MQTT_EVENT_SUBACK:
+    subscribed = 1;
+    break;
+  case MQTT_EVENT_PUBLISH:
+    printf("PUBLISH went past the stream callback\n");
+    failures++;
+    break;
+  default:
+    break;
+  }
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(mqtt_stream_process, ev, data)
+{
+  static struct etimer et;
+  static uint16_t steps;
+
+  PROCESS_BEGIN();
+
+  mqtt_register(&conn, &mqtt_stream_process, "mqtt-stream", mqtt_event,
+                MQTT_TCP_OUTPUT_BUFF_SIZE);
+  mqtt_set_publish_stream_callback(&conn, stream_callback);
+#if MQTT_5
+  mqtt_connect(&conn, BROKER_IP_ADDR, BROKER_PORT, 60,
+               MQTT_CLEAN_SESSION_ON, MQTT_PROP_LIST_NONE);
+#else
+  mqtt_connect(&conn, BROKER_IP_ADDR, BROKER_PORT, 60,
+               MQTT_CLEAN_SESSION_ON);
+#endif
+
+  /* Subscribes once connected, then publishes once that is through */
+  for(steps = 0; !done && steps < 300; steps++) {
+    etimer_set(&et, CLOCK_SECOND / 10);
+    PROCESS_WAIT_EVENT_UNTIL(etimer_expired(&et));
+
+    if(!mqtt_ready(&conn)) {
+      continue;
+    }
+#if MQTT_5
+    if(!subscribe_sent) {
+      mqtt_subscribe(&conn, NULL, "bench/in", MQTT_QOS_LEVEL_0,
+                     MQTT_NL_OFF, MQTT_RAP_OFF, MQTT_RET_H_SEND_ALL,
+                     MQTT_PROP_LIST_NONE);
+      subscribe_sent = 1;
+    } else if(subscribed && !published) {
+      mqtt_publish_stream(&conn, NULL, "bench/out", producer, NULL,
+                          PAYLOAD_SIZE, MQTT_QOS_LEVEL_0, MQTT_RETAIN_OFF,
+                          0, MQTT_TOPIC_ALIAS_OFF, MQTT_PROP_LIST_NONE);
+      published = 1;
+    }
+#else
+    if(!subscribe_sent) {
+      mqtt_subscribe(&conn, NULL, "bench/in", MQTT_QOS_LEVEL_0);
+      subscribe_sent = 1;
+    } else if(subscribed && !published) {
+      mqtt_publish_stream(&conn, NULL, "bench/out", producer, NULL,
+                          PAYLOAD_SIZE, MQTT_QOS_LEVEL_0, MQTT_RETAIN_OFF);
+      published = 1;
+    }
+#endif
+  }
+
+  printf("Published %lu bytes in %u producer calls of up to %u bytes\n",
+         PAYLOAD_SIZE, producer_calls, producer_max_len);
+  printf("Received %lu bytes in %u chunks of up to %u bytes\n",
+         (unsigned long)received, chunks, chunk_max_len);
+  printf("Connection state: %u bytes\n",
+         (unsigned)sizeof(struct mqtt_connection));
+
+  if(!done || received != PAYLOAD_SIZE ||
+     producer_max_len > MQTT_TCP_OUTPUT_BUFF_SIZE) {
+    failures++;
+  }
+  printf("Result: %s\n", failures ? "FAIL" : "OK");
+  exit(failures ? 1 : 0);
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
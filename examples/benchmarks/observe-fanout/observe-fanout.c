@@ -0,0 +1,176 @@
+/*
+ * Copyright (c) 2026, Contiki-NG contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *         Benchmarks CoAP observe notifications on the native target.
+ *         Registers more observers than there are transactions and
+ *         checks that every notification reaches each observer while
+ *         the resource handler runs once per notification, including
+ *         notifications of a sub-resource. Also times a notification.
+ */
+
+#include "contiki.h"
+#include "coap-engine.h"
+#include "coap-observe.h"
+#include "net/ipv6/uip.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+/*---------------------------------------------------------------------------*/
+#define NUM_OBSERVERS     COAP_MAX_OBSERVERS
+#define NUM_SUB_OBSERVERS 4
+#define NUM_NOTIFICATIONS 2000
+
+static int renders;
+static int failures;
+/*---------------------------------------------------------------------------*/
+static void
+get_handler(coap_message_t *request, coap_message_t *response,
+            uint8_t *buffer, uint16_t preferred_size, int32_t *offset)
+{
+  const char *url = NULL;
+  int len;
+
+  renders++;
+  len = coap_get_header_uri_path(request, &url);
+  coap_set_header_content_format(response, TEXT_PLAIN);
+  coap_set_payload(response, buffer,
+                   snprintf((char *)buffer, preferred_size, "%.*s: %d",
+                            len, url, renders));
+}
+/*---------------------------------------------------------------------------*/
+static RESOURCE(res_sensor, "obs", get_handler, NULL, NULL, NULL);
+static PARENT_RESOURCE(res_parent, "obs", get_handler, NULL, NULL, NULL);
+/*---------------------------------------------------------------------------*/
+PROCESS(observe_fanout_bench_process, "Observe fan-out benchmark");
+AUTOSTART_PROCESSES(&observe_fanout_bench_process);
+/*---------------------------------------------------------------------------*/
+static uint64_t
+cpu_time_ns(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+/*---------------------------------------------------------------------------*/
+static void
+observe(coap_resource_t *resource, const char *url, uint16_t id)
+{
+  coap_message_t request[1];
+  coap_message_t response[1];
+  coap_endpoint_t endpoint;
+  uint8_t token[2] = { id >> 8, id & 0xff };
+
+  memset(&endpoint, 0, sizeof(endpoint));
+  uip_ip6addr(&endpoint.ipaddr, 0xfd00, 0, 0, 0, 0, 0, 0, 0x100 + id);
+  endpoint.port = UIP_HTONS(COAP_DEFAULT_PORT);
+
+  coap_init_message(request, COAP_TYPE_CON, COAP_GET, id);
+  coap_set_token(request, token, sizeof(token));
+  coap_set_header_uri_path(request, url);
+  coap_set_header_observe(request, 0);
+  request->src_ep = &endpoint;
+  coap_init_message(response, COAP_TYPE_ACK, CONTENT_2_05, id);
+
+  coap_observe_handler(resource, request, response);
+  if(response->code != CONTENT_2_05) {
+    printf("Observer %u of /%s refused\n", id, url);
+    failures++;
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+check_notify(coap_resource_t *resource, const char *subpath, int observers)
+{
+  uint32_t sent = uip_stat.udp.sent;
+
+  renders = 0;
+  coap_notify_observers_sub(resource, subpath);
+  if(renders != 1 || uip_stat.udp.sent - sent != observers) {
+    printf("Notification of /%s%s: %d renders, %lu sent, expected 1, %d\n",
+           resource->url, subpath != NULL ? subpath : "", renders,
+           (unsigned long)(uip_stat.udp.sent - sent), observers);
+    failures++;
+  }
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(observe_fanout_bench_process, ev, data)
+{
+  uint64_t start;
+  uint32_t sent;
+  int i;
+
+  PROCESS_BEGIN();
+
+  /* Let the CoAP engine open its socket */
+  PROCESS_PAUSE();
+
+  coap_activate_resource(&res_sensor, "sensors/temp");
+  coap_activate_resource(&res_parent, "parent");
+
+  for(i = 0; i < NUM_OBSERVERS - 2 * NUM_SUB_OBSERVERS; i++) {
+    observe(&res_sensor, "sensors/temp", i);
+  }
+  for(i = 0; i < NUM_SUB_OBSERVERS; i++) {
+    observe(&res_parent, "parent/a", 1000 + i);
+    observe(&res_parent, "parent/b", 2000 + i);
+  }
+
+  /* Runs through confirmable refreshes, which take transactions */
+  for(i = 0; i < 2 * COAP_OBSERVE_REFRESH_INTERVAL; i++) {
+    check_notify(&res_sensor, NULL, NUM_OBSERVERS - 2 * NUM_SUB_OBSERVERS);
+  }
+  check_notify(&res_parent, NULL, 2 * NUM_SUB_OBSERVERS);
+  check_notify(&res_parent, "/a", NUM_SUB_OBSERVERS);
+  if(!coap_has_observers("sensors/temp")) {
+    printf("Observers of /sensors/temp were dropped\n");
+    failures++;
+  }
+
+  sent = uip_stat.udp.sent;
+  start = cpu_time_ns();
+  for(i = 0; i < NUM_NOTIFICATIONS; i++) {
+    coap_notify_observers(&res_sensor);
+  }
+  printf("Notification to %d observers: %6.1f us, %lu sent\n",
+         NUM_OBSERVERS - 2 * NUM_SUB_OBSERVERS,
+         (double)(cpu_time_ns() - start) / NUM_NOTIFICATIONS / 1000,
+         (unsigned long)(uip_stat.udp.sent - sent));
+
+  printf("Result: %s\n", failures == 0 ? "OK" : "FAIL");
+  exit(failures == 0 ? 0 : 1);
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
@@ -0,0 +1,211 @@
+/*
+ * Copyright (c) 2026, Contiki-NG contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *         Benchmarks the process scheduler on the native target. A bulk
+ *         process keeps the event queue busy while events are posted to
+ *         a high priority process, and counts how many bulk events are
+ *         delivered first. Polls are then timed with many idle
+ *         processes running.
+ */
+
+#include "contiki.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <time.h>
+/*---------------------------------------------------------------------------*/
+#define BULK_BACKLOG    16
+#define NUM_POSTS       1000
+#define MAX_IDLE        1024
+#define NUM_POLLS       20000
+/*---------------------------------------------------------------------------*/
+static process_event_t net_event;
+static process_event_t done_event;
+static int bulk_running;
+static int bulk_inflight;
+static uint32_t bulk_count;
+static uint32_t bulk_posted;
+static uint32_t stamp;
+static uint32_t waited;
+static uint32_t max_waited;
+static int failures;
+/*---------------------------------------------------------------------------*/
+PROCESS(benchmark_process, "Scheduler benchmark");
+PROCESS(bulk_process, "Bulk");
+PROCESS(net_process, "Network");
+AUTOSTART_PROCESSES(&benchmark_process);
+/*---------------------------------------------------------------------------*/
+static uint64_t
+cpu_time_ns(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+/*---------------------------------------------------------------------------*/
+static void
+bulk_post(void)
+{
+  if(process_post(&bulk_process, PROCESS_EVENT_CONTINUE,
+                  (void *)(uintptr_t)bulk_posted) == PROCESS_ERR_OK) {
+    bulk_posted++;
+    bulk_inflight++;
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* Keeps BULK_BACKLOG events queued while running, checks they arrive
+   in the order they were posted */
+PROCESS_THREAD(bulk_process, ev, data)
+{
+  int i;
+
+  PROCESS_BEGIN();
+
+  for(i = 0; i < BULK_BACKLOG; i++) {
+    bulk_post();
+  }
+
+  while(1) {
+    PROCESS_WAIT_EVENT_UNTIL(ev == PROCESS_EVENT_CONTINUE);
+    if((uintptr_t)data != bulk_count) {
+      printf("Bulk event %lu delivered as %lu\n",
+             (unsigned long)(uintptr_t)data, (unsigned long)bulk_count);
+      failures++;
+    }
+    bulk_count++;
+    bulk_inflight--;
+    if(bulk_running) {
+      bulk_post();
+    }
+  }
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(net_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  while(1) {
+    PROCESS_WAIT_EVENT();
+    if(ev == net_event) {
+      waited += bulk_count - stamp;
+      max_waited = MAX(max_waited, bulk_count - stamp);
+      process_post(&benchmark_process, done_event, NULL);
+    } else if(ev == PROCESS_EVENT_POLL) {
+      process_post(&benchmark_process, done_event, NULL);
+    }
+  }
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
+static PT_THREAD(idle_thread(struct pt *pt, process_event_t ev, process_data_t data))
+{
+  PT_BEGIN(pt);
+  while(1) {
+    PT_YIELD(pt);
+  }
+  PT_END(pt);
+}
+
+static struct process idle_processes[MAX_IDLE];
+static const int idle_counts[] = { 16, MAX_IDLE };
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(benchmark_process, ev, data)
+{
+  static uint64_t start;
+  static int started;
+  static int i;
+  static int n;
+
+  PROCESS_BEGIN();
+
+  printf("Priorities: %s\n", PROCESS_WITH_PRIORITIES ? "on" : "off");
+
+  net_event = process_alloc_event();
+  done_event = process_alloc_event();
+  process_set_priority(&net_process, PROCESS_PRIORITY_HIGH);
+  process_start(&net_process, NULL);
+
+  /* Post to the network process behind a queue of bulk events */
+  bulk_running = 1;
+  process_start(&bulk_process, NULL);
+  for(i = 0; i < NUM_POSTS; i++) {
+    stamp = bulk_count;
+    process_post(&net_process, net_event, NULL);
+    PROCESS_WAIT_EVENT_UNTIL(ev == done_event);
+  }
+  bulk_running = 0;
+  while(bulk_inflight > 0) {
+    PROCESS_PAUSE();
+  }
+  printf("Posted event: %.1f bulk events delivered first (max %lu)\n",
+         (double)waited / NUM_POSTS, (unsigned long)max_waited);
+  if(PROCESS_WITH_PRIORITIES && max_waited > 0) {
+    printf("High priority event waited behind bulk events\n");
+    failures++;
+  }
+#if PROCESS_CONF_STATS
+  printf("Max queued events: %u", process_maxevents);
+#if PROCESS_WITH_PRIORITIES
+  for(i = 0; i < PROCESS_PRIORITY_LEVELS; i++) {
+    printf(", priority %d: %u", i, process_maxevents_priority[i]);
+  }
+#endif /* PROCESS_WITH_PRIORITIES */
+  printf("\n");
+#endif /* PROCESS_CONF_STATS */
+
+  /* Time polls, each one a round trip through the native main loop,
+     with more and more processes running */
+  for(n = 0; n < sizeof(idle_counts) / sizeof(idle_counts[0]); n++) {
+    for(; started < idle_counts[n]; started++) {
+      idle_processes[started].thread = idle_thread;
+      process_start(&idle_processes[started], NULL);
+    }
+    start = cpu_time_ns();
+    for(i = 0; i < NUM_POLLS; i++) {
+      process_poll(&net_process);
+      PROCESS_WAIT_EVENT_UNTIL(ev == done_event);
+    }
+    printf("Poll with %4d idle processes: %7.1f ns\n", started,
+           (double)(cpu_time_ns() - start) / NUM_POLLS);
+  }
+
+  printf("Result: %s\n", failures == 0 ? "OK" : "FAIL");
+  exit(failures == 0 ? 0 : 1);
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
@@ -0,0 +1,265 @@
+/*
+ * Copyright (c) 2026, Contiki-NG contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *         Benchmarks the execution time profiler on the native target.
+ *         Checks the count, minimum, maximum and histogram of probes fed
+ *         with known times and with PROFILE_BEGIN()/PROFILE_END() around
+ *         busy waits, the report and reset of the "profile" shell
+ *         command, and measures the cost of a probe.
+ */
+
+#include "contiki.h"
+#include "sys/profile.h"
+#include "shell.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+/*---------------------------------------------------------------------------*/
+#define NUM_CALLS    1000000
+#define WAIT_US      2000
+#define NUM_WAITS    3
+
+PROFILE_PROBE(known_probe, "bench-known");
+PROFILE_PROBE(wait_probe, "bench-wait");
+PROFILE_PROBE(idle_probe, "bench-idle");
+PROFILE_PROBE(cost_probe, "bench-cost");
+
+/* Times fed to known_probe, and the histogram bin each must land in */
+static const PROFILE_TIME_T known_times[] = {
+  0, 1, 2, 3, 4, 7, 8, 1000, 70000
+};
+static const uint16_t known_bins[PROFILE_HISTOGRAM_BINS] = {
+  [0] = 2, [1] = 2, [2] = 2, [3] = 1, [9] = 1, [PROFILE_HISTOGRAM_BINS - 1] = 1
+};
+#define NUM_KNOWN (sizeof(known_times) / sizeof(known_times[0]))
+
+static char report[4096];
+static size_t report_len;
+static int failures;
+/*---------------------------------------------------------------------------*/
+PROCESS(profile_bench_process, "Profile benchmark");
+AUTOSTART_PROCESSES(&profile_bench_process);
+/*---------------------------------------------------------------------------*/
+static uint64_t
+cpu_time_ns(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+/*---------------------------------------------------------------------------*/
+static void
+check(int ok, const char *what)
+{
+  if(!ok) {
+    printf("Check failed: %s\n", what);
+    failures++;
+  }
+}
+/*---------------------------------------------------------------------------*/
+static int
+is_listed(struct profile_probe *probe)
+{
+  struct profile_probe *p;
+
+  for(p = profile_head(); p != NULL; p = p->next) {
+    if(p == probe) {
+      return 1;
+    }
+  }
+  return 0;
+}
+/*---------------------------------------------------------------------------*/
+static uint32_t
+histogram_sum(struct profile_probe *probe)
+{
+  uint32_t sum = 0;
+  int i;
+
+  for(i = 0; i < PROFILE_HISTOGRAM_BINS; i++) {
+    sum += probe->histogram[i];
+  }
+  return sum;
+}
+/*---------------------------------------------------------------------------*/
+static void
+report_output(const char *str)
+{
+  size_t len = strlen(str);
+
+  if(report_len + len < sizeof(report)) {
+    memcpy(report + report_len, str, len + 1);
+    report_len += len;
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* Run a shell command, its output goes to report */
+static void
+run_command(const char *command)
+{
+  static struct pt pt;
+  char line[32];
+
+  report_len = 0;
+  report[0] = '\0';
+  strncpy(line, command, sizeof(line) - 1);
+  line[sizeof(line) - 1] = '\0';
+  PT_INIT(&pt);
+  while(PT_SCHEDULE(shell_input(&pt, report_output, line)));
+}
+/*---------------------------------------------------------------------------*/
+static void
+check_known(void)
+{
+  uint32_t total = 0;
+  int i;
+
+  check(!is_listed(&known_probe), "probe listed before its first time");
+
+  for(i = 0; i < NUM_KNOWN; i++) {
+    PROFILE_RECORD(known_probe, known_times[i]);
+    total += known_times[i];
+  }
+
+  check(is_listed(&known_probe), "probe listed after its first time");
+  check(known_probe.count == NUM_KNOWN, "known count");
+  check(known_probe.min == 0, "known min");
+  check(known_probe.max == 70000, "known max");
+  check(known_probe.total == total, "known total");
+  check(memcmp(known_probe.histogram, known_bins, sizeof(known_bins)) == 0,
+        "known histogram bins");
+
+  /* A full bin saturates rather than wraps */
+  for(i = 0; i <= UINT16_MAX; i++) {
+    PROFILE_RECORD(idle_probe, 5);
+  }
+  check(idle_probe.histogram[2] == UINT16_MAX, "histogram bin saturates");
+  check(idle_probe.count == UINT16_MAX + 1, "count past a full bin");
+}
+/*---------------------------------------------------------------------------*/
+static void
+check_begin_end(void)
+{
+  PROFILE_TIME_T start;
+  int i;
+
+  for(i = 0; i < NUM_WAITS; i++) {
+    PROFILE_BEGIN(wait_probe);
+    start = PROFILE_NOW();
+    while((PROFILE_TIME_T)(PROFILE_NOW() - start) < WAIT_US);
+    PROFILE_END(wait_probe);
+  }
+
+  check(wait_probe.count == NUM_WAITS, "wait count");
+  check(wait_probe.min >= WAIT_US, "wait min at least the wait");
+  check(wait_probe.max >= wait_probe.min, "wait max at least the min");
+  check(wait_probe.total >= (uint32_t)NUM_WAITS * wait_probe.min &&
+        wait_probe.total <= (uint32_t)NUM_WAITS * wait_probe.max,
+        "wait total between count times min and max");
+  check(histogram_sum(&wait_probe) == NUM_WAITS, "wait histogram sum");
+  /* 2000 us is in the bin from 1024 to 2047 us or above */
+  for(i = 0; i < 10; i++) {
+    check(wait_probe.histogram[i] == 0, "wait histogram below the wait");
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+check_shell(void)
+{
+  char line[64];
+  struct profile_probe *p;
+
+  run_command("profile");
+  snprintf(line, sizeof(line), "-- %-16s %8lu %8lu", known_probe.name,
+           (unsigned long)NUM_KNOWN, 0UL);
+  check(strstr(report, line) != NULL, "report has the known probe");
+  check(strstr(report, " <2:2 <4:2 <8:2 <16:1 <1024:1 >=32768:1") != NULL,
+        "report has the known histogram");
+  check(strstr(report, wait_probe.name) != NULL, "report has the wait probe");
+
+  run_command("profile reset");
+  check(strstr(report, "Profile cleared") != NULL, "reset reply");
+
+  /* Probes stay listed, with their times cleared */
+  check(is_listed(&known_probe) && is_listed(&wait_probe), "listed after reset");
+  for(p = profile_head(); p != NULL; p = p->next) {
+    check(p->count == 0 && p->total == 0 && p->min == 0 && p->max == 0 &&
+          histogram_sum(p) == 0, "probe cleared by reset");
+  }
+
+  PROFILE_RECORD(known_probe, 3);
+  check(known_probe.count == 1 && known_probe.min == 3 &&
+        known_probe.max == 3 && known_probe.histogram[1] == 1,
+        "first time after reset");
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(profile_bench_process, ev, data)
+{
+  uint64_t start;
+  uint64_t probe_ns;
+  uint64_t loop_ns;
+  volatile int sink = 0;
+  int i;
+
+  PROCESS_BEGIN();
+
+  check_known();
+  check_begin_end();
+  check_shell();
+
+  start = cpu_time_ns();
+  for(i = 0; i < NUM_CALLS; i++) {
+    sink++;
+  }
+  loop_ns = cpu_time_ns() - start;
+
+  start = cpu_time_ns();
+  for(i = 0; i < NUM_CALLS; i++) {
+    PROFILE_BEGIN(cost_probe);
+    sink++;
+    PROFILE_END(cost_probe);
+  }
+  probe_ns = cpu_time_ns() - start;
+
+  printf("Probe cost: %.1f ns per PROFILE_BEGIN()/PROFILE_END() pair\n",
+         (double)(probe_ns > loop_ns ? probe_ns - loop_ns : 0) / NUM_CALLS);
+  check(cost_probe.count == NUM_CALLS, "cost count");
+
+  printf("Result: %s\n", failures == 0 ? "OK" : "FAIL");
+  exit(failures == 0 ? 0 : 1);
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
@@ -0,0 +1,256 @@
+/*
+ * Copyright (c) 2026, Contiki-NG contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *         Benchmarks uip_ds6_route_lookup() on the native target. The
+ *         routing table is filled with host routes and a few shorter
+ *         prefixes, and lookups are timed at several table sizes. Every
+ *         query is checked against a linear longest-prefix match first.
+ */
+
+#include "contiki.h"
+#include "net/ipv6/uip-ds6.h"
+#include "net/ipv6/uip-ds6-nbr.h"
+#include "net/ipv6/uip-ds6-route.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+/*---------------------------------------------------------------------------*/
+#define NUM_NEXTHOPS   8
+#define NUM_PREFIXES   4
+#define NUM_QUERIES    1024
+#define NUM_LOOKUPS    200000
+/*---------------------------------------------------------------------------*/
+static const int table_sizes[] = { 8, 32, 128, UIP_DS6_ROUTE_NB };
+static uip_ipaddr_t nexthops[NUM_NEXTHOPS];
+static uip_ipaddr_t queries[NUM_QUERIES];
+static uint32_t rand_state = 1;
+static int failures;
+/*---------------------------------------------------------------------------*/
+PROCESS(route_lookup_process, "Route lookup benchmark");
+AUTOSTART_PROCESSES(&route_lookup_process);
+/*---------------------------------------------------------------------------*/
+static uint32_t
+next_rand(void)
+{
+  rand_state = rand_state * 1103515245 + 12345;
+  return rand_state >> 8;
+}
+/*---------------------------------------------------------------------------*/
+static uint64_t
+cpu_time_ns(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+/*---------------------------------------------------------------------------*/
+static void
+host_addr(uip_ipaddr_t *addr, uint16_t i)
+{
+  uip_ip6addr(addr, 0xfd00, 0, 0, 0, 0, 0, 0, i);
+}
+/*---------------------------------------------------------------------------*/
+static void
+add_nexthops(void)
+{
+  uip_lladdr_t lladdr;
+  int i;
+
+  for(i = 0; i < NUM_NEXTHOPS; i++) {
+    memset(&lladdr, 0, sizeof(lladdr));
+    lladdr.addr[sizeof(lladdr) - 1] = i + 1;
+    uip_ip6addr(&nexthops[i], 0xfe80, 0, 0, 0, 0, 0, 0, i + 1);
+    if(uip_ds6_nbr_add(&nexthops[i], &lladdr, 1, NBR_REACHABLE,
+                       NBR_TABLE_REASON_UNDEFINED, NULL) == NULL) {
+      printf("Failed to add neighbor %d\n", i);
+      exit(1);
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+add_route(const uip_ipaddr_t *addr, uint8_t length, int i)
+{
+  if(uip_ds6_route_add(addr, length, &nexthops[i % NUM_NEXTHOPS]) == NULL) {
+    printf("Failed to add route %d\n", i);
+    failures++;
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* fd01:0:0:k::/64 for k = 1..3, fd01::/48, then fd00::i/128 */
+static void
+fill_table(int size)
+{
+  uip_ipaddr_t addr;
+  int i;
+
+  while(uip_ds6_route_head() != NULL) {
+    uip_ds6_route_rm(uip_ds6_route_head());
+  }
+
+  /* uip_ds6_route_add() replaces any route that covers the new one,
+     so add the longer prefixes first */
+  for(i = 1; i < NUM_PREFIXES; i++) {
+    uip_ip6addr(&addr, 0xfd01, 0, 0, i, 0, 0, 0, 0);
+    add_route(&addr, 64, i);
+  }
+  uip_ip6addr(&addr, 0xfd01, 0, 0, 0, 0, 0, 0, 0);
+  add_route(&addr, 48, 0);
+  for(i = 0; i < size - NUM_PREFIXES; i++) {
+    host_addr(&addr, i);
+    add_route(&addr, 128, i);
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* Mostly host routes, some prefixes and some misses */
+static void
+make_queries(int size)
+{
+  int i;
+  uint32_t r;
+
+  for(i = 0; i < NUM_QUERIES; i++) {
+    r = next_rand();
+    switch(r % 10) {
+    case 0:
+      uip_ip6addr(&queries[i], 0xfd01, 0, 0, (r >> 4) % 8, 0, 0, 0, r >> 16);
+      break;
+    case 1:
+      uip_ip6addr(&queries[i], 0xfd02, 0, 0, 0, 0, 0, 0, r >> 16);
+      break;
+    default:
+      host_addr(&queries[i], (r >> 4) % (size - NUM_PREFIXES));
+      break;
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+static uip_ds6_route_t *
+linear_lookup(const uip_ipaddr_t *addr)
+{
+  uip_ds6_route_t *r;
+  uip_ds6_route_t *best = NULL;
+
+  for(r = uip_ds6_route_head(); r != NULL; r = uip_ds6_route_next(r)) {
+    if((best == NULL || r->length > best->length) &&
+       uip_ipaddr_prefixcmp(addr, &r->ipaddr, r->length)) {
+      best = r;
+    }
+  }
+  return best;
+}
+/*---------------------------------------------------------------------------*/
+static void
+check_queries(void)
+{
+  int i;
+
+  for(i = 0; i < NUM_QUERIES; i++) {
+    if(uip_ds6_route_lookup(&queries[i]) != linear_lookup(&queries[i])) {
+      printf("Lookup %d returned the wrong route\n", i);
+      failures++;
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+check_eviction(void)
+{
+  static uip_ipaddr_t used[UIP_DS6_ROUTE_NB];
+  uip_ds6_route_t *r;
+  uip_ipaddr_t addr;
+  int n;
+  int i;
+
+  /* Use every route but fd00::0, which makes it the least recently used.
+     Lookups may reorder the route list, so collect the addresses first. */
+  host_addr(&addr, 0);
+  n = 0;
+  for(r = uip_ds6_route_head(); r != NULL; r = uip_ds6_route_next(r)) {
+    if(!uip_ipaddr_cmp(&r->ipaddr, &addr)) {
+      uip_ipaddr_copy(&used[n++], &r->ipaddr);
+    }
+  }
+  for(i = 0; i < n; i++) {
+    uip_ds6_route_lookup(&used[i]);
+  }
+
+  n = uip_ds6_route_num_routes();
+  host_addr(&addr, 0xffff);
+  add_route(&addr, 128, 0);
+  host_addr(&addr, 0);
+  if(uip_ds6_route_num_routes() != n || uip_ds6_route_lookup(&addr) != NULL) {
+    printf("Eviction dropped the wrong route (%d -> %d routes)\n",
+           n, uip_ds6_route_num_routes());
+    failures++;
+  }
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(route_lookup_process, ev, data)
+{
+  volatile uip_ds6_route_t *sink;
+  uint64_t start;
+  uint64_t elapsed;
+  int s;
+  int i;
+
+  PROCESS_BEGIN();
+
+  printf("Route index: %s\n", UIP_DS6_ROUTE_INDEX ? "on" : "off");
+
+  add_nexthops();
+  for(s = 0; s < sizeof(table_sizes) / sizeof(table_sizes[0]); s++) {
+    fill_table(table_sizes[s]);
+    make_queries(table_sizes[s]);
+    check_queries();
+
+    start = cpu_time_ns();
+    for(i = 0; i < NUM_LOOKUPS; i++) {
+      sink = uip_ds6_route_lookup(&queries[i % NUM_QUERIES]);
+    }
+    elapsed = cpu_time_ns() - start;
+    (void)sink;
+
+    printf("%4d routes: %8.1f ns/lookup\n", uip_ds6_route_num_routes(),
+           (double)elapsed / NUM_LOOKUPS);
+  }
+  check_eviction();
+
+  printf("Result: %s\n", failures == 0 ? "OK" : "FAIL");
+  exit(failures == 0 ? 0 : 1);
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
@@ -0,0 +1,448 @@
+/*
+ * Copyright (c) 2026, Contiki-NG contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *         Checks and benchmarks the TSCH schedule link lookups on the native
+ *         target. Random schedules are built and edited through the schedule
+ *         API, and tsch_schedule_get_next_active_link() and
+ *         tsch_schedule_get_link_by_timeslot() are compared against linear
+ *         scans of the slotframe link lists at random ASNs.
+ *
+ *         TSCH itself does not build for native, so only tsch-schedule.c is
+ *         linked in and the few TSCH and queue functions it calls are
+ *         stubbed below.
+ */
+
+#include "contiki.h"
+#include "net/mac/tsch/tsch.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+/*---------------------------------------------------------------------------*/
+#define NUM_SCHEDULES   2000
+#define NUM_EDITS       64
+#define NUM_QUERIES     32
+#define NUM_NEIGHBORS   4
+#define NUM_LOOKUPS     200000
+/*---------------------------------------------------------------------------*/
+static linkaddr_t neighbors[NUM_NEIGHBORS];
+static struct tsch_neighbor nbr_state[NUM_NEIGHBORS + 1];
+static int nbr_packets[NUM_NEIGHBORS + 1];
+static uint32_t rand_state = 1;
+static int failures;
+/*---------------------------------------------------------------------------*/
+/* Stand-ins for the parts of TSCH that the schedule calls into */
+const linkaddr_t tsch_broadcast_address = { { 0xff, 0xff } };
+struct tsch_link *current_link;
+
+int
+tsch_is_locked(void)
+{
+  return 0;
+}
+
+int
+tsch_get_lock(void)
+{
+  return 1;
+}
+
+void
+tsch_release_lock(void)
+{
+}
+
+/* Neighbor i + 1 has address neighbors[i], slot 0 is the broadcast one */
+static int
+nbr_slot(const linkaddr_t *addr)
+{
+  int i;
+
+  for(i = 0; i < NUM_NEIGHBORS; i++) {
+    if(linkaddr_cmp(addr, &neighbors[i])) {
+      return i + 1;
+    }
+  }
+  return 0;
+}
+
+struct tsch_neighbor *
+tsch_queue_get_nbr(const linkaddr_t *addr)
+{
+  return &nbr_state[nbr_slot(addr)];
+}
+
+struct tsch_neighbor *
+tsch_queue_add_nbr(const linkaddr_t *addr)
+{
+  return tsch_queue_get_nbr(addr);
+}
+
+int
+tsch_queue_nbr_packet_count(const struct tsch_neighbor *n)
+{
+  return nbr_packets[n - nbr_state];
+}
+/*---------------------------------------------------------------------------*/
+PROCESS(tsch_link_lookup_process, "TSCH link lookup benchmark");
+AUTOSTART_PROCESSES(&tsch_link_lookup_process);
+/*---------------------------------------------------------------------------*/
+static uint32_t
+next_rand(void)
+{
+  rand_state = rand_state * 1103515245 + 12345;
+  return rand_state >> 8;
+}
+/*---------------------------------------------------------------------------*/
+static uint64_t
+cpu_time_ns(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+/*---------------------------------------------------------------------------*/
+/* The default link comparator, as used by the schedule */
+static struct tsch_link *
+ref_link_comparator(struct tsch_link *a, struct tsch_link *b)
+{
+  if(!(a->link_options & LINK_OPTION_TX)) {
+    return a;
+  }
+
+  if(!linkaddr_cmp(&a->addr, &b->addr)) {
+    struct tsch_neighbor *an = tsch_queue_get_nbr(&a->addr);
+    struct tsch_neighbor *bn = tsch_queue_get_nbr(&b->addr);
+    int a_packet_count = an ? tsch_queue_nbr_packet_count(an) : 0;
+    int b_packet_count = bn ? tsch_queue_nbr_packet_count(bn) : 0;
+    return a_packet_count >= b_packet_count ? a : b;
+  }
+
+  return a;
+}
+/*---------------------------------------------------------------------------*/
+/* Linear scan over all links of all slotframes, as the schedule did
+ * before it kept a timeslot index */
+static struct tsch_link *
+ref_next_active_link(struct tsch_asn_t *asn, uint16_t *time_offset,
+                     struct tsch_link **backup_link)
+{
+  uint16_t time_to_curr_best = 0;
+  struct tsch_link *curr_best = NULL;
+  struct tsch_link *curr_backup = NULL;
+  struct tsch_slotframe *sf;
+
+  for(sf = tsch_schedule_slotframe_head(); sf != NULL;
+      sf = tsch_schedule_slotframe_next(sf)) {
+    uint16_t timeslot = TSCH_ASN_MOD(*asn, sf->size);
+    struct tsch_link *l;
+
+    for(l = list_head(sf->links_list); l != NULL; l = list_item_next(l)) {
+      uint16_t time_to_timeslot =
+        l->timeslot > timeslot ?
+        l->timeslot - timeslot :
+        sf->size.val + l->timeslot - timeslot;
+      if(curr_best == NULL || time_to_timeslot < time_to_curr_best) {
+        time_to_curr_best = time_to_timeslot;
+        curr_best = l;
+        curr_backup = NULL;
+      } else if(time_to_timeslot == time_to_curr_best) {
+        struct tsch_link *new_best = NULL;
+        if((curr_best->link_options & LINK_OPTION_TX) == (l->link_options & LINK_OPTION_TX)) {
+          if(l->slotframe_handle != curr_best->slotframe_handle) {
+            if(l->slotframe_handle < curr_best->slotframe_handle) {
+              new_best = l;
+            }
+          } else {
+            new_best = ref_link_comparator(curr_best, l);
+          }
+        } else {
+          if(l->link_options & LINK_OPTION_TX) {
+            new_best = l;
+          }
+        }
+
+        if(new_best != l && (l->link_options & LINK_OPTION_RX)) {
+          if(curr_backup == NULL || l->slotframe_handle < curr_backup->slotframe_handle) {
+            curr_backup = l;
+          }
+        }
+        if(new_best != curr_best && (curr_best->link_options & LINK_OPTION_RX)) {
+          if(curr_backup == NULL || curr_best->slotframe_handle < curr_backup->slotframe_handle) {
+            curr_backup = curr_best;
+          }
+        }
+
+        if(new_best != NULL) {
+          curr_best = new_best;
+        }
+      }
+    }
+  }
+
+  *time_offset = time_to_curr_best;
+  *backup_link = curr_backup;
+  return curr_best;
+}
+/*---------------------------------------------------------------------------*/
+static struct tsch_link *
+ref_link_by_timeslot(struct tsch_slotframe *sf, uint16_t timeslot,
+                     uint16_t channel_offset)
+{
+  struct tsch_link *l;
+
+  for(l = list_head(sf->links_list); l != NULL; l = list_item_next(l)) {
+    if(l->timeslot == timeslot && l->channel_offset == channel_offset) {
+      return l;
+    }
+  }
+  return NULL;
+}
+/*---------------------------------------------------------------------------*/
+static struct tsch_slotframe *
+random_slotframe(void)
+{
+  struct tsch_slotframe *sf;
+  int count = 0;
+  int pick;
+
+  for(sf = tsch_schedule_slotframe_head(); sf != NULL;
+      sf = tsch_schedule_slotframe_next(sf)) {
+    count++;
+  }
+  if(count == 0) {
+    return NULL;
+  }
+  pick = next_rand() % count;
+  for(sf = tsch_schedule_slotframe_head(); pick > 0; pick--) {
+    sf = tsch_schedule_slotframe_next(sf);
+  }
+  return sf;
+}
+/*---------------------------------------------------------------------------*/
+static void
+add_random_slotframe(void)
+{
+  /* Small slotframes make overlapping links common */
+  static const uint16_t sizes[] = { 1, 3, 7, 8, 17, 31, 101 };
+  uint16_t handle = next_rand() % 8;
+
+  if(tsch_schedule_get_slotframe_by_handle(handle) == NULL) {
+    tsch_schedule_add_slotframe(handle,
+                                sizes[next_rand() % (sizeof(sizes) / sizeof(sizes[0]))]);
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+add_random_link(void)
+{
+  static const uint8_t options[] = {
+    LINK_OPTION_TX, LINK_OPTION_RX, LINK_OPTION_TX | LINK_OPTION_RX,
+    LINK_OPTION_TX | LINK_OPTION_SHARED,
+    LINK_OPTION_TX | LINK_OPTION_RX | LINK_OPTION_SHARED
+  };
+  struct tsch_slotframe *sf = random_slotframe();
+  const linkaddr_t *addr;
+
+  if(sf == NULL) {
+    return;
+  }
+  addr = next_rand() % 4 ? &neighbors[next_rand() % NUM_NEIGHBORS] : NULL;
+  /* Without do_remove, several links can share a timeslot and offset */
+  tsch_schedule_add_link(sf, options[next_rand() % sizeof(options)],
+                         LINK_TYPE_NORMAL, addr,
+                         next_rand() % sf->size.val, next_rand() % 2,
+                         next_rand() % 2);
+}
+/*---------------------------------------------------------------------------*/
+static void
+remove_random_link(void)
+{
+  struct tsch_slotframe *sf = random_slotframe();
+  struct tsch_link *l;
+  int count;
+
+  if(sf == NULL || (count = list_length(sf->links_list)) == 0) {
+    return;
+  }
+  count = next_rand() % count;
+  for(l = list_head(sf->links_list); count > 0; count--) {
+    l = list_item_next(l);
+  }
+  tsch_schedule_remove_link(sf, l);
+}
+/*---------------------------------------------------------------------------*/
+static void
+random_schedule(void)
+{
+  int i;
+
+  tsch_schedule_remove_all_slotframes();
+  for(i = 0; i < NUM_EDITS; i++) {
+    uint32_t op = next_rand() % 16;
+    if(op == 0) {
+      add_random_slotframe();
+    } else if(op == 1) {
+      struct tsch_slotframe *sf = random_slotframe();
+      if(sf != NULL && next_rand() % 4 == 0) {
+        tsch_schedule_remove_slotframe(sf);
+      }
+    } else if(op < 6) {
+      remove_random_link();
+    } else {
+      if(tsch_schedule_slotframe_head() == NULL) {
+        add_random_slotframe();
+      }
+      add_random_link();
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+check_schedule(int schedule)
+{
+  struct tsch_asn_t asn;
+  int i;
+
+  for(i = 0; i < NUM_QUERIES; i++) {
+    struct tsch_link *link, *backup, *ref_link, *ref_backup;
+    uint16_t offset = 0, ref_offset = 0;
+    struct tsch_slotframe *sf;
+
+    TSCH_ASN_INIT(asn, next_rand() % 4, next_rand());
+    link = tsch_schedule_get_next_active_link(&asn, &offset, &backup);
+    ref_link = ref_next_active_link(&asn, &ref_offset, &ref_backup);
+    if(link != ref_link || backup != ref_backup ||
+       (link != NULL && offset != ref_offset)) {
+      printf("Schedule %d: next active link mismatch at ASN %02x.%08lx\n",
+             schedule, asn.ms1b, (unsigned long)asn.ls4b);
+      failures++;
+    }
+
+    sf = random_slotframe();
+    if(sf != NULL) {
+      uint16_t timeslot = next_rand() % sf->size.val;
+      uint16_t channel_offset = next_rand() % 2;
+      if(tsch_schedule_get_link_by_timeslot(sf, timeslot, channel_offset) !=
+         ref_link_by_timeslot(sf, timeslot, channel_offset)) {
+        printf("Schedule %d: link by timeslot mismatch at sf %u ts %u\n",
+               schedule, sf->handle, timeslot);
+        failures++;
+      }
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* Give each neighbor a different queue length, so that the link
+ * comparator has something to choose on */
+static void
+fill_queues(void)
+{
+  int i;
+
+  for(i = 0; i < NUM_NEIGHBORS; i++) {
+    neighbors[i].u8[0] = i + 1;
+    nbr_packets[i + 1] = i % 3;
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* Fills every slotframe with links at random timeslots */
+static void
+fill_schedule(int links)
+{
+  struct tsch_slotframe *sf;
+  int i;
+
+  tsch_schedule_remove_all_slotframes();
+  tsch_schedule_add_slotframe(0, 101);
+  tsch_schedule_add_slotframe(1, 397);
+  tsch_schedule_add_slotframe(2, 7);
+  for(i = 0; i < links; i++) {
+    sf = random_slotframe();
+    tsch_schedule_add_link(sf, LINK_OPTION_TX | LINK_OPTION_RX,
+                           LINK_TYPE_NORMAL, &neighbors[i % NUM_NEIGHBORS],
+                           next_rand() % sf->size.val, 0, 1);
+  }
+}
+/*---------------------------------------------------------------------------*/
+static double
+time_lookups(struct tsch_link *(*lookup)(struct tsch_asn_t *, uint16_t *,
+                                         struct tsch_link **))
+{
+  volatile struct tsch_link *sink;
+  struct tsch_link *backup;
+  struct tsch_asn_t asn;
+  uint16_t offset;
+  uint64_t start;
+  int i;
+
+  TSCH_ASN_INIT(asn, 0, 0);
+  start = cpu_time_ns();
+  for(i = 0; i < NUM_LOOKUPS; i++) {
+    sink = lookup(&asn, &offset, &backup);
+    TSCH_ASN_INC(asn, 1);
+  }
+  (void)sink;
+  return (double)(cpu_time_ns() - start) / NUM_LOOKUPS;
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(tsch_link_lookup_process, ev, data)
+{
+  static const int link_counts[] = { 4, 16, 64, TSCH_SCHEDULE_MAX_LINKS };
+  int s;
+
+  PROCESS_BEGIN();
+
+  fill_queues();
+
+  for(s = 0; s < NUM_SCHEDULES; s++) {
+    random_schedule();
+    check_schedule(s);
+  }
+  printf("Checked %d random schedules\n", NUM_SCHEDULES);
+
+  for(s = 0; s < sizeof(link_counts) / sizeof(link_counts[0]); s++) {
+    fill_schedule(link_counts[s]);
+    printf("%4d links: %8.1f ns/lookup indexed, %8.1f ns/lookup linear\n",
+           link_counts[s],
+           time_lookups(tsch_schedule_get_next_active_link),
+           time_lookups(ref_next_active_link));
+  }
+
+  printf("Result: %s\n", failures == 0 ? "OK" : "FAIL");
+  exit(failures == 0 ? 0 : 1);
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
@@ -55,6 +55,7 @@
 #include "services/orchestra/orchestra.h"
 #include "services/shell/serial-shell.h"
 #include "services/simple-energest/simple-energest.h"
+#include "services/energest-trace/energest-trace.h"
 #include "services/tsch-cs/tsch-cs.h"
 #include "services/jamsense/specksense.h"
 
@@ -85,6 +86,10 @@ main(void)
   ctimer_init();
   watchdog_init();
 
+#if LOG_DEFERRED
+  log_deferred_init();
+#endif /* LOG_DEFERRED */
+
   energest_init();
 
 #if STACK_CHECK_ENABLED
@@ -124,6 +129,7 @@ main(void)
   {
     uip_ds6_addr_t *lladdr;
     memcpy(&uip_lladdr.addr, &linkaddr_node_addr, sizeof(uip_lladdr.addr));
+    process_set_priority(&tcpip_process, PROCESS_PRIORITY_HIGH);
     process_start(&tcpip_process, NULL);
 
     lladdr = uip_ds6_get_link_local(-1);
@@ -164,6 +170,10 @@ main(void)
   simple_energest_init();
 #endif /* BUILD_WITH_SIMPLE_ENERGEST */
 
+#if BUILD_WITH_ENERGEST_TRACE
+  energest_trace_init();
+#endif /* BUILD_WITH_ENERGEST_TRACE */
+
 #if BUILD_WITH_TSCH_CS
   /* Initialize the channel selection module */
   tsch_cs_adaptations_init();
@@ -58,6 +58,7 @@
 #define RADIO_H_
 
 #include <stddef.h>
+#include <stdint.h>
 
 /**
  * Each radio has a set of parameters that designate the current
@@ -372,6 +373,32 @@ enum radio_param_e {
    * mandatory.
    */
   RADIO_CONST_MAX_PAYLOAD_LEN,
+
+  /**
+   * Background RSSI capture, of type `radio_rssi_capture_t`.
+   *
+   * Setting this object starts sampling the RSSI of the current channel
+   * every `interval_us` microseconds without CPU involvement between
+   * samples. Samples are stored in `buf`; each time `len` samples are in,
+   * sampling pauses and the driver calls `batch()` from its process. If
+   * `batch()` returns non-zero, capture resumes into the same buffer.
+   *
+   * Capture also ends when the radio is turned off or its channel changes.
+   * In that case `batch()` is called once more, from the driver's process,
+   * with any samples collected so far. A capture in progress can also be
+   * stopped by setting this object with a NULL `src`, which calls `batch()`
+   * before returning. The driver clears `active` after the last `batch()`
+   * call.
+   *
+   * Unlike other objects, the driver keeps a reference to the structure
+   * until the capture ends. The radio must be on when capture starts.
+   * Drivers without background sampling return `RADIO_RESULT_NOT_SUPPORTED`
+   * and callers should fall back to polling `RADIO_PARAM_RSSI`.
+   *
+   * This parameter will only be passed as an argument to the `set_object()`
+   * function.
+   */
+  RADIO_PARAM_RSSI_CAPTURE,
 };
 
 /**
@@ -411,6 +438,23 @@ enum radio_shr_search_e {
   RADIO_SHR_SEARCH_EN = 1,  /**< Enable SHR search or SHR search is enabled */
 };
 
+/*---------------------------------------------------------------------------*/
+/**
+ * Background RSSI capture request, used with `RADIO_PARAM_RSSI_CAPTURE`.
+ */
+typedef struct radio_rssi_capture {
+  int8_t *buf;           /**< Sample buffer, in dBm */
+  uint16_t len;          /**< Samples per batch, the size of `buf` */
+  uint16_t interval_us;  /**< Sampling period */
+
+  /**
+   * Called from the driver's process with a batch of samples. Return
+   * non-zero to keep capturing.
+   */
+  int (* batch)(const int8_t *samples, uint16_t count, void *ptr);
+  void *ptr;             /**< Opaque pointer passed to `batch()` */
+  volatile uint8_t active; /**< Set by the driver while capture runs */
+} radio_rssi_capture_t;
 /*---------------------------------------------------------------------------*/
 /**
  * \name Radio RX mode
@@ -48,11 +48,6 @@
 #define PRINTF(...)
 #endif
 
-#ifdef PROJECT_CONF_PATH
-/* Load the heapmem configuration from a project configuration file. */
-#include PROJECT_CONF_PATH
-#endif
-
 #include <stdint.h>
 #include <string.h>
 
@@ -103,6 +98,33 @@
 #define HEAPMEM_ALIGNMENT sizeof(int)
 #endif /* HEAPMEM_CONF_ALIGNMENT */
 
+/*
+ * The HEAPMEM_CONF_TLSF_SL_LOG2 parameter sets the number of free lists
+ * in each size class of the TLSF allocator to a power of two. More
+ * lists waste less memory when rounding up a request to the next list,
+ * at the cost of RAM for the list heads.
+ */
+#ifdef HEAPMEM_CONF_TLSF_SL_LOG2
+#define TLSF_SL_LOG2 HEAPMEM_CONF_TLSF_SL_LOG2
+#else
+#define TLSF_SL_LOG2 2
+#endif /* HEAPMEM_CONF_TLSF_SL_LOG2 */
+
+#define TLSF_SL_COUNT (1 << TLSF_SL_LOG2)
+
+#if HEAPMEM_WITH_TLSF
+#if HEAPMEM_CLASSES > 32
+#error "HEAPMEM_CONF_CLASSES must be at most 32"
+#endif
+#if TLSF_SL_LOG2 > 4
+#error "HEAPMEM_CONF_TLSF_SL_LOG2 must be at most 4"
+#endif
+#endif /* HEAPMEM_WITH_TLSF */
+
+/* Chunks smaller than this are in size class 0. */
+#define SMALL_CHUNK_LOG2 7
+#define SMALL_CHUNK_SIZE (1 << SMALL_CHUNK_LOG2)
+
 #define ALIGN(size)						\
   (((size) + (HEAPMEM_ALIGNMENT - 1)) & ~(HEAPMEM_ALIGNMENT - 1))
 
@@ -135,6 +157,10 @@
 typedef struct chunk {
   struct chunk *prev;
   struct chunk *next;
+#if HEAPMEM_WITH_TLSF
+  /* The chunk just before this one in the heap, for coalescing. */
+  struct chunk *prev_phys;
+#endif
   size_t size;
   uint8_t flags;
 #if HEAPMEM_DEBUG
@@ -149,7 +175,54 @@ static char heap_base[HEAPMEM_ARENA_SIZE] CC_ALIGN(HEAPMEM_ALIGNMENT);
 static size_t heap_usage;
 
 static chunk_t *first_chunk = (chunk_t *)heap_base;
+#if HEAPMEM_WITH_TLSF
+/* One free list per size class and subclass, and a bit set for each
+   list that is not empty. */
+static chunk_t *free_lists[HEAPMEM_CLASSES][TLSF_SL_COUNT];
+static uint32_t class_bitmap;
+static uint16_t list_bitmap[HEAPMEM_CLASSES];
+static chunk_t *last_chunk;
+#else
 static chunk_t *free_list;
+#endif /* HEAPMEM_WITH_TLSF */
+
+/* log2_floor: Return the index of the highest bit set in a size,
+   by halving the range of bits searched at each step. */
+static unsigned
+log2_floor(size_t size)
+{
+  unsigned bits = 0;
+  unsigned shift;
+
+  for(shift = sizeof(size_t) * 4; shift > 0; shift >>= 1) {
+    if(size >> shift) {
+      size >>= shift;
+      bits += shift;
+    }
+  }
+  return bits;
+}
+
+/* size_class: Return the size class of a chunk size, and its list
+   within the class. */
+static unsigned
+size_class(size_t size, unsigned *list)
+{
+  unsigned bits;
+
+  if(size < SMALL_CHUNK_SIZE) {
+    *list = size / (SMALL_CHUNK_SIZE / TLSF_SL_COUNT);
+    return 0;
+  }
+
+  bits = log2_floor(size);
+  if(bits - (SMALL_CHUNK_LOG2 - 1) >= HEAPMEM_CLASSES) {
+    *list = TLSF_SL_COUNT - 1;
+    return HEAPMEM_CLASSES - 1;
+  }
+  *list = (size >> (bits - TLSF_SL_LOG2)) - TLSF_SL_COUNT;
+  return bits - (SMALL_CHUNK_LOG2 - 1);
+}
 
 /* extend_space: Increases the current footprint used in the heap, and
    returns a pointer to the old end. */
@@ -168,6 +241,195 @@ extend_space(size_t size)
   return old_usage;
 }
 
+#if HEAPMEM_WITH_TLSF
+/* lowest_bit: Return the index of the lowest bit set in a bitmap
+   that is not zero. */
+static unsigned
+lowest_bit(uint32_t bitmap)
+{
+  unsigned bits = 0;
+  unsigned shift;
+
+  for(shift = 16; shift > 0; shift >>= 1) {
+    if((bitmap & (((uint32_t)1 << shift) - 1)) == 0) {
+      bitmap >>= shift;
+      bits += shift;
+    }
+  }
+  return bits;
+}
+
+/* insert_free_chunk: Put a chunk first on the free list of its size. */
+static void
+insert_free_chunk(chunk_t * const chunk)
+{
+  unsigned class, list;
+
+  class = size_class(chunk->size, &list);
+
+  chunk->prev = NULL;
+  chunk->next = free_lists[class][list];
+  if(chunk->next != NULL) {
+    chunk->next->prev = chunk;
+  }
+  free_lists[class][list] = chunk;
+
+  class_bitmap |= (uint32_t)1 << class;
+  list_bitmap[class] |= 1 << list;
+}
+
+/* remove_free_chunk: Take a chunk off the free list of its size. */
+static void
+remove_free_chunk(chunk_t * const chunk)
+{
+  unsigned class, list;
+
+  if(chunk->prev != NULL) {
+    chunk->prev->next = chunk->next;
+  } else {
+    class = size_class(chunk->size, &list);
+    free_lists[class][list] = chunk->next;
+    if(chunk->next == NULL) {
+      list_bitmap[class] &= ~(1 << list);
+      if(list_bitmap[class] == 0) {
+        class_bitmap &= ~((uint32_t)1 << class);
+      }
+    }
+  }
+
+  if(chunk->next != NULL) {
+    chunk->next->prev = chunk->prev;
+  }
+  chunk->next = chunk->prev = NULL;
+}
+
+/* merge_next_chunk: Extend a chunk over the chunk that follows it. */
+static void
+merge_next_chunk(chunk_t * const chunk)
+{
+  chunk->size += sizeof(chunk_t) + NEXT_CHUNK(chunk)->size;
+  if(IS_LAST_CHUNK(chunk)) {
+    last_chunk = chunk;
+  } else {
+    NEXT_CHUNK(chunk)->prev_phys = chunk;
+  }
+}
+
+/* coalesce_chunks: Merge a chunk with the next chunk, if that one is
+   free. Free chunks are merged as soon as they are freed, so there is
+   never more than one to merge. */
+static void
+coalesce_chunks(chunk_t *chunk)
+{
+  if(!IS_LAST_CHUNK(chunk) && CHUNK_FREE(NEXT_CHUNK(chunk))) {
+    remove_free_chunk(NEXT_CHUNK(chunk));
+    merge_next_chunk(chunk);
+  }
+}
+
+/* free_chunk: Mark a chunk as being free, merge it with the free chunks
+   around it, and put it on a free list. */
+static void
+free_chunk(chunk_t *chunk)
+{
+  chunk->flags &= ~CHUNK_FLAG_ALLOCATED;
+
+  coalesce_chunks(chunk);
+  if(chunk->prev_phys != NULL && CHUNK_FREE(chunk->prev_phys)) {
+    chunk = chunk->prev_phys;
+    remove_free_chunk(chunk);
+    merge_next_chunk(chunk);
+  }
+
+  if(IS_LAST_CHUNK(chunk)) {
+    /* Release the chunk back into the wilderness. */
+    last_chunk = chunk->prev_phys;
+    heap_usage -= sizeof(chunk_t) + chunk->size;
+  } else {
+    insert_free_chunk(chunk);
+  }
+}
+
+/*
+ * split_chunk: When allocating a chunk, we may have found one that is
+ * larger than needed, so this function is called to free the rest of
+ * the original chunk.
+ */
+static void
+split_chunk(chunk_t * const chunk, size_t offset)
+{
+  chunk_t *new_chunk;
+
+  offset = ALIGN(offset);
+
+  if(offset + sizeof(chunk_t) < chunk->size) {
+    new_chunk = (chunk_t *)(GET_PTR(chunk) + offset);
+    new_chunk->size = chunk->size - sizeof(chunk_t) - offset;
+    new_chunk->flags = CHUNK_FLAG_ALLOCATED;
+    new_chunk->prev_phys = chunk;
+    chunk->size = offset;
+
+    if(IS_LAST_CHUNK(new_chunk)) {
+      last_chunk = new_chunk;
+    } else {
+      NEXT_CHUNK(new_chunk)->prev_phys = new_chunk;
+    }
+    free_chunk(new_chunk);
+  }
+}
+
+/*
+ * get_free_chunk: Find a free chunk to satisfy an allocation request.
+ *
+ * The size is rounded up to the next free list, so that the first
+ * chunk on any list found through the bitmaps is large enough. Failing
+ * that, the first chunk on the list of the exact size is tried.
+ */
+static chunk_t *
+get_free_chunk(const size_t size)
+{
+  unsigned class, list;
+  uint32_t bitmap;
+  size_t round;
+  chunk_t *chunk;
+
+  if(size < SMALL_CHUNK_SIZE) {
+    round = SMALL_CHUNK_SIZE / TLSF_SL_COUNT - 1;
+  } else {
+    round = ((size_t)1 << (log2_floor(size) - TLSF_SL_LOG2)) - 1;
+  }
+
+  chunk = NULL;
+  class = size_class(size + round, &list);
+  bitmap = list_bitmap[class] & (~0U << list);
+  if(bitmap == 0 && class + 1 < HEAPMEM_CLASSES) {
+    bitmap = class_bitmap & (~(uint32_t)0 << (class + 1));
+    if(bitmap != 0) {
+      class = lowest_bit(bitmap);
+      bitmap = list_bitmap[class];
+    }
+  }
+  if(bitmap != 0) {
+    chunk = free_lists[class][lowest_bit(bitmap)];
+  }
+
+  /* The last class has no upper size limit, so its chunks may be too
+     small, as may be those on the list of the exact size. */
+  if(chunk == NULL || chunk->size < size) {
+    class = size_class(size, &list);
+    chunk = free_lists[class][list];
+    if(chunk == NULL || chunk->size < size) {
+      return NULL;
+    }
+  }
+
+  remove_free_chunk(chunk);
+  chunk->flags |= CHUNK_FLAG_ALLOCATED;
+  split_chunk(chunk, size);
+
+  return chunk;
+}
+#else /* HEAPMEM_WITH_TLSF */
 /* free_chunk: Mark a chunk as being free, and put it on the free list. */
 static void
 free_chunk(chunk_t * const chunk)
@@ -308,6 +570,8 @@ get_free_chunk(const size_t size)
   return best;
 }
 
+#endif /* HEAPMEM_WITH_TLSF */
+
 /*
  * heapmem_alloc: Allocate an object of the specified size, returning
  * a pointer to it in case of success, and NULL in case of failure.
@@ -321,6 +585,9 @@ get_free_chunk(const size_t size)
  *
  * As a last resort, heapmem_alloc() will try to extend the heap
  * space, and thereby create a new chunk available for use.
+ *
+ * With HEAPMEM_CONF_WITH_TLSF, the free chunk is instead taken from
+ * the free lists in bounded time, as described at get_free_chunk().
  */
 void *
 #if HEAPMEM_DEBUG
@@ -345,6 +612,10 @@ heapmem_alloc(size_t size)
       return NULL;
     }
     chunk->size = size;
+#if HEAPMEM_WITH_TLSF
+    chunk->prev_phys = last_chunk;
+    last_chunk = chunk;
+#endif
   }
 
   chunk->flags = CHUNK_FLAG_ALLOCATED;
@@ -500,6 +771,8 @@ void
 heapmem_stats(heapmem_stats_t *stats)
 {
   chunk_t *chunk;
+  unsigned list;
+  size_t wilderness;
 
   memset(stats, 0, sizeof(*stats));
 
@@ -511,10 +784,25 @@ heapmem_stats(heapmem_stats_t *stats)
     } else {
       coalesce_chunks(chunk);
       stats->available += chunk->size;
+      stats->free_chunks++;
+      stats->class_free_chunks[size_class(chunk->size, &list)]++;
+      if(chunk->size > stats->largest_free) {
+        stats->largest_free = chunk->size;
+      }
     }
     stats->overhead += sizeof(chunk_t);
   }
-  stats->available += HEAPMEM_ARENA_SIZE - heap_usage;
+
+  wilderness = HEAPMEM_ARENA_SIZE - heap_usage;
+  if(wilderness > sizeof(chunk_t) &&
+     wilderness - sizeof(chunk_t) > stats->largest_free) {
+    stats->largest_free = wilderness - sizeof(chunk_t);
+  }
+  stats->available += wilderness;
+  if(stats->available > 0) {
+    stats->fragmentation = 100 -
+      (unsigned)((stats->largest_free * 100) / stats->available);
+  }
   stats->footprint = heap_usage;
   stats->chunks = stats->overhead / sizeof(chunk_t);
 }
@@ -45,7 +45,9 @@
  * Each allocated memory object is referred to as a "chunk". The
  * allocator manages free chunks in a double-linked list. While this
  * adds some memory overhead compared to a single-linked list, it
- * improves the performance of list management.
+ * improves the performance of list management. With
+ * HEAPMEM_CONF_WITH_TLSF, the free chunks are instead kept in a list
+ * per size class, which bounds the time taken to allocate and free.
  *
  * Internally, allocated chunks can be retrieved using the pointer to
  * the allocated memory returned by heapmem_alloc() and
@@ -74,14 +76,52 @@
 #ifndef HEAPMEM_H
 #define HEAPMEM_H
 
+#ifdef PROJECT_CONF_PATH
+/* Load the heapmem configuration from a project configuration file. */
+#include PROJECT_CONF_PATH
+#endif
+
 #include <stdlib.h>
 
+/*
+ * The HEAPMEM_CONF_WITH_TLSF parameter selects the two-level
+ * segregated fit allocator. Free chunks are kept in one list per size
+ * class, found through two levels of bitmaps, so that allocation and
+ * deallocation take bounded time and free chunks are coalesced
+ * immediately. By default, a single free list is searched for at most
+ * HEAPMEM_CONF_SEARCH_MAX chunks.
+ */
+#ifdef HEAPMEM_CONF_WITH_TLSF
+#define HEAPMEM_WITH_TLSF HEAPMEM_CONF_WITH_TLSF
+#else
+#define HEAPMEM_WITH_TLSF 0
+#endif /* HEAPMEM_CONF_WITH_TLSF */
+
+/*
+ * The HEAPMEM_CONF_CLASSES parameter sets the number of power-of-two
+ * size classes. Class 0 holds chunks smaller than 128 bytes, and class
+ * n the chunks from 64 << n bytes up to twice that size. The last
+ * class also holds all larger chunks. Both the statistics and the TLSF
+ * free lists are grouped by these classes.
+ */
+#ifdef HEAPMEM_CONF_CLASSES
+#define HEAPMEM_CLASSES HEAPMEM_CONF_CLASSES
+#else
+#define HEAPMEM_CLASSES 12
+#endif /* HEAPMEM_CONF_CLASSES */
+
 typedef struct heapmem_stats {
   size_t allocated;
   size_t overhead;
   size_t available;
   size_t footprint;
   size_t chunks;
+  /* The largest chunk that can be allocated */
+  size_t largest_free;
+  /* Percentage of the available memory outside of the largest chunk */
+  unsigned fragmentation;
+  size_t free_chunks;
+  size_t class_free_chunks[HEAPMEM_CLASSES];
 } heapmem_stats_t;
 
 #if HEAPMEM_DEBUG
@@ -154,8 +194,11 @@ void heapmem_free(void *ptr);
  * This function makes it possible to gain visibility into the internal
  * structure of the heap. One can thus obtain information regarding
  * the amount of memory allocated, overhead used for memory management,
- * and the number of chunks allocated. By using this information, developers
- * can tune their software to use the heapmem allocator more efficiently.
+ * and the number of chunks allocated. The largest allocation that can
+ * succeed, the fragmentation of the available memory, and the number
+ * of free chunks in each size class are also given. By using this
+ * information, developers can tune their software to use the heapmem
+ * allocator more efficiently.
  *
  */
 
@@ -53,13 +53,34 @@ memb_init(struct memb *m)
 {
   memset(m->used, 0, m->num);
   memset(m->mem, 0, m->size * m->num);
+  if(m->freelist != NULL) {
+    m->freelist->free = 0;
+    m->freelist->fresh = 0;
+    m->freelist->count = 0;
+  }
 }
 /*---------------------------------------------------------------------------*/
 void *
 memb_alloc(struct memb *m)
 {
+  struct memb_freelist *fl = m->freelist;
   int i;
 
+  if(fl != NULL) {
+    /* Take the most recently freed block, or one never used before */
+    if(fl->free != 0) {
+      i = fl->free - 1;
+      fl->free = fl->next[i];
+    } else if(fl->fresh < m->num) {
+      i = fl->fresh++;
+    } else {
+      return NULL;
+    }
+    m->used[i] = true;
+    fl->count++;
+    return (void *)((char *)m->mem + (i * m->size));
+  }
+
   for(i = 0; i < m->num; ++i) {
     if(m->used[i] == false) {
       /* If this block was unused, we set the used flag on
@@ -78,23 +99,32 @@ int
 memb_free(struct memb *m, void *ptr)
 {
   int i;
-  char *ptr2;
+  size_t offset;
 
-  /* Walk through the list of blocks and try to find the block to
-     which the pointer "ptr" points to. */
-  ptr2 = (char *)m->mem;
-  for(i = 0; i < m->num; ++i) {
-    if(ptr2 == (char *)ptr) {
-      /* We've found the block to which "ptr" points, so we check the allocation
-         status to detect the double-free error and free the block. */
-      if (m->used[i] == false)
-        return -1;
-      m->used[i] = false;
-      return 0;
-    }
-    ptr2 += m->size;
+  /* Find the block to which the pointer "ptr" points to, it must
+     point to the start of a block. */
+  if(!memb_inmemb(m, ptr)) {
+    return -1;
+  }
+  offset = (char *)ptr - (char *)m->mem;
+  if(offset % m->size != 0) {
+    return -1;
   }
-  return -1;
+  i = offset / m->size;
+
+  /* Check the allocation status to detect the double-free error and
+     free the block. */
+  if(m->used[i] == false) {
+    return -1;
+  }
+  m->used[i] = false;
+
+  if(m->freelist != NULL) {
+    m->freelist->next[i] = m->freelist->free;
+    m->freelist->free = i + 1;
+    m->freelist->count--;
+  }
+  return 0;
 }
 /*---------------------------------------------------------------------------*/
 int
@@ -110,6 +140,10 @@ memb_numfree(struct memb *m)
   int i;
   int num_free = 0;
 
+  if(m->freelist != NULL) {
+    return m->num - m->freelist->count;
+  }
+
   for(i = 0; i < m->num; ++i) {
     if(m->used[i] == false) {
       ++num_free;
@@ -66,6 +66,13 @@
 #include <stdbool.h>
 #include "sys/cc.h"
 
+/* Declare all memory blocks with a free list, see MEMB_FREELIST() */
+#ifdef MEMB_CONF_WITH_FREELIST
+#define MEMB_WITH_FREELIST MEMB_CONF_WITH_FREELIST
+#else
+#define MEMB_WITH_FREELIST 0
+#endif
+
 /**
  * Declare a memory block.
  *
@@ -87,18 +94,60 @@ MEMB(connections, struct connection, 16);
  * \param num The total number of memory chunks in the block.
  *
  */
+#if MEMB_WITH_FREELIST
+#define MEMB(name, structure, num) MEMB_FREELIST(name, structure, num)
+#else /* MEMB_WITH_FREELIST */
 #define MEMB(name, structure, num) \
         static bool CC_CONCAT(name,_memb_used)[num]; \
         static structure CC_CONCAT(name,_memb_mem)[num]; \
         static struct memb name = {sizeof(structure), num, \
                                           CC_CONCAT(name,_memb_used), \
                                           (void *)CC_CONCAT(name,_memb_mem)}
+#endif /* MEMB_WITH_FREELIST */
+
+/**
+ * Declare a memory block with a free list.
+ *
+ * Same as MEMB(), but memb_alloc(), memb_free() and memb_numfree()
+ * run in constant time, at the cost of an extra unsigned short per
+ * block and a struct memb_freelist. Freed blocks are reused first,
+ * most recently freed first.
+ * Defining MEMB_CONF_WITH_FREELIST to 1 makes MEMB() declare all
+ * memory blocks this way.
+ *
+ * \param name The name of the memory block
+ *
+ * \param structure The name of the struct that the memory block holds
+ *
+ * \param num The total number of memory chunks in the block.
+ *
+ */
+#define MEMB_FREELIST(name, structure, num) \
+        static bool CC_CONCAT(name,_memb_used)[num]; \
+        static structure CC_CONCAT(name,_memb_mem)[num]; \
+        static unsigned short CC_CONCAT(name,_memb_next)[num]; \
+        static struct memb_freelist CC_CONCAT(name,_memb_freelist) = \
+          {CC_CONCAT(name,_memb_next)}; \
+        static struct memb name = {sizeof(structure), num, \
+                                          CC_CONCAT(name,_memb_used), \
+                                          (void *)CC_CONCAT(name,_memb_mem), \
+                                          &CC_CONCAT(name,_memb_freelist)}
+
+/* Free list of a MEMB_FREELIST() pool. Block indexes are stored plus
+   one so that an all-zero free list is valid without memb_init(). */
+struct memb_freelist {
+  unsigned short *next;
+  unsigned short free;   /* First freed block + 1, 0 if none */
+  unsigned short fresh;  /* Blocks from here on were never allocated */
+  unsigned short count;  /* Allocated blocks */
+};
 
 struct memb {
   unsigned short size;
   unsigned short num;
   bool *used;
   void *mem;
+  struct memb_freelist *freelist; /* NULL for MEMB() pools */
 };
 
 /**
@@ -165,4 +165,221 @@ coap_send_request(coap_callback_request_state_t *callback_state, coap_endpoint_t
   return progress_request(callback_state);
 }
 /*---------------------------------------------------------------------------*/
+/*- Windowed block-wise transfer --------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+static void window_callback(void *callback_data, coap_message_t *response);
+
+static int
+window_request_block(coap_window_slot_t *slot, uint32_t block)
+{
+  coap_window_request_state_t *state = slot->state;
+  coap_message_t *request = state->request;
+  coap_transaction_t *t;
+
+  request->mid = coap_get_mid();
+  if((t = coap_new_transaction(request->mid, state->remote_endpoint)) == NULL) {
+    return 0;
+  }
+  t->callback = window_callback;
+  t->callback_data = slot;
+
+  coap_set_header_block2(request, block, 0, state->block_size);
+  t->message_len = coap_serialize_message(request, t->message);
+
+  slot->transaction = t;
+  slot->block = block;
+  coap_send_transaction(t);
+  LOG_DBG("Requested #%"PRIu32" (MID %u)\n", block, request->mid);
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+void
+coap_cancel_window_request(coap_window_request_state_t *state)
+{
+  int i;
+
+  for(i = 0; i < COAP_BLOCK2_WINDOW; i++) {
+    if(state->slots[i].transaction != NULL) {
+      coap_clear_transaction(state->slots[i].transaction);
+      state->slots[i].transaction = NULL;
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+window_finish(coap_window_request_state_t *state, coap_request_status_t status)
+{
+  /* Requests beyond the last block may still be in flight */
+  coap_cancel_window_request(state);
+  state->status = status;
+  state->callback(state);
+}
+/*---------------------------------------------------------------------------*/
+static void
+window_fill(coap_window_request_state_t *state)
+{
+  uint8_t in_flight = 0;
+  int i;
+
+  for(i = 0; i < state->window; i++) {
+    if(state->slots[i].transaction != NULL) {
+      in_flight++;
+    }
+  }
+
+  for(i = 0; i < state->window; i++) {
+    if(state->next >= state->end || state->next - state->base >= 32) {
+      break;
+    }
+    if(state->slots[i].transaction != NULL) {
+      continue;
+    }
+    if(!window_request_block(&state->slots[i], state->next)) {
+      if(in_flight == 0) {
+        LOG_WARN("Could not allocate transaction buffer\n");
+        window_finish(state, COAP_REQUEST_STATUS_BLOCK_ERROR);
+      }
+      /* Retried when an answer frees a transaction */
+      return;
+    }
+    state->slots[i].block_error = 0;
+    state->next++;
+    in_flight++;
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+window_advance(coap_window_request_state_t *state)
+{
+  while(state->received & 1) {
+    state->received >>= 1;
+    state->base++;
+  }
+
+  if(state->base >= state->end) {
+    if(state->last_known) {
+      window_finish(state, COAP_REQUEST_STATUS_FINISHED);
+    } else {
+      /* Every block up to an error says more follow */
+      window_finish(state, COAP_REQUEST_STATUS_BLOCK_ERROR);
+    }
+    return;
+  }
+  window_fill(state);
+}
+/*---------------------------------------------------------------------------*/
+static void
+window_callback(void *callback_data, coap_message_t *response)
+{
+  coap_window_slot_t *slot = (coap_window_slot_t *)callback_data;
+  coap_window_request_state_t *state = slot->state;
+  const uint8_t *payload;
+  uint32_t num = 0;
+  uint8_t more = 0;
+  uint16_t size = state->block_size;
+  uint32_t size2;
+  int len;
+
+  slot->transaction = NULL;
+
+  if(response == NULL) {
+    LOG_WARN("Server not responding giving up...\n");
+    state->code = 0;
+    window_finish(state, COAP_REQUEST_STATUS_TIMEOUT);
+    return;
+  }
+  state->code = response->code;
+
+  if(response->code >= BAD_REQUEST_4_00) {
+    if(slot->block == 0) {
+      window_finish(state, COAP_REQUEST_STATUS_BLOCK_ERROR);
+      return;
+    }
+    /* Most likely a block past the end, requested ahead of time */
+    LOG_DBG("Error %u for #%"PRIu32"\n", response->code, slot->block);
+    state->end = MIN(state->end, slot->block);
+    window_advance(state);
+    return;
+  }
+
+  if(!coap_get_header_block2(response, &num, &more, &size, NULL)
+     && slot->block == 0) {
+    /* The whole representation in one response */
+    more = 0;
+  }
+
+  if(num != slot->block || (num > 0 && size != state->block_size)) {
+    LOG_WARN("WRONG BLOCK %"PRIu32"/%"PRIu32"\n", num, slot->block);
+    if(++(slot->block_error) >= COAP_MAX_ATTEMPTS
+       || !window_request_block(slot, slot->block)) {
+      window_finish(state, COAP_REQUEST_STATUS_BLOCK_ERROR);
+    }
+    return;
+  }
+
+  if(num == 0) {
+    /* The server may have chosen a smaller block size */
+    state->block_size = size;
+    if(coap_get_header_size2(response, &size2) && size2 > 0) {
+      state->end = MIN(state->end, (size2 + size - 1) / size);
+    }
+  }
+
+  if(num < state->base || (state->received & (1UL << (num - state->base)))) {
+    /* Duplicate */
+    window_advance(state);
+    return;
+  }
+
+  len = coap_get_payload(response, &payload);
+  LOG_DBG("Received #%"PRIu32"%s (%d bytes)\n", num, more ? "+" : "", len);
+  if(len > 0) {
+    state->sink(state, num * state->block_size, payload, len);
+    state->size += len;
+  }
+  state->received |= 1UL << (num - state->base);
+  if(!more) {
+    state->end = MIN(state->end, num + 1);
+    state->last_known = 1;
+  }
+  window_advance(state);
+}
+/*---------------------------------------------------------------------------*/
+int
+coap_send_window_request(coap_window_request_state_t *state,
+                         coap_endpoint_t *endpoint,
+                         coap_message_t *request, uint8_t window,
+                         void (*sink)(coap_window_request_state_t *state,
+                                      uint32_t offset,
+                                      const uint8_t *data, uint16_t len),
+                         void (*callback)(coap_window_request_state_t *state))
+{
+  int i;
+
+  memset(state->slots, 0, sizeof(state->slots));
+  for(i = 0; i < COAP_BLOCK2_WINDOW; i++) {
+    state->slots[i].state = state;
+  }
+  state->request = request;
+  state->remote_endpoint = endpoint;
+  state->sink = sink;
+  state->callback = callback;
+  state->status = COAP_REQUEST_STATUS_MORE;
+  state->code = 0;
+  state->window = MAX(1, MIN(window, COAP_BLOCK2_WINDOW));
+  state->block_size = COAP_MAX_CHUNK_SIZE;
+  state->base = 0;
+  state->received = 0;
+  state->end = UINT32_MAX;
+  state->last_known = 0;
+  state->size = 0;
+
+  /* The first block alone, to agree on the block size */
+  if(!window_request_block(&state->slots[0], 0)) {
+    return 0;
+  }
+  state->next = 1;
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
 /** @} */
@@ -72,5 +72,73 @@ int coap_send_request(coap_callback_request_state_t *callback_state, coap_endpoi
                        coap_message_t *request,
                        void (*callback)(coap_callback_request_state_t *callback_state));
 
+/*---------------------------------------------------------------------------*/
+/*- Windowed block-wise transfer --------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+typedef struct coap_window_request_state coap_window_request_state_t;
+
+/* One Block2 request in flight */
+typedef struct {
+  coap_window_request_state_t *state;
+  coap_transaction_t *transaction;
+  uint32_t block;
+  uint8_t block_error;
+} coap_window_slot_t;
+
+struct coap_window_request_state {
+  coap_window_slot_t slots[COAP_BLOCK2_WINDOW];
+  coap_message_t *request;
+  coap_endpoint_t *remote_endpoint;
+  /* Receives each block at its byte offset, in whatever order blocks arrive */
+  void (*sink)(coap_window_request_state_t *state, uint32_t offset,
+               const uint8_t *data, uint16_t len);
+  /* Called once when the transfer completes or fails */
+  void (*callback)(coap_window_request_state_t *state);
+  void *user_data;
+  coap_request_status_t status;
+  uint8_t code;          /* code of the last response, 0 on timeout */
+  uint8_t window;        /* requests kept in flight */
+  uint16_t block_size;
+  uint32_t base;         /* lowest block not received yet */
+  uint32_t received;     /* blocks received from base on, bit 0 = base */
+  uint32_t next;         /* next block to request */
+  uint32_t end;          /* blocks from here on do not exist */
+  uint8_t last_known;    /* a block without the more flag was received */
+  uint32_t size;         /* bytes received so far */
+};
+
+/**
+ * \brief Fetch a resource with block-wise transfer, several blocks at a time
+ * \param state The state of the transfer, which must stay valid until the callback
+ * \param endpoint The destination endpoint
+ * \param request The GET request; it is reused for every block
+ * \param window The number of block requests to keep in flight, at most COAP_BLOCK2_WINDOW
+ * \param sink Receives the payload of each block at its offset
+ * \param callback Called when the transfer is finished or has failed
+ * \return 1 if the first block was requested, 0 otherwise
+ *
+ * The first block is requested alone to learn the block size, and the
+ * total size if the server sends a Size2 option. Block requests then go
+ * out in parallel, each with its own confirmable transaction, so that
+ * the transfer takes about one round trip per window rather than per
+ * block. The status is COAP_REQUEST_STATUS_FINISHED on success,
+ * COAP_REQUEST_STATUS_TIMEOUT if a block went unanswered after
+ * COAP_MAX_ATTEMPTS requests, and COAP_REQUEST_STATUS_BLOCK_ERROR if
+ * the server answered with an error (see code) or inconsistent blocks.
+ */
+int coap_send_window_request(coap_window_request_state_t *state,
+                             coap_endpoint_t *endpoint,
+                             coap_message_t *request, uint8_t window,
+                             void (*sink)(coap_window_request_state_t *state,
+                                          uint32_t offset,
+                                          const uint8_t *data, uint16_t len),
+                             void (*callback)(coap_window_request_state_t *state));
+
+/**
+ * \brief Abort a windowed block-wise transfer without calling its callback
+ * \param state The state of the transfer
+ */
+void coap_cancel_window_request(coap_window_request_state_t *state);
+
 #endif /* COAP_CALLBACK_API_H_ */
 /** @} */
@@ -0,0 +1,222 @@
+/*
+ * Copyright (c) 2026, Contiki-NG contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *      CoCoA congestion control for CoAP (draft-ietf-core-cocoa).
+ */
+
+/**
+ * \addtogroup coap
+ * @{
+ */
+
+#include "coap.h"
+#include "coap-cocoa.h"
+#include "coap-timer.h"
+#include "lib/memb.h"
+#include "lib/list.h"
+#include <inttypes.h>
+#include <string.h>
+
+/* Log configuration */
+#include "coap-log.h"
+#define LOG_MODULE "coap"
+#define LOG_LEVEL  LOG_LEVEL_COAP
+
+#if COAP_WITH_COCOA
+/*---------------------------------------------------------------------------*/
+MEMB(rtt_memb, coap_cocoa_rtt_t, COAP_COCOA_ENDPOINTS);
+/* Most recently updated first */
+LIST(rtt_list);
+/*---------------------------------------------------------------------------*/
+static uint32_t
+now(void)
+{
+  return (uint32_t)coap_timer_uptime();
+}
+/*---------------------------------------------------------------------------*/
+static uint32_t
+clamp_rto(uint32_t rto)
+{
+  if(rto < COAP_COCOA_MIN_RTO) {
+    return COAP_COCOA_MIN_RTO;
+  }
+  if(rto > COAP_COCOA_MAX_RTO) {
+    return COAP_COCOA_MAX_RTO;
+  }
+  return rto;
+}
+/*---------------------------------------------------------------------------*/
+/* RFC 6298 with variance factor k */
+static void
+estimate(coap_cocoa_estimator_t *e, uint32_t rtt, uint8_t k)
+{
+  uint32_t delta;
+
+  if(e->samples == 0) {
+    e->srtt = rtt;
+    e->rttvar = rtt / 2;
+  } else {
+    delta = e->srtt > rtt ? e->srtt - rtt : rtt - e->srtt;
+    e->rttvar = (3 * e->rttvar + delta) / 4;
+    e->srtt = (7 * e->srtt + rtt) / 8;
+  }
+  e->rto = e->srtt + k * e->rttvar;
+  if(e->samples < UINT16_MAX) {
+    e->samples++;
+  }
+}
+/*---------------------------------------------------------------------------*/
+/*
+ * Lets estimates that have not been updated for a while drift back
+ * towards the initial RTO: short ones double every 16 RTOs, long ones
+ * move halfway to 2 s every 4 RTOs.
+ */
+static void
+age(coap_cocoa_rtt_t *r, uint32_t t)
+{
+  uint32_t period;
+
+  for(;;) {
+    if(r->rto < 1000) {
+      period = 16 * r->rto;
+      if(t - r->updated < period) {
+        break;
+      }
+      r->rto = clamp_rto(2 * r->rto);
+    } else if(r->rto > 3000) {
+      period = 4 * r->rto;
+      if(t - r->updated < period) {
+        break;
+      }
+      r->rto = (r->rto + 2000) / 2;
+    } else {
+      break;
+    }
+    r->updated += period;
+  }
+}
+/*---------------------------------------------------------------------------*/
+coap_cocoa_rtt_t *
+coap_cocoa_get(const coap_endpoint_t *ep)
+{
+  coap_cocoa_rtt_t *r;
+
+  for(r = list_head(rtt_list); r; r = r->next) {
+    if(coap_endpoint_cmp(&r->endpoint, ep)) {
+      return r;
+    }
+  }
+  return NULL;
+}
+/*---------------------------------------------------------------------------*/
+coap_cocoa_rtt_t *
+coap_cocoa_head(void)
+{
+  return list_head(rtt_list);
+}
+/*---------------------------------------------------------------------------*/
+coap_cocoa_rtt_t *
+coap_cocoa_next(coap_cocoa_rtt_t *r)
+{
+  return list_item_next(r);
+}
+/*---------------------------------------------------------------------------*/
+uint32_t
+coap_cocoa_get_rto(const coap_endpoint_t *ep)
+{
+  coap_cocoa_rtt_t *r = coap_cocoa_get(ep);
+
+  if(r == NULL) {
+    return COAP_COCOA_INITIAL_RTO;
+  }
+  age(r, now());
+  return r->rto;
+}
+/*---------------------------------------------------------------------------*/
+uint32_t
+coap_cocoa_backoff(uint32_t initial_rto, uint32_t interval)
+{
+  if(initial_rto < 1000) {
+    return 3 * interval;
+  }
+  if(initial_rto > 3000) {
+    return interval + interval / 2;
+  }
+  return 2 * interval;
+}
+/*---------------------------------------------------------------------------*/
+void
+coap_cocoa_update(const coap_endpoint_t *ep, uint32_t rtt,
+                  uint8_t retransmissions)
+{
+  coap_cocoa_rtt_t *r;
+  uint32_t t = now();
+
+  if(retransmissions > 2) {
+    return;
+  }
+
+  r = coap_cocoa_get(ep);
+  if(r != NULL) {
+    list_remove(rtt_list, r);
+    age(r, t);
+  } else {
+    r = memb_alloc(&rtt_memb);
+    if(r == NULL) {
+      /* Replace the endpoint updated least recently */
+      r = list_chop(rtt_list);
+    }
+    memset(r, 0, sizeof(*r));
+    coap_endpoint_copy(&r->endpoint, ep);
+    r->rto = COAP_COCOA_INITIAL_RTO;
+  }
+  list_push(rtt_list, r);
+
+  if(retransmissions == 0) {
+    estimate(&r->strong, rtt, 4);
+    r->rto = (r->strong.rto + r->rto) / 2;
+  } else {
+    estimate(&r->weak, rtt, 1);
+    r->rto = (r->weak.rto + 3 * r->rto) / 4;
+  }
+  r->rto = clamp_rto(r->rto);
+  r->last_rtt = rtt;
+  r->updated = t;
+
+  LOG_DBG("RTT %"PRIu32" ms (%u retransmissions), RTO %"PRIu32" ms to ",
+          rtt, retransmissions, r->rto);
+  LOG_DBG_COAP_EP(ep);
+  LOG_DBG_("\n");
+}
+/*---------------------------------------------------------------------------*/
+#endif /* COAP_WITH_COCOA */
+/** @} */
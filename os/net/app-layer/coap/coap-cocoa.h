@@ -0,0 +1,143 @@
+/*
+ * Copyright (c) 2026, Contiki-NG contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *      CoCoA congestion control for CoAP (draft-ietf-core-cocoa):
+ *      per-endpoint RTT estimation for the retransmission timeout of
+ *      confirmable messages.
+ */
+
+/**
+ * \addtogroup coap
+ * @{
+ */
+
+#ifndef COAP_COCOA_H_
+#define COAP_COCOA_H_
+
+#include "coap-endpoint.h"
+#include <stdint.h>
+
+/* RTO used before an endpoint has been measured, in milliseconds */
+#ifdef COAP_COCOA_CONF_INITIAL_RTO
+#define COAP_COCOA_INITIAL_RTO COAP_COCOA_CONF_INITIAL_RTO
+#else
+#define COAP_COCOA_INITIAL_RTO 2000
+#endif
+
+/* Bounds of the RTO, in milliseconds */
+#ifdef COAP_COCOA_CONF_MIN_RTO
+#define COAP_COCOA_MIN_RTO COAP_COCOA_CONF_MIN_RTO
+#else
+#define COAP_COCOA_MIN_RTO 100
+#endif
+
+#ifdef COAP_COCOA_CONF_MAX_RTO
+#define COAP_COCOA_MAX_RTO COAP_COCOA_CONF_MAX_RTO
+#else
+#define COAP_COCOA_MAX_RTO 32000
+#endif
+
+/* One RFC 6298 estimator; times in milliseconds */
+typedef struct {
+  uint32_t srtt;
+  uint32_t rttvar;
+  uint32_t rto;
+  uint16_t samples;
+} coap_cocoa_estimator_t;
+
+/* RTT state and statistics for one endpoint */
+typedef struct coap_cocoa_rtt {
+  struct coap_cocoa_rtt *next;  /* for LIST */
+
+  coap_endpoint_t endpoint;
+  /* Fed by exchanges answered without retransmission */
+  coap_cocoa_estimator_t strong;
+  /* Fed by exchanges answered after one or two retransmissions */
+  coap_cocoa_estimator_t weak;
+  /* Overall RTO, in milliseconds */
+  uint32_t rto;
+  /* Last RTT sample, in milliseconds */
+  uint32_t last_rtt;
+  /* Uptime of the last update of rto, in milliseconds */
+  uint32_t updated;
+} coap_cocoa_rtt_t;
+
+/**
+ * \brief      Returns the RTO to start an exchange with an endpoint
+ * \param ep   The endpoint
+ * \return     The overall RTO in milliseconds, aged if the endpoint has
+ *             not been measured recently
+ */
+uint32_t coap_cocoa_get_rto(const coap_endpoint_t *ep);
+
+/**
+ * \brief      Applies the variable backoff factor
+ * \param initial_rto The RTO the exchange started with
+ * \param interval The current retransmission interval
+ * \return     The next retransmission interval
+ *
+ * Short initial RTOs back off by a factor of 3, long ones (above 3 s)
+ * by 1.5, and others by 2.
+ */
+uint32_t coap_cocoa_backoff(uint32_t initial_rto, uint32_t interval);
+
+/**
+ * \brief      Feeds an RTT measurement into the estimators of an endpoint
+ * \param ep   The endpoint that answered
+ * \param rtt  The time since the first transmission, in milliseconds
+ * \param retransmissions The number of retransmissions before the answer
+ *
+ * Samples after more than two retransmissions are ambiguous and ignored.
+ */
+void coap_cocoa_update(const coap_endpoint_t *ep, uint32_t rtt,
+                       uint8_t retransmissions);
+
+/**
+ * \brief      Returns the RTT state of an endpoint
+ * \param ep   The endpoint
+ * \return     The state, or NULL if the endpoint has not been measured
+ */
+coap_cocoa_rtt_t *coap_cocoa_get(const coap_endpoint_t *ep);
+
+/**
+ * \brief      Returns the first endpoint with RTT state, most recently
+ *             updated first
+ */
+coap_cocoa_rtt_t *coap_cocoa_head(void);
+
+/**
+ * \brief      Returns the next endpoint with RTT state
+ */
+coap_cocoa_rtt_t *coap_cocoa_next(coap_cocoa_rtt_t *rtt);
+
+#endif /* COAP_COCOA_H_ */
+/** @} */
@@ -93,7 +93,9 @@
 #define COAP_MAX_HEADER_SIZE           (4 + COAP_TOKEN_LEN + 3 + 1 + COAP_ETAG_LEN + 4 + 4 + 30)  /* 65 */
 #endif /* COAP_MAX_HEADER_SIZE */
 
-/* Number of observer slots (each takes abot xxx bytes) */
+/* Number of observer slots (each takes abot xxx bytes). Non-confirmable
+ * notifications need no transaction, so this may exceed
+ * COAP_MAX_OPEN_TRANSACTIONS. */
 #ifndef COAP_MAX_OBSERVERS
 #define COAP_MAX_OBSERVERS    COAP_MAX_OPEN_TRANSACTIONS - 1
 #endif /* COAP_MAX_OBSERVERS */
@@ -112,5 +114,69 @@
 #define COAP_OBSERVER_URL_LEN 20
 #endif
 
+/*
+ * Number of path-segment nodes in the resource dispatch trie. Each
+ * distinct URI path segment of an activated resource takes one node;
+ * the root takes one more. Resources that do not fit are still served
+ * through a linear walk of the resource list. Set to 0 to disable the
+ * trie altogether. At most 255.
+ */
+#ifdef COAP_CONF_RESOURCE_TRIE_NODES
+#define COAP_RESOURCE_TRIE_NODES COAP_CONF_RESOURCE_TRIE_NODES
+#else
+#define COAP_RESOURCE_TRIE_NODES 24
+#endif
+
+/*
+ * Size of the buffer caching the /.well-known/core link-format payload.
+ * The cache is extended as resources are activated and is used for
+ * unfiltered requests only. 0 disables the cache.
+ */
+#ifdef COAP_CONF_WELL_KNOWN_CORE_CACHE_SIZE
+#define COAP_WELL_KNOWN_CORE_CACHE_SIZE COAP_CONF_WELL_KNOWN_CORE_CACHE_SIZE
+#else
+#define COAP_WELL_KNOWN_CORE_CACHE_SIZE 0
+#endif
+
+/*
+ * CoCoA congestion control: derive the retransmission timeout of
+ * confirmable messages from RTT measurements per endpoint instead of
+ * the fixed COAP_RESPONSE_TIMEOUT.
+ */
+#ifdef COAP_CONF_WITH_COCOA
+#define COAP_WITH_COCOA COAP_CONF_WITH_COCOA
+#else
+#define COAP_WITH_COCOA 0
+#endif
+
+/* Number of endpoints whose RTT estimates are kept (least recently
+ * updated ones are replaced) */
+#ifdef COAP_CONF_COCOA_ENDPOINTS
+#define COAP_COCOA_ENDPOINTS COAP_CONF_COCOA_ENDPOINTS
+#else
+#define COAP_COCOA_ENDPOINTS 4
+#endif
+
+/*
+ * NSTART: the number of confirmable messages that may be outstanding
+ * to one endpoint. Further ones are held back and sent, one at a time,
+ * as earlier exchanges complete. 0 disables the limit.
+ */
+#ifdef COAP_CONF_NSTART
+#define COAP_NSTART COAP_CONF_NSTART
+#else
+#define COAP_NSTART 0
+#endif
+
+/*
+ * Number of Block2 requests a windowed block-wise transfer
+ * (coap_send_window_request()) keeps in flight. At most 32.
+ */
+#ifdef COAP_CONF_BLOCK2_WINDOW
+#define COAP_BLOCK2_WINDOW COAP_CONF_BLOCK2_WINDOW
+#else
+#define COAP_BLOCK2_WINDOW 4
+#endif
+
 #endif /* COAP_CONF_H_ */
 /** @} */
@@ -72,6 +72,27 @@ LIST(coap_handlers);
 LIST(coap_resource_services);
 static uint8_t is_initialized = 0;
 
+#if COAP_RESOURCE_TRIE_NODES
+/*
+ * Path-segment trie over the activated resources. Node 0 is the root,
+ * i.e., the empty path; index 0 therefore doubles as "none" in the
+ * child and sibling links. Segments point into the resource URL
+ * strings, which are static.
+ */
+typedef struct {
+  const char *segment;
+  coap_resource_t *resource;
+  uint8_t segment_len;
+  uint8_t child;
+  uint8_t sibling;
+} resource_trie_node_t;
+
+static resource_trie_node_t resource_trie[COAP_RESOURCE_TRIE_NODES];
+static uint8_t resource_trie_used;
+/* Set when a resource did not fit and the trie cannot be trusted alone */
+static uint8_t resource_trie_overflow;
+#endif /* COAP_RESOURCE_TRIE_NODES */
+
 /*---------------------------------------------------------------------------*/
 /*- CoAP service handlers---------------------------------------------------*/
 /*---------------------------------------------------------------------------*/
@@ -312,6 +333,7 @@ coap_receive(const coap_endpoint_t *src,
         coap_resource_response_handler_t callback = transaction->callback;
         void *callback_data = transaction->callback_data;
 
+        coap_transaction_acknowledged(transaction);
         coap_clear_transaction(transaction);
 
         /* check if someone registered for the response */
@@ -379,12 +401,93 @@ coap_engine_init(void)
 
   list_init(coap_handlers);
   list_init(coap_resource_services);
+#if COAP_RESOURCE_TRIE_NODES
+  memset(resource_trie, 0, sizeof(resource_trie));
+  resource_trie_used = 1;
+  resource_trie_overflow = 0;
+#endif /* COAP_RESOURCE_TRIE_NODES */
 
   coap_activate_resource(&res_well_known_core, ".well-known/core");
 
   coap_transport_init();
   coap_init_connection();
 }
+#if COAP_RESOURCE_TRIE_NODES
+/*---------------------------------------------------------------------------*/
+static uint8_t
+resource_trie_child(uint8_t node, const char *segment, int len)
+{
+  uint8_t child;
+
+  for(child = resource_trie[node].child; child != 0;
+      child = resource_trie[child].sibling) {
+    if(resource_trie[child].segment_len == len
+       && memcmp(resource_trie[child].segment, segment, len) == 0) {
+      return child;
+    }
+  }
+  return 0;
+}
+/*---------------------------------------------------------------------------*/
+static void
+resource_trie_insert(coap_resource_t *resource)
+{
+  const char *segment = resource->url;
+  const char *end;
+  uint8_t node = 0;
+  uint8_t child;
+  int len;
+
+  while(*segment != '\0' || node != 0) {
+    end = strchr(segment, '/');
+    len = end != NULL ? end - segment : strlen(segment);
+    if(len > UINT8_MAX) {
+      resource_trie_overflow = 1;
+      return;
+    }
+    child = resource_trie_child(node, segment, len);
+    if(child == 0) {
+      if(resource_trie_used >= COAP_RESOURCE_TRIE_NODES) {
+        if(!resource_trie_overflow) {
+          LOG_WARN("Resource trie full at /%s, dispatching linearly\n",
+                   resource->url);
+        }
+        resource_trie_overflow = 1;
+        return;
+      }
+      child = resource_trie_used++;
+      resource_trie[child].segment = segment;
+      resource_trie[child].segment_len = len;
+      resource_trie[child].sibling = resource_trie[node].child;
+      resource_trie[node].child = child;
+    }
+    node = child;
+    if(end == NULL) {
+      break;
+    }
+    segment = end + 1;
+  }
+
+  /* The first activation of a path wins, as with the list walk */
+  if(resource_trie[node].resource == NULL) {
+    resource_trie[node].resource = resource;
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+resource_trie_rebuild(void)
+{
+  coap_resource_t *resource;
+
+  memset(resource_trie, 0, sizeof(resource_trie));
+  resource_trie_used = 1;
+  resource_trie_overflow = 0;
+  for(resource = list_head(coap_resource_services);
+      resource; resource = resource->next) {
+    resource_trie_insert(resource);
+  }
+}
+#endif /* COAP_RESOURCE_TRIE_NODES */
 /*---------------------------------------------------------------------------*/
 /**
  * \brief Makes a resource available under the given URI path
@@ -399,9 +502,24 @@ void
 coap_activate_resource(coap_resource_t *resource, const char *path)
 {
   coap_periodic_resource_t *periodic;
+  uint8_t reactivated;
+
+  reactivated = list_contains(coap_resource_services, resource);
   resource->url = path;
   list_add(coap_resource_services, resource);
 
+  if(reactivated) {
+    /* The resource moved to the tail and may have a new path */
+#if COAP_RESOURCE_TRIE_NODES
+    resource_trie_rebuild();
+#endif /* COAP_RESOURCE_TRIE_NODES */
+    coap_well_known_core_invalidate();
+  } else {
+#if COAP_RESOURCE_TRIE_NODES
+    resource_trie_insert(resource);
+#endif /* COAP_RESOURCE_TRIE_NODES */
+  }
+
   LOG_INFO("Activating: %s\n", resource->url);
 
   /* Only add periodic resources with a periodic_handler and a period > 0. */
@@ -432,6 +550,79 @@ coap_get_next_resource(coap_resource_t *resource)
   return list_item_next(resource);
 }
 /*---------------------------------------------------------------------------*/
+/* Returns the length of the resource path if it serves url, else -1 */
+static int
+resource_match_len(const coap_resource_t *resource, const char *url,
+                   int url_len)
+{
+  int res_url_len = strlen(resource->url);
+
+  if((url_len == res_url_len
+      || (url_len > res_url_len
+          && (resource->flags & HAS_SUB_RESOURCES)
+          && url[res_url_len] == '/'))
+     && strncmp(resource->url, url, res_url_len) == 0) {
+    return res_url_len;
+  }
+  return -1;
+}
+/*---------------------------------------------------------------------------*/
+coap_resource_t *
+coap_find_resource(const char *url, int url_len)
+{
+  coap_resource_t *resource;
+  coap_resource_t *match = NULL;
+  int match_len = -1;
+  int len;
+#if COAP_RESOURCE_TRIE_NODES
+  const char *end;
+  uint8_t node = 0;
+  int pos = 0;
+
+  if(!resource_trie_overflow) {
+    for(;;) {
+      resource = resource_trie[node].resource;
+      if(pos == url_len && (node != 0 || url_len == 0)) {
+        if(resource != NULL) {
+          return resource;
+        }
+        break;
+      }
+      if(resource != NULL && (resource->flags & HAS_SUB_RESOURCES)
+         && url[pos] == '/') {
+        match = resource;
+      }
+      if(node != 0) {
+        /* Skip the separator that ended the previous segment */
+        pos++;
+      }
+      end = memchr(url + pos, '/', url_len - pos);
+      len = end != NULL ? end - (url + pos) : url_len - pos;
+      node = resource_trie_child(node, url + pos, len);
+      if(node == 0) {
+        break;
+      }
+      pos += len;
+    }
+    return match;
+  }
+#endif /* COAP_RESOURCE_TRIE_NODES */
+
+  /* Linear walk, preferring the longest matching path as the trie does */
+  for(resource = list_head(coap_resource_services);
+      resource; resource = resource->next) {
+    len = resource_match_len(resource, url, url_len);
+    if(len == url_len) {
+      return resource;
+    }
+    if(len > match_len) {
+      match = resource;
+      match_len = len;
+    }
+  }
+  return match;
+}
+/*---------------------------------------------------------------------------*/
 static int
 invoke_coap_resource_service(coap_message_t *request, coap_message_t *response,
                              uint8_t *buffer, uint16_t buffer_size,
@@ -442,44 +633,33 @@ invoke_coap_resource_service(coap_message_t *request, coap_message_t *response,
 
   coap_resource_t *resource = NULL;
   const char *url = NULL;
-  int url_len, res_url_len;
+  int url_len;
 
   url_len = coap_get_header_uri_path(request, &url);
-  for(resource = list_head(coap_resource_services);
-      resource; resource = resource->next) {
-
-    /* if the web service handles that kind of requests and urls matches */
-    res_url_len = strlen(resource->url);
-    if((url_len == res_url_len
-        || (url_len > res_url_len
-            && (resource->flags & HAS_SUB_RESOURCES)
-            && url[res_url_len] == '/'))
-       && strncmp(resource->url, url, res_url_len) == 0) {
-      coap_resource_flags_t method = coap_get_method_type(request);
-      found = 1;
-
-      LOG_INFO("/%s, method %u, resource->flags %u\n", resource->url,
-               (uint16_t)method, resource->flags);
-
-      if((method & METHOD_GET) && resource->get_handler != NULL) {
-        /* call handler function */
-        resource->get_handler(request, response, buffer, buffer_size, offset);
-      } else if((method & METHOD_POST) && resource->post_handler != NULL) {
-        /* call handler function */
-        resource->post_handler(request, response, buffer, buffer_size,
+  resource = coap_find_resource(url, url_len);
+  if(resource != NULL) {
+    coap_resource_flags_t method = coap_get_method_type(request);
+    found = 1;
+
+    LOG_INFO("/%s, method %u, resource->flags %u\n", resource->url,
+             (uint16_t)method, resource->flags);
+
+    if((method & METHOD_GET) && resource->get_handler != NULL) {
+      /* call handler function */
+      resource->get_handler(request, response, buffer, buffer_size, offset);
+    } else if((method & METHOD_POST) && resource->post_handler != NULL) {
+      /* call handler function */
+      resource->post_handler(request, response, buffer, buffer_size, offset);
+    } else if((method & METHOD_PUT) && resource->put_handler != NULL) {
+      /* call handler function */
+      resource->put_handler(request, response, buffer, buffer_size, offset);
+    } else if((method & METHOD_DELETE) && resource->delete_handler != NULL) {
+      /* call handler function */
+      resource->delete_handler(request, response, buffer, buffer_size,
                                offset);
-      } else if((method & METHOD_PUT) && resource->put_handler != NULL) {
-        /* call handler function */
-        resource->put_handler(request, response, buffer, buffer_size, offset);
-      } else if((method & METHOD_DELETE) && resource->delete_handler != NULL) {
-        /* call handler function */
-        resource->delete_handler(request, response, buffer, buffer_size,
-                                 offset);
-      } else {
-        allowed = 0;
-        coap_set_status_code(response, METHOD_NOT_ALLOWED_4_05);
-      }
-      break;
+    } else {
+      allowed = 0;
+      coap_set_status_code(response, METHOD_NOT_ALLOWED_4_05);
     }
   }
   if(!found) {
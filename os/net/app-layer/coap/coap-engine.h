@@ -167,6 +167,24 @@ coap_resource_t *coap_get_first_resource(void);
  */
 coap_resource_t *coap_get_next_resource(coap_resource_t *resource);
 /*---------------------------------------------------------------------------*/
+/**
+ * \brief      Looks up the resource that serves a URI path.
+ * \param url  The URI path, not necessarily null-terminated
+ * \param url_len The length of the URI path
+ * \return     The resource registered for exactly that path, else the
+ *             deepest HAS_SUB_RESOURCES resource whose path is a
+ *             segment prefix of it, or NULL if none matches.
+ */
+coap_resource_t *coap_find_resource(const char *url, int url_len);
+/*---------------------------------------------------------------------------*/
+/**
+ * \brief      Discards the cached /.well-known/core payload.
+ *
+ * Called by the engine when the order of the resource list changes.
+ * Resources appended to the list are picked up without invalidation.
+ */
+void coap_well_known_core_invalidate(void);
+/*---------------------------------------------------------------------------*/
 
 #include "coap-transactions.h"
 #include "coap-observe.h"
@@ -56,12 +56,23 @@
 /*---------------------------------------------------------------------------*/
 MEMB(observers_memb, coap_observer_t, COAP_MAX_OBSERVERS);
 LIST(observers_list);
+
+/*
+ * A notification is rendered once into notification_payload and then
+ * serialized for each observer with its own token, MID and sequence
+ * number. Non-confirmable notifications are sent straight from
+ * notification_buffer, so only the periodic confirmable ones take a
+ * transaction.
+ */
+static uint8_t notification_payload[COAP_MAX_CHUNK_SIZE + 1];
+static uint8_t notification_buffer[COAP_MAX_PACKET_SIZE + 1];
 /*---------------------------------------------------------------------------*/
 /*- Internal API ------------------------------------------------------------*/
 /*---------------------------------------------------------------------------*/
 static coap_observer_t *
-add_observer(const coap_endpoint_t *endpoint, const uint8_t *token,
-             size_t token_len, const char *uri, int uri_len)
+add_observer(coap_resource_t *resource, const coap_endpoint_t *endpoint,
+             const uint8_t *token, size_t token_len,
+             const char *uri, int uri_len)
 {
   /* Remove existing observe relationship, if any. */
   coap_remove_observer_by_uri(endpoint, uri);
@@ -75,6 +86,7 @@ add_observer(const coap_endpoint_t *endpoint, const uint8_t *token,
     }
     memcpy(o->url, uri, max);
     o->url[max] = 0;
+    o->resource = resource;
     coap_endpoint_copy(&o->endpoint, endpoint);
     o->token_len = token_len;
     memcpy(o->token, token, token_len);
@@ -185,6 +197,113 @@ coap_notify_observers(coap_resource_t *resource)
 {
   coap_notify_observers_sub(resource, NULL);
 }
+/*---------------------------------------------------------------------------*/
+static int
+observer_matches(const coap_observer_t *obs, const coap_resource_t *resource,
+                 const char *subpath, const char *url, int url_len,
+                 uint8_t sub_ok)
+{
+  int obs_url_len;
+
+  if(resource != NULL && obs->resource != NULL) {
+    if(obs->resource != resource) {
+      return 0;
+    }
+    if(subpath == NULL) {
+      /* Dispatch already matched the observed URL to this resource */
+      return 1;
+    }
+  }
+
+  /* Do a match based on the parent/sub-resource match so that it is
+     possible to do parent-node observe */
+  obs_url_len = strlen(obs->url);
+  return (obs_url_len == url_len
+          || (obs_url_len > url_len
+              && sub_ok
+              && obs->url[url_len] == '/'))
+         && strncmp(url, obs->url, url_len) == 0;
+}
+/*---------------------------------------------------------------------------*/
+static void
+render_notification(coap_resource_t *resource, const char *url,
+                    coap_message_t *notification)
+{
+  coap_message_t request[1]; /* this way the message can be treated as pointer as usual */
+  int32_t new_offset = 0;
+
+  coap_init_message(notification, COAP_TYPE_NON, CONTENT_2_05, 0);
+  /* create a "fake" request for the URI */
+  coap_init_message(request, COAP_TYPE_CON, COAP_GET, 0);
+  coap_set_header_uri_path(request, url);
+
+  /* Either old style get_handler or the full handler */
+  if(coap_call_handlers(request, notification, notification_payload,
+                        COAP_MAX_CHUNK_SIZE, &new_offset) > 0) {
+    LOG_DBG("Notification on new handlers\n");
+  } else if(resource != NULL && resource->get_handler != NULL) {
+    resource->get_handler(request, notification, notification_payload,
+                          COAP_MAX_CHUNK_SIZE, &new_offset);
+  } else {
+    /* What to do here? */
+    notification->code = BAD_REQUEST_4_00;
+  }
+
+  if(new_offset != 0) {
+    coap_set_header_block2(notification, 0, new_offset != -1,
+                           COAP_MAX_BLOCK_SIZE);
+    coap_set_payload(notification, notification->payload,
+                     MIN(notification->payload_len, COAP_MAX_BLOCK_SIZE));
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+send_notification(coap_observer_t *obs, coap_message_t *notification)
+{
+  coap_transaction_t *transaction = NULL;
+  size_t len;
+
+  notification->type = COAP_TYPE_NON;
+  notification->mid = coap_get_mid();
+
+  /* if COAP_OBSERVE_REFRESH_INTERVAL is zero, never send observations as confirmable messages */
+  if(COAP_OBSERVE_REFRESH_INTERVAL != 0
+     && (obs->obs_counter % COAP_OBSERVE_REFRESH_INTERVAL == 0)) {
+    transaction = coap_new_transaction(notification->mid, &obs->endpoint);
+    if(transaction != NULL) {
+      LOG_DBG("           Force Confirmable for\n");
+      notification->type = COAP_TYPE_CON;
+    } else {
+      LOG_WARN("No transaction for confirmable notification, sending NON\n");
+    }
+  }
+
+  LOG_DBG("           Observer ");
+  LOG_DBG_COAP_EP(&obs->endpoint);
+  LOG_DBG_("\n");
+
+  /* update last MID for RST matching */
+  obs->last_mid = notification->mid;
+
+  if(notification->code < BAD_REQUEST_4_00) {
+    coap_set_header_observe(notification, (obs->obs_counter)++);
+    /* mask out to keep the CoAP observe option length <= 3 bytes */
+    obs->obs_counter &= 0xffffff;
+  }
+  coap_set_token(notification, obs->token, obs->token_len);
+
+  if(transaction != NULL) {
+    transaction->message_len =
+      coap_serialize_message(notification, transaction->message);
+    coap_send_transaction(transaction);
+  } else {
+    len = coap_serialize_message(notification, notification_buffer);
+    if(len > 0) {
+      coap_sendto(&obs->endpoint, notification_buffer, len);
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
 /* Can be used either for sub - or when there is not resource - just
    a handler */
 void
@@ -192,11 +311,11 @@ coap_notify_observers_sub(coap_resource_t *resource, const char *subpath)
 {
   /* build notification */
   coap_message_t notification[1]; /* this way the message can be treated as pointer as usual */
-  coap_message_t request[1]; /* this way the message can be treated as pointer as usual */
   coap_observer_t *obs = NULL;
-  int url_len, obs_url_len;
+  int url_len;
   char url[COAP_OBSERVER_URL_LEN];
   uint8_t sub_ok = 0;
+  uint8_t rendered = 0;
 
   if(resource != NULL) {
     url_len = strlen(resource->url);
@@ -216,92 +335,19 @@ coap_notify_observers_sub(coap_resource_t *resource, const char *subpath)
   /* url now contains the notify URL that needs to match the observer */
   LOG_INFO("Notification from %s\n", url);
 
-  coap_init_message(notification, COAP_TYPE_NON, CONTENT_2_05, 0);
-  /* create a "fake" request for the URI */
-  coap_init_message(request, COAP_TYPE_CON, COAP_GET, 0);
-  coap_set_header_uri_path(request, url);
-
   /* iterate over observers */
   url_len = strlen(url);
   /* Assumes lazy evaluation... */
   sub_ok = (resource == NULL) || (resource->flags & HAS_SUB_RESOURCES);
   for(obs = (coap_observer_t *)list_head(observers_list); obs;
       obs = obs->next) {
-    obs_url_len = strlen(obs->url);
-
-    /* Do a match based on the parent/sub-resource match so that it is
-       possible to do parent-node observe */
-
-    /***** TODO fix here so that we handle the notofication correctly ******/
-    /* All the new-style ... is assuming that the URL might be within */
-    if((obs_url_len == url_len
-        || (obs_url_len > url_len
-            && sub_ok
-            && obs->url[url_len] == '/'))
-       && strncmp(url, obs->url, url_len) == 0) {
-      coap_transaction_t *transaction = NULL;
-
-      /*TODO implement special transaction for CON, sharing the same buffer to allow for more observers */
-
-      if((transaction = coap_new_transaction(coap_get_mid(), &obs->endpoint))) {
-        /* if COAP_OBSERVE_REFRESH_INTERVAL is zero, never send observations as confirmable messages */
-        if(COAP_OBSERVE_REFRESH_INTERVAL != 0
-            && (obs->obs_counter % COAP_OBSERVE_REFRESH_INTERVAL == 0)) {
-          LOG_DBG("           Force Confirmable for\n");
-          notification->type = COAP_TYPE_CON;
-        }
-
-        LOG_DBG("           Observer ");
-        LOG_DBG_COAP_EP(&obs->endpoint);
-        LOG_DBG_("\n");
-
-        /* update last MID for RST matching */
-        obs->last_mid = transaction->mid;
-
-        /* prepare response */
-        notification->mid = transaction->mid;
-
-	int32_t new_offset = 0;
-
-        /* Either old style get_handler or the full handler */
-        if(coap_call_handlers(request, notification, transaction->message +
-                              COAP_MAX_HEADER_SIZE, COAP_MAX_CHUNK_SIZE,
-                              &new_offset) > 0) {
-          LOG_DBG("Notification on new handlers\n");
-        } else {
-          if(resource != NULL) {
-            resource->get_handler(request, notification,
-                                  transaction->message + COAP_MAX_HEADER_SIZE,
-                                  COAP_MAX_CHUNK_SIZE, &new_offset);
-          } else {
-            /* What to do here? */
-            notification->code = BAD_REQUEST_4_00;
-          }
-        }
-
-        if(notification->code < BAD_REQUEST_4_00) {
-          coap_set_header_observe(notification, (obs->obs_counter)++);
-          /* mask out to keep the CoAP observe option length <= 3 bytes */
-          obs->obs_counter &= 0xffffff;
-        }
-        coap_set_token(notification, obs->token, obs->token_len);
-
-	if(new_offset != 0) {
-	  coap_set_header_block2(notification,
-				 0,
-				 new_offset != -1,
-				 COAP_MAX_BLOCK_SIZE);
-	  coap_set_payload(notification,
-			   notification->payload,
-			   MIN(notification->payload_len,
-			       COAP_MAX_BLOCK_SIZE));
-	}
-
-        transaction->message_len =
-          coap_serialize_message(notification, transaction->message);
-
-        coap_send_transaction(transaction);
+    if(observer_matches(obs, resource, subpath, url, url_len, sub_ok)) {
+      /* The representation is the same for all observers */
+      if(!rendered) {
+        render_notification(resource, url, notification);
+        rendered = 1;
       }
+      send_notification(obs, notification);
     }
   }
 }
@@ -321,7 +367,7 @@ coap_observe_handler(coap_resource_t *resource, coap_message_t *coap_req,
       if(src_ep == NULL) {
         /* No source endpoint, can not add */
       } else if(coap_req->observe == 0) {
-        obs = add_observer(src_ep,
+        obs = add_observer(resource, src_ep,
                            coap_req->token, coap_req->token_len,
                            coap_req->uri_path, coap_req->uri_path_len);
         if(obs) {
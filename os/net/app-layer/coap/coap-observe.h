@@ -52,6 +52,7 @@ typedef struct coap_observer {
   struct coap_observer *next;   /* for LIST */
 
   char url[COAP_OBSERVER_URL_LEN];
+  coap_resource_t *resource;    /* resource serving url, NULL if by handler */
   coap_endpoint_t endpoint;
   uint8_t token_len;
   uint8_t token[COAP_TOKEN_LEN];
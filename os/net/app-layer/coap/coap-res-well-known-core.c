@@ -72,6 +72,106 @@
   } \
   strpos += tmplen
 
+#if COAP_WELL_KNOWN_CORE_CACHE_SIZE
+/*
+ * Link-format of the resources up to and including cache_last. The
+ * resource list only grows at its tail, so the cache is extended on
+ * demand rather than rebuilt; the engine invalidates it otherwise.
+ */
+static char cache[COAP_WELL_KNOWN_CORE_CACHE_SIZE];
+static size_t cache_len;
+static coap_resource_t *cache_last;
+static uint8_t cache_overflow;
+#endif /* COAP_WELL_KNOWN_CORE_CACHE_SIZE */
+
+/*---------------------------------------------------------------------------*/
+void
+coap_well_known_core_invalidate(void)
+{
+#if COAP_WELL_KNOWN_CORE_CACHE_SIZE
+  cache_len = 0;
+  cache_last = NULL;
+  cache_overflow = 0;
+#endif /* COAP_WELL_KNOWN_CORE_CACHE_SIZE */
+}
+/*---------------------------------------------------------------------------*/
+#if COAP_WELL_KNOWN_CORE_CACHE_SIZE
+static void
+cache_append(const char *str, size_t len)
+{
+  memcpy(cache + cache_len, str, len);
+  cache_len += len;
+}
+/*---------------------------------------------------------------------------*/
+static int
+cache_update(void)
+{
+  coap_resource_t *resource;
+  size_t url_len;
+  size_t attr_len;
+
+  if(cache_overflow) {
+    return 0;
+  }
+
+  resource = cache_last == NULL ? coap_get_first_resource()
+    : coap_get_next_resource(cache_last);
+  for(; resource; resource = coap_get_next_resource(resource)) {
+    url_len = strlen(resource->url);
+    attr_len = resource->attributes != NULL ? strlen(resource->attributes) : 0;
+    if(cache_len + (cache_len > 0) + url_len + 3 + (attr_len > 0) + attr_len
+       > sizeof(cache)) {
+      LOG_WARN("Link-format cache full, serving /.well-known/core uncached\n");
+      cache_overflow = 1;
+      return 0;
+    }
+
+    if(cache_len > 0) {
+      cache_append(",", 1);
+    }
+    cache_append("</", 2);
+    cache_append(resource->url, url_len);
+    cache_append(">", 1);
+    if(attr_len > 0) {
+      cache_append(";", 1);
+      cache_append(resource->attributes, attr_len);
+    }
+    cache_last = resource;
+  }
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+static int
+cache_get(coap_message_t *response, uint8_t *buffer, uint16_t preferred_size,
+          int32_t *offset)
+{
+  size_t len;
+
+  if(!cache_update()) {
+    return 0;
+  }
+
+  if((size_t)*offset < cache_len) {
+    len = cache_len - *offset;
+    if(len > preferred_size) {
+      len = preferred_size;
+    }
+    memcpy(buffer, cache + *offset, len);
+    coap_set_payload(response, buffer, len);
+    coap_set_header_content_format(response, APPLICATION_LINK_FORMAT);
+  } else if(cache_len > 0) {
+    coap_set_status_code(response, BAD_OPTION_4_02);
+    coap_set_payload(response, "BlockOutOfScope", 15);
+  }
+
+  if((size_t)*offset + preferred_size >= cache_len) {
+    *offset = -1;
+  } else {
+    *offset += preferred_size;
+  }
+  return 1;
+}
+#endif /* COAP_WELL_KNOWN_CORE_CACHE_SIZE */
 /*---------------------------------------------------------------------------*/
 /*- Resource Handlers -------------------------------------------------------*/
 /*---------------------------------------------------------------------------*/
@@ -115,6 +215,17 @@ well_known_core_get_handler(coap_message_t *request, coap_message_t *response,
   }
 #endif /* COAP_LINK_FORMAT_FILTERING */
 
+#if COAP_WELL_KNOWN_CORE_CACHE_SIZE
+#if COAP_LINK_FORMAT_FILTERING
+  if(len == 0)
+#endif /* COAP_LINK_FORMAT_FILTERING */
+  {
+    if(cache_get(response, buffer, preferred_size, offset)) {
+      return;
+    }
+  }
+#endif /* COAP_WELL_KNOWN_CORE_CACHE_SIZE */
+
   for(resource = coap_get_first_resource(); resource;
       resource = coap_get_next_resource(resource)) {
 #if COAP_LINK_FORMAT_FILTERING
@@ -44,6 +44,7 @@
 #include "coap-transactions.h"
 #include "coap-observe.h"
 #include "coap-timer.h"
+#include "coap-cocoa.h"
 #include "lib/memb.h"
 #include "lib/list.h"
 #include <stdlib.h>
@@ -71,6 +72,54 @@ coap_retransmit_transaction(coap_timer_t *nt)
   coap_send_transaction(t);
 }
 /*---------------------------------------------------------------------------*/
+#if COAP_NSTART
+static unsigned
+outstanding_transactions(const coap_endpoint_t *endpoint)
+{
+  coap_transaction_t *t;
+  unsigned count = 0;
+
+  for(t = list_head(transactions_list); t; t = t->next) {
+    if(t->state == COAP_TRANSACTION_OUTSTANDING
+       && coap_endpoint_cmp(&t->endpoint, endpoint)) {
+      count++;
+    }
+  }
+  return count;
+}
+/*---------------------------------------------------------------------------*/
+/* Sends the oldest transaction held back for an endpoint, if any */
+static void
+release_deferred_transaction(const coap_endpoint_t *endpoint)
+{
+  coap_transaction_t *t;
+
+  for(t = list_head(transactions_list); t; t = t->next) {
+    if(t->state == COAP_TRANSACTION_DEFERRED
+       && coap_endpoint_cmp(&t->endpoint, endpoint)) {
+      LOG_DBG("Releasing deferred transaction %u\n", t->mid);
+      t->state = COAP_TRANSACTION_NEW;
+      coap_send_transaction(t);
+      return;
+    }
+  }
+}
+#endif /* COAP_NSTART */
+/*---------------------------------------------------------------------------*/
+static uint32_t
+initial_interval(coap_transaction_t *t)
+{
+#if COAP_WITH_COCOA
+  t->initial_rto = coap_cocoa_get_rto(&t->endpoint);
+  t->send_time = (uint32_t)coap_timer_uptime();
+  /* Dithered between RTO and 1.5 * RTO */
+  return t->initial_rto + (rand() % (t->initial_rto / 2 + 1));
+#else /* COAP_WITH_COCOA */
+  return COAP_RESPONSE_TIMEOUT_TICKS + (rand() %
+                                        COAP_RESPONSE_TIMEOUT_BACKOFF_MASK);
+#endif /* COAP_WITH_COCOA */
+}
+/*---------------------------------------------------------------------------*/
 
 /*---------------------------------------------------------------------------*/
 /*- Internal API ------------------------------------------------------------*/
@@ -83,6 +132,9 @@ coap_new_transaction(uint16_t mid, const coap_endpoint_t *endpoint)
   if(t) {
     t->mid = mid;
     t->retrans_counter = 0;
+#if COAP_NSTART
+    t->state = COAP_TRANSACTION_NEW;
+#endif /* COAP_NSTART */
 
     /* save client address */
     coap_endpoint_copy(&t->endpoint, endpoint);
@@ -100,6 +152,16 @@ coap_send_transaction(coap_transaction_t *t)
 
   if(COAP_TYPE_CON ==
      ((COAP_HEADER_TYPE_MASK & t->message[0]) >> COAP_HEADER_TYPE_POSITION)) {
+#if COAP_NSTART
+    if(t->state != COAP_TRANSACTION_OUTSTANDING) {
+      if(outstanding_transactions(&t->endpoint) >= COAP_NSTART) {
+        LOG_DBG("Deferring transaction %u (NSTART)\n", t->mid);
+        t->state = COAP_TRANSACTION_DEFERRED;
+        return;
+      }
+      t->state = COAP_TRANSACTION_OUTSTANDING;
+    }
+#endif /* COAP_NSTART */
     if(t->retrans_counter <= COAP_MAX_RETRANSMIT) {
       /* not timed out yet */
       coap_sendto(&t->endpoint, t->message, t->message_len);
@@ -108,14 +170,17 @@ coap_send_transaction(coap_transaction_t *t)
       if(t->retrans_counter == 0) {
         coap_timer_set_callback(&t->retrans_timer, coap_retransmit_transaction);
         coap_timer_set_user_data(&t->retrans_timer, t);
-        t->retrans_interval =
-          COAP_RESPONSE_TIMEOUT_TICKS + (rand() %
-                                         COAP_RESPONSE_TIMEOUT_BACKOFF_MASK);
+        t->retrans_interval = initial_interval(t);
         LOG_DBG("Initial interval %lu msec\n",
                 (unsigned long)t->retrans_interval);
       } else {
+#if COAP_WITH_COCOA
+        t->retrans_interval = coap_cocoa_backoff(t->initial_rto,
+                                                 t->retrans_interval);
+#else /* COAP_WITH_COCOA */
         t->retrans_interval <<= 1;  /* double */
-        LOG_DBG("Doubled (%u) interval %lu s\n", t->retrans_counter,
+#endif /* COAP_WITH_COCOA */
+        LOG_DBG("Backed off (%u) interval %lu s\n", t->retrans_counter,
                 (unsigned long)(t->retrans_interval / 1000));
       }
 
@@ -150,10 +215,36 @@ coap_clear_transaction(coap_transaction_t *t)
 
     coap_timer_stop(&t->retrans_timer);
     list_remove(transactions_list, t);
+#if COAP_NSTART
+    if(t->state == COAP_TRANSACTION_OUTSTANDING) {
+      release_deferred_transaction(&t->endpoint);
+    }
+#endif /* COAP_NSTART */
     memb_free(&transactions_memb, t);
   }
 }
 /*---------------------------------------------------------------------------*/
+/* Called when the peer answers t, before t is cleared */
+void
+coap_transaction_acknowledged(coap_transaction_t *t)
+{
+#if COAP_WITH_COCOA
+  if(COAP_TYPE_CON !=
+     ((COAP_HEADER_TYPE_MASK & t->message[0]) >> COAP_HEADER_TYPE_POSITION)) {
+    return;
+  }
+#if COAP_NSTART
+  if(t->state != COAP_TRANSACTION_OUTSTANDING) {
+    /* Held back and never sent */
+    return;
+  }
+#endif /* COAP_NSTART */
+  coap_cocoa_update(&t->endpoint,
+                    (uint32_t)coap_timer_uptime() - t->send_time,
+                    t->retrans_counter);
+#endif /* COAP_WITH_COCOA */
+}
+/*---------------------------------------------------------------------------*/
 coap_transaction_t *
 coap_get_transaction_by_mid(uint16_t mid)
 {
@@ -55,6 +55,13 @@
 #define COAP_RESPONSE_TIMEOUT_TICKS         (1000 * COAP_RESPONSE_TIMEOUT)
 #define COAP_RESPONSE_TIMEOUT_BACKOFF_MASK  (uint32_t)(((1000 * COAP_RESPONSE_TIMEOUT * ((float)COAP_RESPONSE_RANDOM_FACTOR - 1.0)) + 0.5) + 1)
 
+/* Progress of a transaction against the NSTART limit */
+typedef enum {
+  COAP_TRANSACTION_NEW,                 /* not sent yet */
+  COAP_TRANSACTION_OUTSTANDING,         /* confirmable, waiting for a reply */
+  COAP_TRANSACTION_DEFERRED             /* held back by NSTART */
+} coap_transaction_state_t;
+
 /* container for transactions with message buffer and retransmission info */
 typedef struct coap_transaction {
   struct coap_transaction *next;        /* for LIST */
@@ -63,6 +70,13 @@ typedef struct coap_transaction {
   coap_timer_t retrans_timer;
   uint32_t retrans_interval;
   uint8_t retrans_counter;
+#if COAP_NSTART
+  uint8_t state;                        /* see coap_transaction_state_t */
+#endif /* COAP_NSTART */
+#if COAP_WITH_COCOA
+  uint32_t initial_rto;                 /* RTO of the first transmission */
+  uint32_t send_time;                   /* uptime of the first transmission */
+#endif /* COAP_WITH_COCOA */
 
   coap_endpoint_t endpoint;
 
@@ -78,6 +92,7 @@ coap_transaction_t *coap_new_transaction(uint16_t mid, const coap_endpoint_t *ep
 void coap_send_transaction(coap_transaction_t *t);
 void coap_clear_transaction(coap_transaction_t *t);
 coap_transaction_t *coap_get_transaction_by_mid(uint16_t mid);
+void coap_transaction_acknowledged(coap_transaction_t *t);
 
 #endif /* COAP_TRANSACTIONS_H_ */
 /** @} */
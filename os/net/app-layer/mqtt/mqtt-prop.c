@@ -274,7 +274,8 @@ mqtt_prop_decode_input_props(struct mqtt_connection *conn)
   }
 
   DBG("MQTT - Received %i VBI property bytes\n", prop_len_bytes);
-  DBG("MQTT - Input properties length %i\n", conn->in_packet.properties_len);
+  DBG("MQTT - Input properties length %lu\n",
+      (unsigned long)conn->in_packet.properties_len);
 
   /* Total property length = number of bytes to encode length + length of
    * properties themselves
@@ -352,14 +353,15 @@ decode_prop_vbi(struct mqtt_connection *conn,
                 uint8_t *data)
 {
   uint8_t prop_len_bytes;
+  uint32_t val = 0;
 
   DBG("MQTT - Decoding Variable Byte Integer property\n");
 
-  /* All integer input properties will be returned as uint32_t */
-  memset(data, 0, 4);
-
   prop_len_bytes =
-    mqtt_decode_var_byte_int(buf_in, 4, NULL, NULL, (uint16_t *)data);
+    mqtt_decode_var_byte_int(buf_in, 4, NULL, NULL, &val);
+
+  /* All integer input properties will be returned as uint32_t */
+  memcpy(data, &val, sizeof(val));
 
   if(prop_len_bytes == 0) {
     DBG("MQTT - Error decoding Variable Byte Integer\n");
@@ -486,15 +488,15 @@ mqtt_get_next_in_prop(struct mqtt_connection *conn,
 {
   uint32_t prop_len;
   uint8_t prop_id_len_bytes;
-  uint16_t prop_id_decode;
+  uint32_t prop_id_decode = 0;
 
   if(!conn->in_packet.has_props) {
     DBG("MQTT - Message has no input properties");
     return 0;
   }
 
-  DBG("MQTT - Curr prop pos %i; len %i; byte %i\n", (conn->in_packet.curr_props_pos - conn->in_packet.props_start),
-      conn->in_packet.properties_len,
+  DBG("MQTT - Curr prop pos %i; len %lu; byte %i\n", (int)(conn->in_packet.curr_props_pos - conn->in_packet.props_start),
+      (unsigned long)conn->in_packet.properties_len,
       *conn->in_packet.curr_props_pos);
 
   if((conn->in_packet.curr_props_pos - conn->in_packet.props_start)
@@ -506,7 +508,7 @@ mqtt_get_next_in_prop(struct mqtt_connection *conn,
   prop_id_len_bytes =
     mqtt_decode_var_byte_int(conn->in_packet.curr_props_pos,
                              conn->in_packet.properties_len - (conn->in_packet.curr_props_pos - conn->in_packet.props_start),
-                             NULL, NULL, (uint16_t *)&prop_id_decode);
+                             NULL, NULL, &prop_id_decode);
 
   *prop_id = prop_id_decode;
 
@@ -373,16 +373,54 @@ write_bytes(struct mqtt_connection *conn, uint8_t *data, uint16_t len)
   }
 }
 /*---------------------------------------------------------------------------*/
+/*
+ * Lets the payload producer fill the output buffer. Returns 0 when the whole
+ * payload has been written, a positive value when the buffer went out and
+ * must be waited for, and -1 if the producer failed.
+ */
+static int
+write_produced_bytes(struct mqtt_connection *conn)
+{
+  uint16_t space;
+  int produced;
+
+  while(conn->out_write_pos < conn->out_packet.payload_size) {
+    space =
+      MIN(&conn->out_buffer[MQTT_TCP_OUTPUT_BUFF_SIZE] - conn->out_buffer_ptr,
+          conn->out_packet.payload_size - conn->out_write_pos);
+    if(space == 0) {
+      send_out_buffer(conn);
+      return 1;
+    }
+
+    produced = conn->out_packet.producer(conn, conn->out_buffer_ptr, space,
+                                         conn->out_write_pos,
+                                         conn->out_packet.producer_ptr);
+    if(produced <= 0 || produced > space) {
+      return -1;
+    }
+    conn->out_write_pos += produced;
+    conn->out_buffer_ptr += produced;
+
+    DBG("MQTT - (write_produced_bytes) size: %lu write_pos: %lu\n",
+        (unsigned long)conn->out_packet.payload_size,
+        (unsigned long)conn->out_write_pos);
+  }
+
+  conn->out_write_pos = 0;
+  return 0;
+}
+/*---------------------------------------------------------------------------*/
 uint8_t
 mqtt_decode_var_byte_int(const uint8_t *input_data_ptr,
                          int input_data_len,
                          uint32_t *input_pos,
                          uint32_t *pkt_byte_count,
-                         uint16_t *dest)
+                         uint32_t *dest)
 {
   uint8_t read_bytes = 0;
   uint8_t byte_in;
-  uint8_t multiplier = 1;
+  uint32_t multiplier = 1;
   uint32_t input_pos_0 = 0;
 
   if(input_pos == NULL) {
@@ -830,6 +868,8 @@ PT_THREAD(unsubscribe_pt(struct pt *pt, struct mqtt_connection *conn))
 static
 PT_THREAD(publish_pt(struct pt *pt, struct mqtt_connection *conn))
 {
+  int produce_status;
+
   PT_BEGIN(pt);
 
   DBG("MQTT - Sending publish message! topic %s topic_length %i\n",
@@ -891,9 +931,24 @@ PT_THREAD(publish_pt(struct pt *pt, struct mqtt_connection *conn))
 #endif
 
   /* Write Payload */
-  PT_MQTT_WRITE_BYTES(conn,
-                      conn->out_packet.payload,
-                      conn->out_packet.payload_size);
+  if(conn->out_packet.producer != NULL) {
+    conn->out_write_pos = 0;
+    while((produce_status = write_produced_bytes(conn)) > 0) {
+      PT_WAIT_UNTIL(pt, conn->out_buffer_sent);
+    }
+    if(produce_status < 0) {
+      /* The packet cannot be completed, so the stream is out of sync */
+      PRINTF("MQTT - Error, payload producer failed\n");
+      conn->out_write_pos = 0;
+      abort_connection(conn);
+      call_event(conn, MQTT_EVENT_DISCONNECTED, NULL);
+      PT_EXIT(pt);
+    }
+  } else {
+    PT_MQTT_WRITE_BYTES(conn,
+                        conn->out_packet.payload,
+                        conn->out_packet.payload_size);
+  }
 
   send_out_buffer(conn);
   timer_set(&conn->t, RESPONSE_WAIT_TIMEOUT);
@@ -1011,8 +1066,8 @@ handle_connack(struct mqtt_connection *conn)
 
 #if MQTT_PROTOCOL_VERSION <= MQTT_PROTOCOL_VERSION_3_1_1
   if(conn->in_packet.remaining_length != 2) {
-    PRINTF("MQTT - CONNACK VHDR remaining length %i incorrect\n",
-           conn->in_packet.remaining_length);
+    PRINTF("MQTT - CONNACK VHDR remaining length %lu incorrect\n",
+           (unsigned long)conn->in_packet.remaining_length);
     call_event(conn,
                MQTT_EVENT_ERROR,
                NULL);
@@ -1044,8 +1099,8 @@ handle_connack(struct mqtt_connection *conn)
    * 2: Properties (whose Length field must be set even if no properties are present)
    */
   if(conn->in_packet.remaining_length < 3) {
-    PRINTF("MQTT - CONNACK VHDR remaining length %i incorrect\n",
-           conn->in_packet.remaining_length);
+    PRINTF("MQTT - CONNACK VHDR remaining length %lu incorrect\n",
+           (unsigned long)conn->in_packet.remaining_length);
     call_event(conn,
                MQTT_EVENT_ERROR,
                NULL);
@@ -1175,7 +1230,11 @@ handle_publish(struct mqtt_connection *conn)
     PRINTF("MQTT - Error, got incoming PUBLISH with QoS > 0, not supported atm!\n");
   }
 
-  call_event(conn, MQTT_EVENT_PUBLISH, &conn->in_publish_msg);
+  if(conn->publish_stream_callback != NULL) {
+    conn->publish_stream_callback(conn, &conn->in_publish_msg);
+  } else {
+    call_event(conn, MQTT_EVENT_PUBLISH, &conn->in_publish_msg);
+  }
 
   if(conn->in_publish_msg.first_chunk == 1) {
     conn->in_publish_msg.first_chunk = 0;
@@ -1250,6 +1309,131 @@ parse_publish_vhdr(struct mqtt_connection *conn,
   }
 }
 /*---------------------------------------------------------------------------*/
+#if MQTT_5
+/*
+ * Buffers the properties of a streamed PUBLISH, so that they can be decoded
+ * in place like those of any other packet. Returns 1 once all are in.
+ */
+static int
+read_publish_props(struct mqtt_connection *conn,
+                   uint32_t *pos,
+                   const uint8_t *input_data_ptr,
+                   int input_data_len)
+{
+  uint8_t byte_in;
+  uint32_t copy_bytes;
+  uint32_t props_size;
+
+  /* The Property Length is read a byte at a time to find where it ends */
+  while(!conn->in_packet.has_props) {
+    if(*pos >= input_data_len) {
+      return 0;
+    }
+    byte_in = input_data_ptr[(*pos)++];
+    conn->in_packet.byte_counter++;
+    conn->in_packet.payload[conn->in_packet.payload_pos++] = byte_in;
+    if((byte_in & 0x80) == 0) {
+      conn->in_packet.payload_start = conn->in_packet.payload;
+      mqtt_prop_decode_input_props(conn);
+      if(!conn->in_packet.has_props) {
+        return -1;
+      }
+    } else if(conn->in_packet.payload_pos == MQTT_MAX_REMAINING_LENGTH_BYTES) {
+      return -1;
+    }
+  }
+
+  props_size = conn->in_packet.properties_enc_len +
+    conn->in_packet.properties_len;
+  if(props_size > MQTT_INPUT_BUFF_SIZE ||
+     props_size > conn->in_publish_msg.payload_length) {
+    return -1;
+  }
+
+  copy_bytes = MIN(input_data_len - *pos,
+                   props_size - conn->in_packet.payload_pos);
+  memcpy(&conn->in_packet.payload[conn->in_packet.payload_pos],
+         &input_data_ptr[*pos],
+         copy_bytes);
+  conn->in_packet.byte_counter += copy_bytes;
+  conn->in_packet.payload_pos += copy_bytes;
+  *pos += copy_bytes;
+
+  return conn->in_packet.payload_pos == props_size;
+}
+#endif
+/*---------------------------------------------------------------------------*/
+static int
+publish_streaming(struct mqtt_connection *conn)
+{
+  return conn->publish_stream_callback != NULL &&
+         (conn->in_packet.fhdr & 0xF0) == MQTT_FHDR_MSG_TYPE_PUBLISH &&
+         conn->in_packet.topic_received;
+}
+/*---------------------------------------------------------------------------*/
+/*
+ * The rest of a rejected streamed PUBLISH cannot be told apart from the
+ * packets after it, so the connection is dropped and input ignored until
+ * then. The abort itself is left to mqtt_process, as the socket must stay
+ * intact while the segment is being handed to tcp_input().
+ */
+static void
+abort_stream_publish(struct mqtt_connection *conn)
+{
+  reset_packet(&conn->in_packet);
+  conn->state = MQTT_CONN_STATE_ABORT_IMMEDIATE;
+  call_event(conn, MQTT_EVENT_ERROR, NULL);
+  process_post(&mqtt_process, mqtt_abort_now_event, conn);
+}
+/*---------------------------------------------------------------------------*/
+/*
+ * Hands the PUBLISH payload in the current TCP segment to the stream
+ * callback without copying it.
+ */
+static void
+stream_publish(struct mqtt_connection *conn,
+               uint32_t *pos,
+               const uint8_t *input_data_ptr,
+               int input_data_len)
+{
+  uint32_t copy_bytes;
+
+#if MQTT_5
+  if(conn->in_packet.payload_pos == 0 ||
+     conn->in_packet.payload_pos < conn->in_packet.properties_enc_len +
+     conn->in_packet.properties_len) {
+    switch(read_publish_props(conn, pos, input_data_ptr, input_data_len)) {
+    case 0:
+      return;
+    case 1:
+      conn->in_publish_msg.payload_length -= conn->in_packet.payload_pos;
+      conn->in_publish_msg.payload_left = conn->in_publish_msg.payload_length;
+      break;
+    default:
+      PRINTF("MQTT - Error, PUBLISH properties do not fit the input buffer\n");
+      abort_stream_publish(conn);
+      return;
+    }
+  }
+#endif
+
+  copy_bytes = MIN(input_data_len - *pos, conn->in_publish_msg.payload_left);
+  if(copy_bytes == 0 && conn->in_publish_msg.payload_left > 0) {
+    return;
+  }
+
+  conn->in_publish_msg.payload_chunk = (uint8_t *)&input_data_ptr[*pos];
+  conn->in_publish_msg.payload_chunk_length = copy_bytes;
+  conn->in_publish_msg.payload_left -= copy_bytes;
+  conn->in_packet.byte_counter += copy_bytes;
+  *pos += copy_bytes;
+
+  /* This also resets the packet after the last chunk */
+  if(handle_publish(conn) != MQTT_PUBLISH_OK) {
+    abort_stream_publish(conn);
+  }
+}
+/*---------------------------------------------------------------------------*/
 /* MQTTv5 only */
 #if MQTT_5
 static void
@@ -1349,7 +1533,7 @@ tcp_input(struct tcp_socket *s,
   mqtt_pub_status_t pub_status;
   uint8_t remaining_length_bytes;
 
-  if(input_data_len == 0) {
+  if(input_data_len == 0 || conn->state == MQTT_CONN_STATE_ABORT_IMMEDIATE) {
     return 0;
   }
 
@@ -1406,6 +1590,12 @@ tcp_input(struct tcp_socket *s,
     return 0;
   }
 
+  /* The rest of a streamed PUBLISH goes to the app as it is */
+  if(publish_streaming(conn)) {
+    stream_publish(conn, &pos, input_data_ptr, input_data_len);
+    return 0;
+  }
+
   /*
    * Supported payload, reads out both VHDR and Payload of all packets.
    *
@@ -1420,6 +1610,11 @@ tcp_input(struct tcp_socket *s,
       parse_publish_vhdr(conn, &pos, input_data_ptr, input_data_len);
     }
 
+    if(publish_streaming(conn)) {
+      stream_publish(conn, &pos, input_data_ptr, input_data_len);
+      return 0;
+    }
+
     /* Read in as much as we can into the packet payload */
     copy_bytes = MIN(input_data_len - pos,
                      MQTT_INPUT_BUFF_SIZE - conn->in_packet.payload_pos);
@@ -1484,8 +1679,8 @@ tcp_input(struct tcp_socket *s,
   /* Take care of input */
   DBG("MQTT - Finished reading packet!\n");
   /* What to return? */
-  DBG("MQTT - total data was %i bytes of data. \n",
-      (MQTT_FHDR_SIZE + conn->in_packet.remaining_length));
+  DBG("MQTT - total data was %lu bytes of data. \n",
+      (unsigned long)(MQTT_FHDR_SIZE + conn->in_packet.remaining_length));
 
 #if MQTT_5
   if(conn->in_packet.has_reason_code &&
@@ -1975,16 +2170,16 @@ mqtt_unsubscribe(struct mqtt_connection *conn, uint16_t *mid,
   return MQTT_STATUS_OK;
 }
 /*----------------------------------------------------------------------------*/
-mqtt_status_t
-mqtt_publish(struct mqtt_connection *conn, uint16_t *mid, char *topic,
-             uint8_t *payload, uint32_t payload_size,
-             mqtt_qos_level_t qos_level,
+static mqtt_status_t
+publish(struct mqtt_connection *conn, uint16_t *mid, char *topic,
+        uint8_t *payload, mqtt_payload_producer_t producer, void *ptr,
+        uint32_t payload_size, mqtt_qos_level_t qos_level,
 #if MQTT_5
-             mqtt_retain_t retain,
-             uint8_t topic_alias, mqtt_topic_alias_en_t topic_alias_en,
-             struct mqtt_prop_list *prop_list)
+        mqtt_retain_t retain,
+        uint8_t topic_alias, mqtt_topic_alias_en_t topic_alias_en,
+        struct mqtt_prop_list *prop_list)
 #else
-             mqtt_retain_t retain)
+        mqtt_retain_t retain)
 #endif
 {
   if(conn->state != MQTT_CONN_STATE_CONNECTED_TO_BROKER) {
@@ -2021,6 +2216,8 @@ mqtt_publish(struct mqtt_connection *conn, uint16_t *mid, char *topic,
   conn->out_packet.topic_length = strlen(topic);
 #endif
   conn->out_packet.payload = payload;
+  conn->out_packet.producer = producer;
+  conn->out_packet.producer_ptr = ptr;
   conn->out_packet.payload_size = payload_size;
   conn->out_packet.qos = qos_level;
   conn->out_packet.qos_state = MQTT_QOS_STATE_NO_ACK;
@@ -2037,6 +2234,59 @@ mqtt_publish(struct mqtt_connection *conn, uint16_t *mid, char *topic,
   return MQTT_STATUS_OK;
 }
 /*----------------------------------------------------------------------------*/
+mqtt_status_t
+mqtt_publish(struct mqtt_connection *conn, uint16_t *mid, char *topic,
+             uint8_t *payload, uint32_t payload_size,
+             mqtt_qos_level_t qos_level,
+#if MQTT_5
+             mqtt_retain_t retain,
+             uint8_t topic_alias, mqtt_topic_alias_en_t topic_alias_en,
+             struct mqtt_prop_list *prop_list)
+{
+  return publish(conn, mid, topic, payload, NULL, NULL, payload_size,
+                 qos_level, retain, topic_alias, topic_alias_en, prop_list);
+}
+#else
+             mqtt_retain_t retain)
+{
+  return publish(conn, mid, topic, payload, NULL, NULL, payload_size,
+                 qos_level, retain);
+}
+#endif
+/*----------------------------------------------------------------------------*/
+mqtt_status_t
+mqtt_publish_stream(struct mqtt_connection *conn, uint16_t *mid, char *topic,
+                    mqtt_payload_producer_t producer, void *ptr,
+                    uint32_t payload_size, mqtt_qos_level_t qos_level,
+#if MQTT_5
+                    mqtt_retain_t retain,
+                    uint8_t topic_alias, mqtt_topic_alias_en_t topic_alias_en,
+                    struct mqtt_prop_list *prop_list)
+{
+  if(producer == NULL) {
+    return MQTT_STATUS_INVALID_ARGS_ERROR;
+  }
+  return publish(conn, mid, topic, NULL, producer, ptr, payload_size,
+                 qos_level, retain, topic_alias, topic_alias_en, prop_list);
+}
+#else
+                    mqtt_retain_t retain)
+{
+  if(producer == NULL) {
+    return MQTT_STATUS_INVALID_ARGS_ERROR;
+  }
+  return publish(conn, mid, topic, NULL, producer, ptr, payload_size,
+                 qos_level, retain);
+}
+#endif
+/*----------------------------------------------------------------------------*/
+void
+mqtt_set_publish_stream_callback(struct mqtt_connection *conn,
+                                 mqtt_topic_callback_t callback)
+{
+  conn->publish_stream_callback = callback;
+}
+/*----------------------------------------------------------------------------*/
 void
 mqtt_set_username_password(struct mqtt_connection *conn, char *username,
                            char *password)
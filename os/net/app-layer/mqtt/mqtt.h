@@ -125,7 +125,16 @@
 #define MQTT_TCP_INPUT_BUFF_SIZE 512
 #define MQTT_TCP_OUTPUT_BUFF_SIZE 512
 
+/*
+ * Reassembly buffer for incoming packets. PUBLISH payloads that do not fit
+ * are delivered in chunks; with a PUBLISH stream callback registered they
+ * bypass this buffer altogether, so it only has to hold the other packets.
+ */
+#ifdef MQTT_CONF_INPUT_BUFF_SIZE
+#define MQTT_INPUT_BUFF_SIZE MQTT_CONF_INPUT_BUFF_SIZE
+#else
 #define MQTT_INPUT_BUFF_SIZE 512
+#endif
 #define MQTT_MAX_TOPIC_LENGTH 64
 #define MQTT_MAX_TOPICS_PER_SUBSCRIBE 1
 
@@ -415,8 +424,8 @@ struct mqtt_message {
   uint16_t payload_chunk_length;
 
   uint8_t first_chunk;
-  uint16_t payload_length;
-  uint16_t payload_left;
+  uint32_t payload_length;
+  uint32_t payload_left;
 };
 
 /* This struct represents a packet received from the MQTT server. */
@@ -430,7 +439,7 @@ struct mqtt_in_packet {
   uint8_t packet_received;
 
   uint8_t fhdr;
-  uint16_t remaining_length;
+  uint32_t remaining_length;
   uint16_t mid;
 
   /* Helper variables needed to decode the remaining_length */
@@ -458,12 +467,34 @@ struct mqtt_in_packet {
 
   uint8_t has_props;  /* the properties have been decoded */
   uint8_t properties_enc_len;  /* number of bytes used to encode property length */
-  uint16_t properties_len; /* length of properties excluding encoded length */
+  uint32_t properties_len; /* length of properties excluding encoded length */
   uint8_t *props_start;  /* pointer to first byte in first property */
   uint8_t *curr_props_pos;  /* pointer to property to parse next */
 #endif
 };
 
+/**
+ * \brief           MQTT payload producer function
+ * \param m         A pointer to a MQTT connection
+ * \param buf       Where to write the next part of the payload
+ * \param len       The number of bytes wanted, never 0
+ * \param offset    The payload offset of the first byte wanted
+ * \param ptr       The pointer passed to mqtt_publish_stream()
+ * \return          The number of bytes written, 1 to \a len, or -1 on error
+ *
+ * Called by the MQTT engine while a streaming PUBLISH is being sent. \a buf
+ * points straight into the TCP output buffer, so the payload never needs to
+ * exist as a whole in RAM. The producer is called with increasing offsets
+ * until the payload size announced to mqtt_publish_stream() is reached.
+ * Returning an error aborts the connection, as the broker has already been
+ * told the packet length.
+ */
+typedef int (*mqtt_payload_producer_t)(struct mqtt_connection *m,
+                                       uint8_t *buf,
+                                       uint16_t len,
+                                       uint32_t offset,
+                                       void *ptr);
+
 /* This struct represents a packet sent to the MQTT server. */
 struct mqtt_out_packet {
   uint8_t fhdr;
@@ -475,6 +506,8 @@ struct mqtt_out_packet {
   uint16_t topic_length;
   uint8_t *payload;
   uint32_t payload_size;
+  mqtt_payload_producer_t producer;
+  void *producer_ptr;
   mqtt_qos_level_t qos;
   mqtt_qos_state_t qos_state;
   mqtt_retain_t retain;
@@ -557,6 +590,7 @@ struct mqtt_connection {
   uint8_t in_buffer[MQTT_TCP_INPUT_BUFF_SIZE];
   struct mqtt_in_packet in_packet;
   struct mqtt_message in_publish_msg;
+  mqtt_topic_callback_t publish_stream_callback;
 
   /* TCP related information */
   char *server_host;
@@ -714,6 +748,58 @@ mqtt_status_t mqtt_publish(struct mqtt_connection *conn,
                            mqtt_retain_t retain);
 #endif
 /*---------------------------------------------------------------------------*/
+/**
+ * \brief Publish to a MQTT topic, pulling the payload from a producer.
+ * \param conn A pointer to the MQTT connection.
+ * \param mid A pointer to message ID.
+ * \param topic A pointer to the topic to publish to.
+ * \param producer Called to write the payload into the TCP output buffer.
+ * \param ptr An opaque pointer passed to \a producer.
+ * \param payload_size Payload size.
+ * \param qos_level Quality Of Service level to use. Currently supports 0, 1.
+ * \param retain The RETAIN flag, as for mqtt_publish().
+ * \param topic_alias Topic alias to send (MQTTv5-only).
+ * \param topic_alias_en Control whether or not to discard topic and only send
+ *        topic alias s(MQTTv5-only).
+ * \param prop_list Output properties (MQTTv5-only).
+ * \return MQTT_STATUS_OK or some error status
+ *
+ * This function works like mqtt_publish(), but rather than copying from a
+ * payload buffer that the caller keeps around until the message is sent, the
+ * MQTT engine asks \a producer for the payload one TCP buffer at a time. The
+ * payload can thereby be larger than any buffer in the system.
+ */
+mqtt_status_t mqtt_publish_stream(struct mqtt_connection *conn,
+                                  uint16_t *mid,
+                                  char *topic,
+                                  mqtt_payload_producer_t producer,
+                                  void *ptr,
+                                  uint32_t payload_size,
+                                  mqtt_qos_level_t qos_level,
+#if MQTT_5
+                                  mqtt_retain_t retain,
+                                  uint8_t topic_alias,
+                                  mqtt_topic_alias_en_t topic_alias_en,
+                                  struct mqtt_prop_list *prop_list);
+#else
+                                  mqtt_retain_t retain);
+#endif
+/*---------------------------------------------------------------------------*/
+/**
+ * \brief Stream incoming PUBLISH payloads to a callback.
+ * \param conn A pointer to the MQTT connection.
+ * \param callback The callback, or NULL to go back to MQTT_EVENT_PUBLISH.
+ *
+ * With a callback set, incoming PUBLISH payloads are no longer collected in
+ * the input buffer and reported through MQTT_EVENT_PUBLISH. Instead, the
+ * callback is called with each piece of payload as it arrives, pointing
+ * straight into the TCP input buffer. The message's \c first_chunk and
+ * \c payload_left fields tell where the piece belongs; a message with an
+ * empty payload is reported with a single empty chunk.
+ */
+void mqtt_set_publish_stream_callback(struct mqtt_connection *conn,
+                                      mqtt_topic_callback_t callback);
+/*---------------------------------------------------------------------------*/
 /**
  * \brief Set the user name and password for a MQTT client.
  * \param conn A pointer to the MQTT connection.
@@ -769,7 +855,7 @@ uint8_t mqtt_decode_var_byte_int(const uint8_t *input_data_ptr,
                                  int input_data_len,
                                  uint32_t *input_pos,
                                  uint32_t *pkt_byte_count,
-                                 uint16_t *dest);
+                                 uint32_t *dest);
 /*---------------------------------------------------------------------------*/
 /**
  * \brief Send authentication message (MQTTv5-only).
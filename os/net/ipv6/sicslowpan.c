@@ -68,6 +68,7 @@
 #include "net/ipv6/tcpip.h"
 #include "net/ipv6/uip.h"
 #include "net/ipv6/uip-ds6.h"
+#include "net/ipv6/uip-icmp6.h"
 #include "net/ipv6/uipbuf.h"
 #include "net/ipv6/sicslowpan.h"
 #include "net/netstack.h"
@@ -75,12 +76,17 @@
 #include "net/queuebuf.h"
 
 #include "net/routing/routing.h"
+#include "sys/profile.h"
 
 /* Log configuration */
 #include "sys/log.h"
 #define LOG_MODULE "6LoWPAN"
 #define LOG_LEVEL LOG_LEVEL_6LOWPAN
 
+/* Successful header compressions and decompressions */
+PROFILE_PROBE(compress_probe, "6lo-compress");
+PROFILE_PROBE(uncompress_probe, "6lo-uncompress");
+
 #define GET16(ptr,index) (((uint16_t)((ptr)[index] << 8)) | ((ptr)[(index) + 1]))
 #define SET16(ptr,index,value) do {     \
   (ptr)[index] = ((value) >> 8) & 0xff; \
@@ -204,91 +210,183 @@ static uint16_t my_tag;
 
 /** The total length of the IPv6 packet in the sicslowpan_buf. */
 
+/* The size of each fragment (IP payload) for the 6lowpan fragmentation */
+#ifdef SICSLOWPAN_CONF_FRAGMENT_SIZE
+#define SICSLOWPAN_FRAGMENT_SIZE SICSLOWPAN_CONF_FRAGMENT_SIZE
+#else
+/* The default fragment size (110 bytes for 127-2 bytes frames) */
+#define SICSLOWPAN_FRAGMENT_SIZE (127 - 2 - 15)
+#endif
+
+/* Check the selected fragment size, since we use 8-bit integers to handle it. */
+#if SICSLOWPAN_FRAGMENT_SIZE > 255
+#error Too large SICSLOWPAN_FRAGMENT_SIZE set.
+#endif
+
+/* The first fragment is split over buffers at multiples of 8 bytes */
+#define SICSLOWPAN_FRAGMENT_CHUNK (SICSLOWPAN_FRAGMENT_SIZE & ~7)
+
 /* This needs to be defined in NBR / Nodes depending on available RAM   */
-/*   and expected reassembly requirements                               */
+/*   and expected reassembly requirements. The default holds one        */
+/*   datagram of UIP_BUFSIZE bytes, whose uncompressed first fragment   */
+/*   may take one buffer more than its share.                           */
 #ifdef SICSLOWPAN_CONF_FRAGMENT_BUFFERS
 #define SICSLOWPAN_FRAGMENT_BUFFERS SICSLOWPAN_CONF_FRAGMENT_BUFFERS
 #else
-#define SICSLOWPAN_FRAGMENT_BUFFERS 12
+#define SICSLOWPAN_FRAGMENT_BUFFERS \
+  ((UIP_BUFSIZE + SICSLOWPAN_FRAGMENT_CHUNK - 1) / SICSLOWPAN_FRAGMENT_CHUNK + 1)
 #endif
 
 /* REASS_CONTEXTS corresponds to the number of simultaneous
- * reassemblies that can be made. NOTE: the first buffer for each
- * reassembly is stored in the context since it can be larger than the
- * rest of the fragments due to header compression.
+ * reassemblies that can be made. A context only tracks a reassembly;
+ * the fragments themselves, including the first one, are held in the
+ * fragment buffers shared by all contexts. Every reassembly needs at
+ * least two buffers, hence the default.
  **/
 #ifdef SICSLOWPAN_CONF_REASS_CONTEXTS
 #define SICSLOWPAN_REASS_CONTEXTS SICSLOWPAN_CONF_REASS_CONTEXTS
 #else
-#define SICSLOWPAN_REASS_CONTEXTS 2
+#define SICSLOWPAN_REASS_CONTEXTS (SICSLOWPAN_FRAGMENT_BUFFERS / 2)
 #endif
 
-/* The size of each fragment (IP payload) for the 6lowpan fragmentation */
-#ifdef SICSLOWPAN_CONF_FRAGMENT_SIZE
-#define SICSLOWPAN_FRAGMENT_SIZE SICSLOWPAN_CONF_FRAGMENT_SIZE
-#else
-/* The default fragment size (110 bytes for 127-2 bytes frames) */
-#define SICSLOWPAN_FRAGMENT_SIZE (127 - 2 - 15)
+/* Buffers and contexts are linked by 8-bit index, REASS_NONE ends a list */
+#define REASS_NONE 0xff
+#if SICSLOWPAN_FRAGMENT_BUFFERS >= REASS_NONE || SICSLOWPAN_REASS_CONTEXTS >= REASS_NONE
+#error Too many SICSLOWPAN_FRAGMENT_BUFFERS or SICSLOWPAN_REASS_CONTEXTS set.
 #endif
-
-/* Check the selected fragment size, since we use 8-bit integers to handle it. */
-#if SICSLOWPAN_FRAGMENT_SIZE > 255
-#error Too large SICSLOWPAN_FRAGMENT_SIZE set.
+#if SICSLOWPAN_REASS_CONTEXTS < 1
+#error SICSLOWPAN_REASS_CONTEXTS must be at least 1.
 #endif
 
 /* Assuming that the worst growth for uncompression is 38 bytes */
 #define SICSLOWPAN_FIRST_FRAGMENT_SIZE (SICSLOWPAN_FRAGMENT_SIZE + 38)
 
+/* Reassembly progress is tracked per 8-byte unit of the datagram */
+#define SICSLOWPAN_REASS_UNITS ((UIP_BUFSIZE + 7) / 8)
+
 /* all information needed for reassembly */
 struct sicslowpan_frag_info {
   /** When reassembling, the source address of the fragments being merged */
   linkaddr_t sender;
-  /** The destination address of the fragments being merged */
-  linkaddr_t receiver;
   /** When reassembling, the tag in the fragments being merged. */
   uint16_t tag;
-  /** Total length of the fragmented packet */
+  /** Total length of the fragmented packet, 0 if the context is free */
   uint16_t len;
-  /** Current length of reassembled fragments */
-  uint16_t reassembled_len;
+  /** Length of the uncompressed first fragment, 0 until it is received */
+  uint16_t first_frag_len;
   /** Reassembly %process %timer. */
   struct timer reass_timer;
-
-  /** Fragment size of first fragment */
-  uint16_t first_frag_len;
-  /** First fragment - needs a larger buffer since the size is uncompressed size
-   and we need to know total size to know when we have received last fragment. */
-  uint8_t first_frag[SICSLOWPAN_FIRST_FRAGMENT_SIZE];
+  /** First and last buffer holding fragments of this packet */
+  uint8_t bufs;
+  uint8_t bufs_tail;
+  /** Next context in the same hash bucket, or in the free list */
+  uint8_t next;
+  /** Received 8-byte units of the packet */
+  uint8_t received[(SICSLOWPAN_REASS_UNITS + 7) / 8];
 };
 
 static struct sicslowpan_frag_info frag_info[SICSLOWPAN_REASS_CONTEXTS];
 
 struct sicslowpan_frag_buf {
-  /* the index of the frag_info */
-  uint8_t index;
+  /* Next buffer of the same context, or in the free list */
+  uint8_t next;
   /* Fragment offset */
   uint8_t offset;
-  /* Length of this fragment (if zero this buffer is not allocated) */
+  /* Length of this fragment */
   uint8_t len;
   uint8_t data[SICSLOWPAN_FRAGMENT_SIZE];
 };
 
 static struct sicslowpan_frag_buf frag_buf[SICSLOWPAN_FRAGMENT_BUFFERS];
 
+/* Heads of the free buffer and free context lists */
+static uint8_t free_bufs;
+static uint8_t free_contexts;
+
+/* Contexts in use, hashed on sender and tag */
+static uint8_t frag_hash[SICSLOWPAN_REASS_CONTEXTS];
+
+/* The first fragment is uncompressed here, then moved to the buffers */
+static uint8_t first_frag[SICSLOWPAN_FIRST_FRAGMENT_SIZE];
+
+/*---------------------------------------------------------------------------*/
+static void
+reass_init(void)
+{
+  int i;
+
+  for(i = 0; i < SICSLOWPAN_FRAGMENT_BUFFERS; i++) {
+    frag_buf[i].next = i + 1 < SICSLOWPAN_FRAGMENT_BUFFERS ? i + 1 : REASS_NONE;
+  }
+  free_bufs = SICSLOWPAN_FRAGMENT_BUFFERS > 0 ? 0 : REASS_NONE;
+
+  for(i = 0; i < SICSLOWPAN_REASS_CONTEXTS; i++) {
+    frag_info[i].len = 0;
+    frag_info[i].next = i + 1 < SICSLOWPAN_REASS_CONTEXTS ? i + 1 : REASS_NONE;
+    frag_hash[i] = REASS_NONE;
+  }
+  free_contexts = 0;
+}
+/*---------------------------------------------------------------------------*/
+static uint8_t
+frag_hash_index(const linkaddr_t *sender, uint16_t tag)
+{
+  uint16_t h = tag;
+  int i;
+
+  for(i = 0; i < LINKADDR_SIZE; i++) {
+    h = h * 31 + sender->u8[i];
+  }
+  return h % SICSLOWPAN_REASS_CONTEXTS;
+}
+/*---------------------------------------------------------------------------*/
+/* Find the context reassembling a packet from sender with this tag */
+static int16_t
+find_context(const linkaddr_t *sender, uint16_t tag)
+{
+  uint8_t i;
+
+  for(i = frag_hash[frag_hash_index(sender, tag)]; i != REASS_NONE;
+      i = frag_info[i].next) {
+    if(frag_info[i].tag == tag && linkaddr_cmp(&frag_info[i].sender, sender)) {
+      return i;
+    }
+  }
+  return -1;
+}
 /*---------------------------------------------------------------------------*/
 static int
 clear_fragments(uint8_t frag_info_index)
 {
-  int i, clear_count;
-  clear_count = 0;
-  frag_info[frag_info_index].len = 0;
-  for(i = 0; i < SICSLOWPAN_FRAGMENT_BUFFERS; i++) {
-    if(frag_buf[i].len > 0 && frag_buf[i].index == frag_info_index) {
-      /* deallocate the buffer */
-      frag_buf[i].len = 0;
+  struct sicslowpan_frag_info *info = &frag_info[frag_info_index];
+  uint8_t *p;
+  int clear_count = 0;
+
+  if(info->len == 0) {
+    return 0;
+  }
+
+  /* Return the buffers to the pool */
+  if(info->bufs != REASS_NONE) {
+    uint8_t i;
+    for(i = info->bufs; ; i = frag_buf[i].next) {
       clear_count++;
+      if(i == info->bufs_tail) {
+        break;
+      }
     }
+    frag_buf[info->bufs_tail].next = free_bufs;
+    free_bufs = info->bufs;
   }
+
+  /* Unlink the context from its hash bucket and free it */
+  for(p = &frag_hash[frag_hash_index(&info->sender, info->tag)];
+      *p != frag_info_index; p = &frag_info[*p].next);
+  *p = info->next;
+  info->next = free_contexts;
+  free_contexts = frag_info_index;
+  info->len = 0;
+
   return clear_count;
 }
 /*---------------------------------------------------------------------------*/
@@ -307,105 +405,176 @@ timeout_fragments(int not_context)
   return count;
 }
 /*---------------------------------------------------------------------------*/
+/* Count the 8-byte units covered by len bytes at byte offset off that
+   were not received yet, and mark them as received if mark is set. */
 static int
-store_fragment(uint8_t index, uint8_t offset)
+mark_received(uint8_t context, uint16_t off, uint16_t len, bool mark)
 {
-  int i;
-  int len;
-
-  len = packetbuf_datalen() - packetbuf_hdr_len;
+  struct sicslowpan_frag_info *info = &frag_info[context];
+  uint16_t end = off + len;
+  uint16_t unit;
+  int count = 0;
 
-  if(len <= 0 || len > SICSLOWPAN_FRAGMENT_SIZE) {
-    /* Unacceptable fragment size. */
-    return -1;
+  /* A trailing partial unit only counts at the end of the packet */
+  end = end >= info->len ? (info->len + 7) / 8 : end / 8;
+  for(unit = off / 8; unit < end && unit < SICSLOWPAN_REASS_UNITS; unit++) {
+    if(!(info->received[unit / 8] & (1 << (unit % 8)))) {
+      if(mark) {
+        info->received[unit / 8] |= 1 << (unit % 8);
+      }
+      count++;
+    }
   }
+  return count;
+}
+/*---------------------------------------------------------------------------*/
+/* Have all units of the packet been received? */
+static bool
+reass_complete(uint8_t context)
+{
+  struct sicslowpan_frag_info *info = &frag_info[context];
+  uint16_t units = (info->len + 7) / 8;
+  uint16_t i;
 
-  for(i = 0; i < SICSLOWPAN_FRAGMENT_BUFFERS; i++) {
-    if(frag_buf[i].len == 0) {
-      /* copy over the data from packetbuf into the fragment buffer,
-         and store offset and len */
-      frag_buf[i].offset = offset; /* frag offset */
-      frag_buf[i].len = len;
-      frag_buf[i].index = index;
-      memcpy(frag_buf[i].data, packetbuf_ptr + packetbuf_hdr_len, len);
-      /* return the length of the stored fragment */
-      return len;
+  if(info->first_frag_len == 0 || units > SICSLOWPAN_REASS_UNITS) {
+    return false;
+  }
+  for(i = 0; i < units / 8; i++) {
+    if(info->received[i] != 0xff) {
+      return false;
     }
   }
-  /* failed */
-  return -1;
+  return units % 8 == 0 ||
+    (info->received[units / 8] & ((1 << (units % 8)) - 1)) == (1 << (units % 8)) - 1;
+}
+/*---------------------------------------------------------------------------*/
+/* Store len bytes of data at offset (in 8-byte units) in a buffer of the
+   context. Returns false if no buffer is available. */
+static bool
+store_fragment(uint8_t context, uint8_t offset, const uint8_t *data, uint8_t len)
+{
+  struct sicslowpan_frag_info *info = &frag_info[context];
+  uint8_t i;
+
+  if(free_bufs == REASS_NONE && timeout_fragments(context) == 0) {
+    return false;
+  }
+
+  /* Take a buffer from the pool, and append it to the context */
+  i = free_bufs;
+  free_bufs = frag_buf[i].next;
+  frag_buf[i].offset = offset;
+  frag_buf[i].len = len;
+  frag_buf[i].next = REASS_NONE;
+  memcpy(frag_buf[i].data, data, len);
+  if(info->bufs == REASS_NONE) {
+    info->bufs = i;
+  } else {
+    frag_buf[info->bufs_tail].next = i;
+  }
+  info->bufs_tail = i;
+  return true;
 }
 /*---------------------------------------------------------------------------*/
-/* add a new fragment to the buffer */
-static int8_t
+/* Find or create the context of a fragment and, for subsequent fragments,
+   store the payload from packetbuf. Returns the context, or -1. */
+static int16_t
 add_fragment(uint16_t tag, uint16_t frag_size, uint8_t offset)
 {
-  int i;
+  const linkaddr_t *sender = packetbuf_addr(PACKETBUF_ADDR_SENDER);
+  struct sicslowpan_frag_info *info;
+  int16_t found;
   int len;
-  int8_t found = -1;
 
-  if(offset == 0) {
-    /* This is a first fragment - check if we can add this */
-    for(i = 0; i < SICSLOWPAN_REASS_CONTEXTS; i++) {
-      /* clear all fragment info with expired timer to free all fragment buffers */
-      if(frag_info[i].len > 0 && timer_expired(&frag_info[i].reass_timer)) {
-        clear_fragments(i);
-      }
+  found = find_context(sender, tag);
 
-      /* We use len as indication on used or not used */
-      if(found < 0 && frag_info[i].len == 0) {
-        /* We remember the first free fragment info but must continue
-           the loop to free any other expired fragment buffers. */
-        found = i;
-      }
+  if(found >= 0 && frag_info[found].len != frag_size) {
+    /* The sender reused the tag for another datagram (RFC 4944, 5.3),
+       drop what was collected so far and start over */
+    LOG_WARN("reassembly: packet size changed from %u to %u - tag: %d\n",
+             frag_info[found].len, frag_size, tag);
+    clear_fragments(found);
+    found = -1;
+  }
+
+  if(found < 0) {
+    if(frag_size == 0) {
+      LOG_WARN("reassembly: invalid packet size - tag: %d\n", tag);
+      return -1;
     }
 
-    if(found < 0) {
+    /* New packet, fragments may arrive in any order. Clear all fragment
+       info with expired timer to free all fragment buffers. */
+    timeout_fragments(-1);
+
+    if(free_contexts == REASS_NONE) {
       LOG_WARN("reassembly: failed to store new fragment session - tag: %d\n", tag);
       return -1;
     }
 
-    /* Found a free fragment info to store data in */
-    frag_info[found].len = frag_size;
-    frag_info[found].tag = tag;
-    linkaddr_copy(&frag_info[found].sender,
-                  packetbuf_addr(PACKETBUF_ADDR_SENDER));
-    timer_set(&frag_info[found].reass_timer, SICSLOWPAN_REASS_MAXAGE * CLOCK_SECOND / 16);
+    found = free_contexts;
+    info = &frag_info[found];
+    free_contexts = info->next;
+    info->next = frag_hash[frag_hash_index(sender, tag)];
+    frag_hash[frag_hash_index(sender, tag)] = found;
+
+    info->len = frag_size;
+    info->tag = tag;
+    info->first_frag_len = 0;
+    info->bufs = REASS_NONE;
+    memset(info->received, 0, sizeof(info->received));
+    linkaddr_copy(&info->sender, sender);
+    timer_set(&info->reass_timer, SICSLOWPAN_REASS_MAXAGE * CLOCK_SECOND / 16);
+  }
+  info = &frag_info[found];
+
+  if(offset == 0) {
     /* first fragment can not be stored immediately but is moved into
        the buffer while uncompressing */
     return found;
   }
 
-  /* This is a N-fragment - should find the info */
-  for(i = 0; i < SICSLOWPAN_REASS_CONTEXTS; i++) {
-    if(frag_info[i].tag == tag && frag_info[i].len > 0 &&
-       linkaddr_cmp(&frag_info[i].sender, packetbuf_addr(PACKETBUF_ADDR_SENDER))) {
-      /* Tag and Sender match - this must be the correct info to store in */
-      found = i;
-      break;
-    }
-  }
-
-  if(found < 0) {
-    /* no entry found for storing the new fragment */
-    LOG_WARN("reassembly: failed to store N-fragment - could not find session - tag: %d offset: %d\n", tag, offset);
+  len = packetbuf_datalen() - packetbuf_hdr_len;
+  if(len <= 0 || len > SICSLOWPAN_FRAGMENT_SIZE) {
+    /* Unacceptable fragment size. */
+    LOG_WARN("reassembly: invalid fragment size %d tag: %d\n", len, tag);
     return -1;
   }
 
-  /* i is the index of the reassembly context */
-  len = store_fragment(i, offset);
-  if(len < 0 && timeout_fragments(i) > 0) {
-    len = store_fragment(i, offset);
+  if(mark_received(found, (uint16_t)offset << 3, len, false) == 0) {
+    /* Duplicate, nothing new to store */
+    return found;
   }
-  if(len > 0) {
-    frag_info[i].reassembled_len += len;
-    return i;
-  } else {
+
+  if(!store_fragment(found, offset, packetbuf_ptr + packetbuf_hdr_len, len)) {
     /* should we also clear all fragments since we failed to store
        this fragment? */
-    LOG_WARN("reassembly: failed to store fragment - packet reassembly will fail tag:%d l\n", frag_info[i].tag);
+    LOG_WARN("reassembly: failed to store fragment - packet reassembly will fail tag:%d l\n", info->tag);
     return -1;
   }
+  mark_received(found, (uint16_t)offset << 3, len, true);
+  return found;
+}
+/*---------------------------------------------------------------------------*/
+/* Move the uncompressed first fragment to the buffers of its context */
+static bool
+store_first_fragment(uint8_t context, uint16_t len)
+{
+  uint16_t off;
+  uint8_t chunk;
+
+  for(off = 0; off < len; off += chunk) {
+    chunk = MIN(len - off, SICSLOWPAN_FRAGMENT_CHUNK);
+    if(!store_fragment(context, off >> 3, first_frag + off, chunk)) {
+      LOG_WARN("reassembly: failed to store first fragment tag:%d\n",
+               frag_info[context].tag);
+      clear_fragments(context);
+      return false;
+    }
+  }
+  frag_info[context].first_frag_len = len;
+  mark_received(context, 0, len, true);
+  return true;
 }
 /*---------------------------------------------------------------------------*/
 /* Copy all the fragments that are associated with a specific context
@@ -413,34 +582,29 @@ add_fragment(uint16_t tag, uint16_t frag_size, uint8_t offset)
 static bool
 copy_frags2uip(int context)
 {
-  int i;
+  struct sicslowpan_frag_info *info = &frag_info[context];
+  uint8_t i;
 
   /* Check length fields before proceeding. */
-  if(frag_info[context].len < frag_info[context].first_frag_len ||
-     frag_info[context].len > sizeof(uip_buf)) {
+  if(info->len < info->first_frag_len ||
+     info->len > sizeof(uip_buf)) {
     LOG_WARN("input: invalid total size of fragments\n");
     clear_fragments(context);
     return false;
   }
 
-  /* Copy from the fragment context info buffer first */
-  memcpy((uint8_t *)UIP_IP_BUF, (uint8_t *)frag_info[context].first_frag,
-         frag_info[context].first_frag_len);
-
-  /* Ensure that no previous data is used for reassembly in case of missing fragments. */
-  memset((uint8_t *)UIP_IP_BUF + frag_info[context].first_frag_len, 0,
-         frag_info[context].len - frag_info[context].first_frag_len);
-
-  for(i = 0; i < SICSLOWPAN_FRAGMENT_BUFFERS; i++) {
-    /* And also copy all matching fragments */
-    if(frag_buf[i].len > 0 && frag_buf[i].index == context) {
-      if((frag_buf[i].offset << 3) + frag_buf[i].len > sizeof(uip_buf)) {
-        LOG_WARN("input: invalid fragment offset\n");
-        clear_fragments(context);
-        return false;
-      }
-      memcpy((uint8_t *)UIP_IP_BUF + (uint16_t)(frag_buf[i].offset << 3),
-             (uint8_t *)frag_buf[i].data, frag_buf[i].len);
+  /* All units are received, so fragments cover the whole packet: copy
+     them in the order they arrived. */
+  for(i = info->bufs; i != REASS_NONE; i = frag_buf[i].next) {
+    if((frag_buf[i].offset << 3) + frag_buf[i].len > sizeof(uip_buf)) {
+      LOG_WARN("input: invalid fragment offset\n");
+      clear_fragments(context);
+      return false;
+    }
+    memcpy((uint8_t *)UIP_IP_BUF + (uint16_t)(frag_buf[i].offset << 3),
+           (uint8_t *)frag_buf[i].data, frag_buf[i].len);
+    if(i == info->bufs_tail) {
+      break;
     }
   }
   /* deallocate all the fragments for this context */
@@ -498,6 +662,31 @@ set_packet_attrs(void)
 /*   } */
 
 }
+/*--------------------------------------------------------------------*/
+/**
+ * \brief Traffic class of the outgoing packet for the MAC layer.
+ * ICMPv6 messages other than echo (i.e. ND and RPL) are classified
+ * as control, unless the sender has chosen a class explicitly. The
+ * upper-layer header is found after any extension headers, such as
+ * the RPL hop-by-hop option.
+ */
+static uint16_t
+get_mac_priority(void)
+{
+  uint16_t priority = uipbuf_get_attr(UIPBUF_ATTR_MAC_PRIORITY);
+  struct uip_icmp_hdr *icmp;
+  uint8_t proto;
+
+  if(priority == PACKETBUF_ATTR_MAC_PRIORITY_DATA) {
+    icmp = (struct uip_icmp_hdr *)uipbuf_get_last_header(uip_buf, uip_len,
+                                                         &proto);
+    if(icmp != NULL && proto == UIP_PROTO_ICMP6 &&
+       icmp->type != ICMP6_ECHO_REQUEST && icmp->type != ICMP6_ECHO_REPLY) {
+      priority = PACKETBUF_ATTR_MAC_PRIORITY_CONTROL;
+    }
+  }
+  return priority;
+}
 
 
 
@@ -1652,6 +1841,10 @@ output(const linkaddr_t *localdest)
   /* copy over the retransmission count from uipbuf attributes */
   packetbuf_set_attr(PACKETBUF_ATTR_MAX_MAC_TRANSMISSIONS,
                      uipbuf_get_attr(UIPBUF_ATTR_MAX_MAC_TRANSMISSIONS));
+  /* ... and the traffic class and queueing lifetime */
+  packetbuf_set_attr(PACKETBUF_ATTR_MAC_PRIORITY, get_mac_priority());
+  packetbuf_set_attr(PACKETBUF_ATTR_MAC_LIFETIME,
+                     uipbuf_get_attr(UIPBUF_ATTR_MAC_LIFETIME));
 
 /* Calculate NETSTACK_FRAMER's header length, that will be added in the NETSTACK_MAC */
   packetbuf_set_addr(PACKETBUF_ADDR_RECEIVER, &dest);
@@ -1686,10 +1879,12 @@ output(const linkaddr_t *localdest)
   }
 #endif /* SICSLOWPAN_COMPRESSION == SICSLOWPAN_COMPRESSION_6LORH */
 #if SICSLOWPAN_COMPRESSION >= SICSLOWPAN_COMPRESSION_IPHC
+  PROFILE_BEGIN(compress_probe);
   if(compress_hdr_iphc(&dest) == 0) {
     /* Warning should already be issued by function above */
     return 0;
   }
+  PROFILE_END(compress_probe);
 #endif /* SICSLOWPAN_COMPRESSION >= SICSLOWPAN_COMPRESSION_IPHC */
 
   /* Use the mac_max_payload to understand what is the max payload in a MAC
@@ -1848,6 +2043,10 @@ output(const linkaddr_t *localdest)
  *  copied in siclowpan_buf. If the IP packet is complete it is copied
  *  to uip_buf and the IP layer is called.
  *
+ * Fragments may arrive in any order. Each reassembly context tracks
+ * the received 8-byte units of its packet, so duplicate fragments are
+ * dropped and the packet is complete once every unit has been received.
+ *
  * \note We do not check for overlapping sicslowpan fragments
  * (it is a SHALL in the RFC 4944 and should never happen)
  */
@@ -1863,7 +2062,7 @@ input(void)
 
 #if SICSLOWPAN_CONF_FRAG
   uint8_t is_fragment = 0;
-  int8_t frag_context = 0;
+  int16_t frag_context = 0;
 
   /* tag of the fragment */
   uint16_t frag_tag = 0;
@@ -1925,7 +2124,12 @@ input(void)
         return;
       }
 
-      buffer = frag_info[frag_context].first_frag;
+      if(frag_info[frag_context].first_frag_len > 0) {
+        LOG_WARN("input: duplicate first fragment (tag %d)\n", frag_tag);
+        return;
+      }
+
+      buffer = first_frag;
       buffer_size = SICSLOWPAN_FIRST_FRAGMENT_SIZE;
       break;
     case SICSLOWPAN_DISPATCH_FRAGN:
@@ -1951,7 +2155,7 @@ input(void)
          we should not store more */
       buffer = NULL;
 
-      if(frag_info[frag_context].reassembled_len >= frag_size) {
+      if(reass_complete(frag_context)) {
         last_fragment = 1;
       }
       is_fragment = 1;
@@ -1981,10 +2185,12 @@ input(void)
   if(SICSLOWPAN_COMPRESSION > SICSLOWPAN_COMPRESSION_IPV6 &&
      (PACKETBUF_6LO_PTR[PACKETBUF_6LO_DISPATCH] & SICSLOWPAN_DISPATCH_IPHC_MASK) == SICSLOWPAN_DISPATCH_IPHC) {
     LOG_DBG("uncompression: IPHC dispatch\n");
+    PROFILE_BEGIN(uncompress_probe);
     if(uncompress_hdr_iphc(buffer, buffer_size, frag_size) == false) {
       LOG_ERR("input: failed to decompress IPHC packet\n");
       return;
     }
+    PROFILE_END(uncompress_probe);
   } else if(PACKETBUF_6LO_PTR[PACKETBUF_6LO_DISPATCH] == SICSLOWPAN_DISPATCH_IPV6) {
     LOG_DBG("uncompression: IPV6 dispatch\n");
     packetbuf_hdr_len += SICSLOWPAN_IPV6_HDR_LEN;
@@ -2057,15 +2263,17 @@ input(void)
 
 #if SICSLOWPAN_CONF_FRAG
   if(frag_size > 0) {
-    /* Add the size of the header only for the first fragment. */
+    /* Move the uncompressed first fragment to the fragment buffers. As
+       fragments may arrive in any order, it can also be the last one. */
     if(first_fragment != 0) {
-      frag_info[frag_context].reassembled_len = uncomp_hdr_len + packetbuf_payload_len;
-      frag_info[frag_context].first_frag_len = uncomp_hdr_len + packetbuf_payload_len;
+      if(!store_first_fragment(frag_context, uncomp_hdr_len + packetbuf_payload_len)) {
+        return;
+      }
+      last_fragment = reass_complete(frag_context);
     }
     /* For the last fragment, we are OK if there is extrenous bytes at
        the end of the packet. */
     if(last_fragment != 0) {
-      frag_info[frag_context].reassembled_len = frag_size;
       /* copy to uip */
       if(!copy_frags2uip(frag_context)) {
         return;
@@ -2176,6 +2384,10 @@ sicslowpan_init(void)
 #endif /* SICSLOWPAN_CONF_MAX_ADDR_CONTEXTS > 1 */
 
 #endif /* SICSLOWPAN_COMPRESSION == SICSLOWPAN_COMPRESSION_IPHC */
+
+#if SICSLOWPAN_CONF_FRAG
+  reass_init();
+#endif /* SICSLOWPAN_CONF_FRAG */
 }
 /*--------------------------------------------------------------------*/
 int
@@ -47,6 +47,7 @@
 #include "net/ipv6/uip-ds6-nbr.h"
 #include "net/linkaddr.h"
 #include "net/routing/routing.h"
+#include "sys/profile.h"
 
 #include <string.h>
 
@@ -60,6 +61,9 @@ extern struct uip_fallback_interface UIP_FALLBACK_INTERFACE;
 #endif
 
 process_event_t tcpip_event;
+
+PROFILE_PROBE(uip_input_probe, "uip-input");
+PROFILE_PROBE(net_output_probe, "net-output");
 #if UIP_CONF_ICMP6
 process_event_t tcpip_icmp6_event;
 #endif /* UIP_CONF_ICMP6 */
@@ -121,7 +125,9 @@ tcpip_output(const uip_lladdr_t *a)
 
   if(netstack_process_ip_callback(NETSTACK_IP_OUTPUT, (const linkaddr_t *)a) ==
      NETSTACK_IP_PROCESS) {
+    PROFILE_BEGIN(net_output_probe);
     ret = NETSTACK_NETWORK.output((const linkaddr_t *) a);
+    PROFILE_END(net_output_probe);
     return ret;
   } else {
     /* Ok, ignore and drop... */
@@ -180,7 +186,9 @@ packet_input(void)
     }
 #endif /* UIP_TAG_TC_WITH_VARIABLE_RETRANSMISSIONS */
 
+    PROFILE_BEGIN(uip_input_probe);
     uip_input();
+    PROFILE_END(uip_input_probe);
     if(uip_len > 0) {
       tcpip_ipv6_output();
     }
@@ -46,6 +46,8 @@
 #include "lib/memb.h"
 #include "net/nbr-table.h"
 
+#include <string.h>
+
 /* Log configuration */
 #include "sys/log.h"
 #define LOG_MODULE "IPv6 Route"
@@ -91,6 +93,16 @@ MEMB(routememb, uip_ds6_route_t, UIP_DS6_ROUTE_NB);
 static int num_routes = 0;
 static void rm_routelist_callback(nbr_table_item_t *ptr);
 
+#if UIP_DS6_ROUTE_INDEX
+/* Routes with a 128-bit prefix, hashed on their address */
+static uip_ds6_route_t *route_hash[UIP_DS6_ROUTE_HASH_SIZE];
+/* Routes with a shorter prefix, longest prefix first */
+static uip_ds6_route_t *prefix_routes[UIP_DS6_ROUTE_NB];
+static int num_prefix_routes;
+/* Ticks on every use of a route, to find the least recently used one */
+static uint32_t route_clock;
+#endif /* UIP_DS6_ROUTE_INDEX */
+
 #endif /* (UIP_MAX_ROUTES != 0) */
 
 /* Default routes are held on the defaultrouterlist and their
@@ -168,12 +180,111 @@ uip_ds6_notification_rm(struct uip_ds6_notification *n)
 }
 #endif
 /*---------------------------------------------------------------------------*/
+#if (UIP_MAX_ROUTES != 0) && UIP_DS6_ROUTE_INDEX
+static unsigned
+route_hash_index(const uip_ipaddr_t *addr)
+{
+  uint32_t h = 0;
+  int i;
+
+  for(i = 0; i < sizeof(uip_ipaddr_t); i++) {
+    h = h * 31 + addr->u8[i];
+  }
+  return h % UIP_DS6_ROUTE_HASH_SIZE;
+}
+/*---------------------------------------------------------------------------*/
+static void
+route_index_add(uip_ds6_route_t *r)
+{
+  if(r->length >= 128) {
+    unsigned h = route_hash_index(&r->ipaddr);
+    r->hash_next = route_hash[h];
+    route_hash[h] = r;
+  } else {
+    /* Keep prefix_routes sorted, longest prefix first */
+    int i = num_prefix_routes++;
+    while(i > 0 && prefix_routes[i - 1]->length < r->length) {
+      prefix_routes[i] = prefix_routes[i - 1];
+      i--;
+    }
+    prefix_routes[i] = r;
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+route_index_rm(uip_ds6_route_t *r)
+{
+  if(r->length >= 128) {
+    uip_ds6_route_t **p = &route_hash[route_hash_index(&r->ipaddr)];
+    while(*p != NULL && *p != r) {
+      p = &(*p)->hash_next;
+    }
+    if(*p != NULL) {
+      *p = r->hash_next;
+    }
+  } else {
+    int i;
+    for(i = 0; i < num_prefix_routes && prefix_routes[i] != r; i++);
+    if(i < num_prefix_routes) {
+      num_prefix_routes--;
+      memmove(&prefix_routes[i], &prefix_routes[i + 1],
+              (num_prefix_routes - i) * sizeof(prefix_routes[0]));
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+static uip_ds6_route_t *
+route_index_lookup(const uip_ipaddr_t *addr)
+{
+  uip_ds6_route_t *r;
+  int i;
+
+  /* A host route is the longest possible match */
+  for(r = route_hash[route_hash_index(addr)]; r != NULL; r = r->hash_next) {
+    if(uip_ipaddr_cmp(addr, &r->ipaddr)) {
+      return r;
+    }
+  }
+
+  /* Otherwise the first matching prefix is the longest one */
+  for(i = 0; i < num_prefix_routes; i++) {
+    if(uip_ipaddr_prefixcmp(addr, &prefix_routes[i]->ipaddr,
+                            prefix_routes[i]->length)) {
+      return prefix_routes[i];
+    }
+  }
+  return NULL;
+}
+/*---------------------------------------------------------------------------*/
+#if UIP_DS6_ROUTE_REMOVE_LEAST_RECENTLY_USED
+static uip_ds6_route_t *
+route_least_recently_used(void)
+{
+  uip_ds6_route_t *r;
+  uip_ds6_route_t *oldest = NULL;
+
+  for(r = list_head(routelist); r != NULL; r = list_item_next(r)) {
+    /* Compare ages rather than clock values, in case the clock wrapped */
+    if(oldest == NULL ||
+       route_clock - r->last_used > route_clock - oldest->last_used) {
+      oldest = r;
+    }
+  }
+  return oldest;
+}
+#endif /* UIP_DS6_ROUTE_REMOVE_LEAST_RECENTLY_USED */
+#endif /* (UIP_MAX_ROUTES != 0) && UIP_DS6_ROUTE_INDEX */
+/*---------------------------------------------------------------------------*/
 void
 uip_ds6_route_init(void)
 {
 #if (UIP_MAX_ROUTES != 0)
   memb_init(&routememb);
   list_init(routelist);
+#if UIP_DS6_ROUTE_INDEX
+  memset(route_hash, 0, sizeof(route_hash));
+  num_prefix_routes = 0;
+#endif /* UIP_DS6_ROUTE_INDEX */
   nbr_table_register(nbr_routes,
                      (nbr_table_callback *)rm_routelist_callback);
 #endif /* (UIP_MAX_ROUTES != 0) */
@@ -281,9 +392,11 @@ uip_ds6_route_t *
 uip_ds6_route_lookup(const uip_ipaddr_t *addr)
 {
 #if (UIP_MAX_ROUTES != 0)
-  uip_ds6_route_t *r;
   uip_ds6_route_t *found_route;
+#if !UIP_DS6_ROUTE_INDEX
+  uip_ds6_route_t *r;
   uint8_t longestmatch;
+#endif /* !UIP_DS6_ROUTE_INDEX */
 
   LOG_INFO("Looking up route for ");
   LOG_INFO_6ADDR(addr);
@@ -293,6 +406,9 @@ uip_ds6_route_lookup(const uip_ipaddr_t *addr)
     return NULL;
   }
 
+#if UIP_DS6_ROUTE_INDEX
+  found_route = route_index_lookup(addr);
+#else /* UIP_DS6_ROUTE_INDEX */
   found_route = NULL;
   longestmatch = 0;
   for(r = uip_ds6_route_head();
@@ -308,6 +424,7 @@ uip_ds6_route_lookup(const uip_ipaddr_t *addr)
       }
     }
   }
+#endif /* UIP_DS6_ROUTE_INDEX */
 
   if(found_route != NULL) {
     LOG_INFO("Found route: ");
@@ -319,6 +436,11 @@ uip_ds6_route_lookup(const uip_ipaddr_t *addr)
     LOG_WARN("No route found\n");
   }
 
+#if UIP_DS6_ROUTE_INDEX
+  if(found_route != NULL) {
+    found_route->last_used = ++route_clock;
+  }
+#else /* UIP_DS6_ROUTE_INDEX */
   if(found_route != NULL && found_route != list_head(routelist)) {
     /* If we found a route, we put it at the start of the routeslist
        list. The list is ordered by how recently we looked them up:
@@ -328,6 +450,7 @@ uip_ds6_route_lookup(const uip_ipaddr_t *addr)
     list_remove(routelist, found_route);
     list_push(routelist, found_route);
   }
+#endif /* UIP_DS6_ROUTE_INDEX */
 
   return found_route;
 #else /* (UIP_MAX_ROUTES != 0) */
@@ -387,9 +510,13 @@ uip_ds6_route_add(const uip_ipaddr_t *ipaddr, uint8_t length,
       uip_ds6_route_t *oldest;
       oldest = NULL;
 #if UIP_DS6_ROUTE_REMOVE_LEAST_RECENTLY_USED
+#if UIP_DS6_ROUTE_INDEX
+      oldest = route_least_recently_used();
+#else /* UIP_DS6_ROUTE_INDEX */
       /* Removing the oldest route entry from the route table. The
          least recently used route is the first route on the list. */
       oldest = list_tail(routelist);
+#endif /* UIP_DS6_ROUTE_INDEX */
 #endif
       if(oldest == NULL) {
         return NULL;
@@ -470,6 +597,10 @@ uip_ds6_route_add(const uip_ipaddr_t *ipaddr, uint8_t length,
 
   uip_ipaddr_copy(&(r->ipaddr), ipaddr);
   r->length = length;
+#if UIP_DS6_ROUTE_INDEX
+  r->last_used = ++route_clock;
+  route_index_add(r);
+#endif /* UIP_DS6_ROUTE_INDEX */
 
 #ifdef UIP_DS6_ROUTE_STATE_TYPE
   memset(&r->state, 0, sizeof(UIP_DS6_ROUTE_STATE_TYPE));
@@ -515,6 +646,9 @@ uip_ds6_route_rm(uip_ds6_route_t *route)
 
     /* Remove the route from the route list */
     list_remove(routelist, route);
+#if UIP_DS6_ROUTE_INDEX
+    route_index_rm(route);
+#endif /* UIP_DS6_ROUTE_INDEX */
 
     /* Find the corresponding neighbor_route and remove it. */
     for(neighbor_route = list_head(route->neighbor_routes->route_list);
@@ -111,6 +111,24 @@ void uip_ds6_notification_rm(struct uip_ds6_notification *n);
 #define UIP_DS6_ROUTE_NB 4
 #endif /* UIP_MAX_ROUTES */
 
+/** \brief Index the routing table for uip_ds6_route_lookup(): /128 routes
+ *  go in a hash table, shorter prefixes in an array sorted by length.
+ *  Costs a few bytes per route; worth it on storing-mode roots with many
+ *  downward routes. With the index, the least recently used route is
+ *  tracked with a counter instead of by reordering the route list. */
+#ifdef UIP_DS6_ROUTE_CONF_INDEX
+#define UIP_DS6_ROUTE_INDEX UIP_DS6_ROUTE_CONF_INDEX
+#else
+#define UIP_DS6_ROUTE_INDEX 0
+#endif
+
+/** \brief Number of hash buckets for /128 routes in the route index */
+#ifdef UIP_DS6_ROUTE_CONF_HASH_SIZE
+#define UIP_DS6_ROUTE_HASH_SIZE UIP_DS6_ROUTE_CONF_HASH_SIZE
+#else
+#define UIP_DS6_ROUTE_HASH_SIZE UIP_DS6_ROUTE_NB
+#endif
+
 /** \brief define some additional RPL related route state and
  *  neighbor callback for RPL - if not a DS6_ROUTE_STATE is already set */
 #ifndef UIP_DS6_ROUTE_STATE_TYPE
@@ -180,6 +198,12 @@ typedef struct uip_ds6_route {
 #ifdef UIP_DS6_ROUTE_STATE_TYPE
   UIP_DS6_ROUTE_STATE_TYPE state;
 #endif
+#if UIP_DS6_ROUTE_INDEX
+  /* Next /128 route in the same hash bucket of the route index */
+  struct uip_ds6_route *hash_next;
+  /* Value of the route index clock when the route was last used */
+  uint32_t last_used;
+#endif /* UIP_DS6_ROUTE_INDEX */
   uint8_t length;
 } uip_ds6_route_t;
 
@@ -58,6 +58,17 @@ static int num_nodes;
 LIST(nodelist);
 MEMB(nodememb, uip_sr_node_t, UIP_SR_LINK_NUM);
 
+#if UIP_SR_NODE_INDEX
+/* Nodes hashed on their link identifier */
+static uip_sr_node_t *node_hash[UIP_SR_NODE_HASH_SIZE];
+#endif /* UIP_SR_NODE_INDEX */
+
+#if UIP_SR_PATH_CACHE
+/* Changes whenever a node is added, removed or changes parent. 0 marks
+ * nodes with no cached path. */
+static uint32_t graph_version = 1;
+#endif /* UIP_SR_PATH_CACHE */
+
 /*---------------------------------------------------------------------------*/
 int
 uip_sr_num_nodes(void)
@@ -65,6 +76,67 @@ uip_sr_num_nodes(void)
   return num_nodes;
 }
 /*---------------------------------------------------------------------------*/
+static void
+graph_changed(void)
+{
+#if UIP_SR_PATH_CACHE
+  if(++graph_version == 0) {
+    graph_version = 1;
+  }
+#endif /* UIP_SR_PATH_CACHE */
+}
+/*---------------------------------------------------------------------------*/
+#if UIP_SR_NODE_INDEX
+static unsigned
+node_hash_index(const unsigned char *link_identifier)
+{
+  uint32_t h = 0;
+  int i;
+
+  for(i = 0; i < 8; i++) {
+    h = h * 31 + link_identifier[i];
+  }
+  return h % UIP_SR_NODE_HASH_SIZE;
+}
+/*---------------------------------------------------------------------------*/
+static void
+node_hash_add(uip_sr_node_t *node)
+{
+  /* Append, so that lookups find the oldest of any duplicates first, as a
+   * walk of nodelist would */
+  uip_sr_node_t **p = &node_hash[node_hash_index(node->link_identifier)];
+  while(*p != NULL) {
+    p = &(*p)->hash_next;
+  }
+  node->hash_next = NULL;
+  *p = node;
+}
+/*---------------------------------------------------------------------------*/
+static void
+node_hash_remove(uip_sr_node_t *node)
+{
+  uip_sr_node_t **p = &node_hash[node_hash_index(node->link_identifier)];
+  while(*p != NULL && *p != node) {
+    p = &(*p)->hash_next;
+  }
+  if(*p != NULL) {
+    *p = node->hash_next;
+  }
+}
+#endif /* UIP_SR_NODE_INDEX */
+/*---------------------------------------------------------------------------*/
+static void
+node_free(uip_sr_node_t *node)
+{
+#if UIP_SR_NODE_INDEX
+  node_hash_remove(node);
+#endif /* UIP_SR_NODE_INDEX */
+  list_remove(nodelist, node);
+  memb_free(&nodememb, node);
+  num_nodes--;
+  graph_changed();
+}
+/*---------------------------------------------------------------------------*/
 static int
 node_matches_address(void *graph, const uip_sr_node_t *node, const uip_ipaddr_t *addr)
 {
@@ -81,7 +153,14 @@ uip_sr_node_t *
 uip_sr_get_node(void *graph, const uip_ipaddr_t *addr)
 {
   uip_sr_node_t *l;
+#if UIP_SR_NODE_INDEX
+  if(addr == NULL) {
+    return NULL;
+  }
+  for(l = node_hash[node_hash_index(addr->u8 + 8)]; l != NULL; l = l->hash_next) {
+#else /* UIP_SR_NODE_INDEX */
   for(l = list_head(nodelist); l != NULL; l = list_item_next(l)) {
+#endif /* UIP_SR_NODE_INDEX */
     /* Compare prefix and node identifier */
     if(node_matches_address(graph, l, addr)) {
       return l;
@@ -109,6 +188,73 @@ uip_sr_is_addr_reachable(void *graph, const uip_ipaddr_t *addr)
   return node != NULL && node == root_node;
 }
 /*---------------------------------------------------------------------------*/
+/* Number of leading bytes two addresses have in common */
+static uint8_t
+count_matching_bytes(const uip_ipaddr_t *a1, const uip_ipaddr_t *a2)
+{
+  uint8_t i;
+  for(i = 0; i < sizeof(uip_ipaddr_t); i++) {
+    if(a1->u8[i] != a2->u8[i]) {
+      break;
+    }
+  }
+  return i;
+}
+/*---------------------------------------------------------------------------*/
+int
+uip_sr_get_path(void *graph, uip_sr_node_t *node, uint8_t *path_len, uint8_t *cmpr)
+{
+  int max_depth = UIP_SR_LINK_NUM;
+  uip_ipaddr_t root_ipaddr;
+  uip_ipaddr_t node_ipaddr;
+  uip_ipaddr_t hop_ipaddr;
+  uip_sr_node_t *root_node;
+  uip_sr_node_t *hop;
+  uint8_t len;
+  uint8_t c;
+
+  if(node == NULL) {
+    return 0;
+  }
+
+#if UIP_SR_PATH_CACHE
+  if(node->path_version == graph_version) {
+    *path_len = node->path_len;
+    *cmpr = node->path_cmpr;
+    return 1;
+  }
+#endif /* UIP_SR_PATH_CACHE */
+
+  NETSTACK_ROUTING.get_root_ipaddr(&root_ipaddr);
+  root_node = uip_sr_get_node(graph, &root_ipaddr);
+  if(root_node == NULL || node == root_node) {
+    return 0;
+  }
+
+  NETSTACK_ROUTING.get_sr_node_ipaddr(&node_ipaddr, node);
+  len = 0;
+  c = 15;
+  for(hop = node->parent; hop != NULL && hop != root_node && max_depth > 0;
+      hop = hop->parent) {
+    NETSTACK_ROUTING.get_sr_node_ipaddr(&hop_ipaddr, hop);
+    c = MIN(c, count_matching_bytes(&hop_ipaddr, &node_ipaddr));
+    len++;
+    max_depth--;
+  }
+  if(hop != root_node) {
+    return 0;
+  }
+
+#if UIP_SR_PATH_CACHE
+  node->path_version = graph_version;
+  node->path_len = len;
+  node->path_cmpr = c;
+#endif /* UIP_SR_PATH_CACHE */
+  *path_len = len;
+  *cmpr = c;
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
 void
 uip_sr_expire_parent(void *graph, const uip_ipaddr_t *child, const uip_ipaddr_t *parent)
 {
@@ -148,18 +294,30 @@ uip_sr_update_node(void *graph, const uip_ipaddr_t *child, const uip_ipaddr_t *p
       return NULL;
     }
     child_node->parent = NULL;
+#if UIP_SR_PATH_CACHE
+    child_node->path_version = 0;
+#endif /* UIP_SR_PATH_CACHE */
+    memcpy(child_node->link_identifier, ((const unsigned char *)child) + 8, 8);
+#if UIP_SR_NODE_INDEX
+    node_hash_add(child_node);
+#endif /* UIP_SR_NODE_INDEX */
     list_add(nodelist, child_node);
     num_nodes++;
+    /* Children of a removed node may still point to the reused memory */
+    graph_changed();
   }
+  old_parent_node = child_node->parent;
 
   /* Initialize node */
+  if(child_node->graph != graph) {
+    graph_changed();
+  }
   child_node->graph = graph;
   child_node->lifetime = lifetime;
   memcpy(child_node->link_identifier, ((const unsigned char *)child) + 8, 8);
 
   /* Is the node reachable before the update? */
   if(uip_sr_is_addr_reachable(graph, child)) {
-    old_parent_node = child_node->parent;
     /* Update node */
     child_node->parent = parent_node;
     /* Has the node become unreachable? May happen if we create a loop. */
@@ -172,6 +330,9 @@ uip_sr_update_node(void *graph, const uip_ipaddr_t *child, const uip_ipaddr_t *p
   } else {
     child_node->parent = parent_node;
   }
+  if(child_node->parent != old_parent_node) {
+    graph_changed();
+  }
 
   LOG_INFO("NS: updating link, child ");
   LOG_INFO_6ADDR(child);
@@ -188,6 +349,10 @@ uip_sr_init(void)
   num_nodes = 0;
   memb_init(&nodememb);
   list_init(nodelist);
+#if UIP_SR_NODE_INDEX
+  memset(node_hash, 0, sizeof(node_hash));
+#endif /* UIP_SR_NODE_INDEX */
+  graph_changed();
 }
 /*---------------------------------------------------------------------------*/
 uip_sr_node_t *
@@ -226,9 +391,7 @@ uip_sr_periodic(unsigned seconds)
         LOG_INFO_("\n");
       }
       /* No child found, deallocate node */
-      list_remove(nodelist, l);
-      memb_free(&nodememb, l);
-      num_nodes--;
+      node_free(l);
     } else if(l->lifetime != UIP_SR_INFINITE_LIFETIME) {
       l->lifetime = l->lifetime > seconds ? l->lifetime - seconds : 0;
     }
@@ -242,9 +405,7 @@ uip_sr_free_all(void)
   uip_sr_node_t *next;
   for(l = list_head(nodelist); l != NULL; l = next) {
     next = list_item_next(l);
-    list_remove(nodelist, l);
-    memb_free(&nodememb, l);
-    num_nodes--;
+    node_free(l);
   }
 }
 /*---------------------------------------------------------------------------*/
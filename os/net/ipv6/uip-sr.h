@@ -83,6 +83,30 @@
 #define UIP_SR_REMOVAL_DELAY          60
 #endif /* UIP_SR_CONF_REMOVAL_DELAY */
 
+/* Index nodes in a hash table on their link identifier, for constant
+ * time uip_sr_get_node() on roots with large networks */
+#ifdef UIP_SR_CONF_NODE_INDEX
+#define UIP_SR_NODE_INDEX             UIP_SR_CONF_NODE_INDEX
+#else /* UIP_SR_CONF_NODE_INDEX */
+#define UIP_SR_NODE_INDEX             1
+#endif /* UIP_SR_CONF_NODE_INDEX */
+
+/* Number of hash buckets of the node index */
+#ifdef UIP_SR_CONF_NODE_HASH_SIZE
+#define UIP_SR_NODE_HASH_SIZE         UIP_SR_CONF_NODE_HASH_SIZE
+#else /* UIP_SR_CONF_NODE_HASH_SIZE */
+#define UIP_SR_NODE_HASH_SIZE         (UIP_SR_LINK_NUM > 0 ? UIP_SR_LINK_NUM : 1)
+#endif /* UIP_SR_CONF_NODE_HASH_SIZE */
+
+/* Cache the source route length and compression of every node until the
+ * graph changes, so that building a source routing header does not walk
+ * the path twice */
+#ifdef UIP_SR_CONF_PATH_CACHE
+#define UIP_SR_PATH_CACHE             UIP_SR_CONF_PATH_CACHE
+#else /* UIP_SR_CONF_PATH_CACHE */
+#define UIP_SR_PATH_CACHE             0
+#endif /* UIP_SR_CONF_PATH_CACHE */
+
 #define UIP_SR_INFINITE_LIFETIME           0xFFFFFFFF
 
 /********** Data Structures  **********/
@@ -98,6 +122,16 @@ typedef struct uip_sr_node {
   us with the prefix */
   unsigned char link_identifier[8];
   struct uip_sr_node *parent;
+#if UIP_SR_NODE_INDEX
+  /* Next node in the same hash bucket of the node index */
+  struct uip_sr_node *hash_next;
+#endif /* UIP_SR_NODE_INDEX */
+#if UIP_SR_PATH_CACHE
+  /* Cached source route, valid while path_version is the graph version */
+  uint32_t path_version;
+  uint8_t path_len;
+  uint8_t path_cmpr;
+#endif /* UIP_SR_PATH_CACHE */
 } uip_sr_node_t;
 
 /********** Public functions **********/
@@ -162,6 +196,20 @@ uip_sr_node_t *uip_sr_get_node(void *graph, const uip_ipaddr_t *addr);
 */
 int uip_sr_is_addr_reachable(void *graph, const uip_ipaddr_t *addr);
 
+/**
+ * Gets the source route from the root to a node: the number of hops in
+ * between, and the number of leading bytes the addresses of these hops
+ * share with the address of the node (at most 15, used as ComprI and
+ * ComprE of a RFC 6554 source routing header)
+ *
+ * \param graph The graph the node belongs to
+ * \param node The destination node
+ * \param path_len Set to the number of hops between the root and the node
+ * \param cmpr Set to the number of leading bytes shared by the addresses
+ * \return 1 if the node is reachable from the root, 0 otherwise
+*/
+int uip_sr_get_path(void *graph, uip_sr_node_t *node, uint8_t *path_len, uint8_t *cmpr);
+
 /**
  * A function called periodically. Used to age the links (decrease lifetime
  * and expire links accordingly)
@@ -203,6 +203,8 @@ enum {
   UIPBUF_ATTR_FLAGS,   /**< Flags that can control lower layers.  see above. */
   UIPBUF_ATTR_RSSI, /**< Last packet's RSSI */
   UIPBUF_ATTR_LINK_QUALITY, /**< Last packet's LQI */
+  UIPBUF_ATTR_MAC_PRIORITY, /**< MAC traffic class, see packetbuf.h */
+  UIPBUF_ATTR_MAC_LIFETIME, /**< MAC queueing deadline in clock ticks */
   UIPBUF_ATTR_MAX
 };
 
@@ -51,6 +51,7 @@
 #include "lib/list.h"
 #include "lib/memb.h"
 #include "lib/assert.h"
+#include "sys/profile.h"
 
 /* Log configuration */
 #include "sys/log.h"
@@ -120,11 +121,41 @@ struct neighbor_queue {
 
 #define MAX_QUEUED_PACKETS QUEUEBUF_NUM
 
+#if CSMA_WITH_PRIORITIES
+/* The maximum number of queued data packets, over all neighbors.
+   By default, a quarter of the packet pool is kept for other classes. */
+#ifdef CSMA_CONF_MAX_PACKETS_DATA
+#define CSMA_MAX_PACKETS_DATA CSMA_CONF_MAX_PACKETS_DATA
+#else
+#define CSMA_MAX_PACKETS_DATA (MAX_QUEUED_PACKETS - MAX_QUEUED_PACKETS / 4)
+#endif /* CSMA_CONF_MAX_PACKETS_DATA */
+
+/* The maximum number of queued latency-sensitive packets, over all neighbors */
+#ifdef CSMA_CONF_MAX_PACKETS_LATENCY
+#define CSMA_MAX_PACKETS_LATENCY CSMA_CONF_MAX_PACKETS_LATENCY
+#else
+#define CSMA_MAX_PACKETS_LATENCY (MAX_QUEUED_PACKETS - MAX_QUEUED_PACKETS / 8)
+#endif /* CSMA_CONF_MAX_PACKETS_LATENCY */
+
+/* Control packets are bounded by the packet pool only */
+static const uint8_t class_limits[CSMA_NUM_PRIORITIES] = {
+  CSMA_MAX_PACKETS_DATA, CSMA_MAX_PACKETS_LATENCY, MAX_QUEUED_PACKETS
+};
+
+struct csma_queue_stats csma_queue_stats[CSMA_NUM_PRIORITIES];
+#endif /* CSMA_WITH_PRIORITIES */
+
 /* Neighbor packet queue */
 struct packet_queue {
   struct packet_queue *next;
   struct queuebuf *buf;
   void *ptr;
+#if CSMA_WITH_PRIORITIES
+  uint8_t priority;
+#endif /* CSMA_WITH_PRIORITIES */
+#if PROFILE_ON
+  PROFILE_TIME_T enqueued_at;
+#endif /* PROFILE_ON */
 };
 
 MEMB(neighbor_memb, struct neighbor_queue, CSMA_MAX_NEIGHBOR_QUEUES);
@@ -137,6 +168,10 @@ static void packet_sent(struct neighbor_queue *n,
     int status,
     int num_transmissions);
 static void transmit_from_queue(void *ptr);
+
+PROFILE_PROBE(create_probe, "framer-create");
+PROFILE_PROBE(queue_probe, "csma-queue");
+PROFILE_PROBE(tx_probe, "radio-tx");
 /*---------------------------------------------------------------------------*/
 static struct neighbor_queue *
 neighbor_queue_from_addr(const linkaddr_t *addr)
@@ -166,10 +201,9 @@ backoff_period(void)
 }
 /*---------------------------------------------------------------------------*/
 static int
-send_one_packet(struct neighbor_queue *n, struct packet_queue *q)
+create_frame(void)
 {
   int ret;
-  int last_sent_ok = 0;
 
   packetbuf_set_addr(PACKETBUF_ADDR_SENDER, &linkaddr_node_addr);
   packetbuf_set_attr(PACKETBUF_ATTR_MAC_ACK, 1);
@@ -181,16 +215,53 @@ send_one_packet(struct neighbor_queue *n, struct packet_queue *q)
 #endif /* LLSEC802154_USES_EXPLICIT_KEYS */
 #endif /* LLSEC802154_ENABLED */
 
-  if(csma_security_create_frame() < 0) {
+  PROFILE_BEGIN(create_probe);
+  ret = csma_security_create_frame();
+  PROFILE_END(create_probe);
+  if(ret < 0) {
     /* Failed to allocate space for headers */
     LOG_ERR("failed to create packet, seqno: %d\n", packetbuf_attr(PACKETBUF_ATTR_MAC_SEQNO));
+    return -1;
+  }
+  return 0;
+}
+/*---------------------------------------------------------------------------*/
+static int
+send_one_packet(struct neighbor_queue *n, struct packet_queue *q)
+{
+  int ret;
+  int last_sent_ok = 0;
+  uint8_t *frame;
+  uint16_t frame_len;
+
+#if CSMA_SEND_FROM_QUEUE
+  frame = queuebuf_dataptr(q->buf);
+  frame_len = queuebuf_datalen(q->buf);
+#else /* CSMA_SEND_FROM_QUEUE */
+  frame = NULL;
+  frame_len = 0;
+  if(create_frame() == 0) {
+    frame = packetbuf_hdrptr();
+    frame_len = packetbuf_totlen();
+  }
+#endif /* CSMA_SEND_FROM_QUEUE */
+
+#if PROFILE_ON
+  if(n->transmissions == 0 && n->collisions == 0) {
+    /* Time from enqueueing to the first attempt */
+    PROFILE_RECORD(queue_probe, (PROFILE_TIME_T)(PROFILE_NOW() - q->enqueued_at));
+  }
+#endif /* PROFILE_ON */
+
+  if(frame == NULL) {
     ret = MAC_TX_ERR_FATAL;
   } else {
     int is_broadcast;
     uint8_t dsn;
-    dsn = ((uint8_t *)packetbuf_hdrptr())[2] & 0xff;
+    dsn = frame[2] & 0xff;
 
-    NETSTACK_RADIO.prepare(packetbuf_hdrptr(), packetbuf_totlen());
+    PROFILE_BEGIN(tx_probe);
+    NETSTACK_RADIO.prepare(frame, frame_len);
 
     is_broadcast = packetbuf_holds_broadcast();
 
@@ -203,7 +274,7 @@ send_one_packet(struct neighbor_queue *n, struct packet_queue *q)
       ret = MAC_TX_COLLISION;
     } else {
 
-      switch(NETSTACK_RADIO.transmit(packetbuf_totlen())) {
+      switch(NETSTACK_RADIO.transmit(frame_len)) {
       case RADIO_TX_OK:
         if(is_broadcast) {
           ret = MAC_TX_OK;
@@ -244,6 +315,7 @@ send_one_packet(struct neighbor_queue *n, struct packet_queue *q)
         break;
       }
     }
+    PROFILE_END(tx_probe);
   }
   if(ret == MAC_TX_OK) {
     last_sent_ok = 1;
@@ -266,7 +338,13 @@ transmit_from_queue(void *ptr)
         queuebuf_attr(q->buf, PACKETBUF_ATTR_MAC_SEQNO),
         n->transmissions, list_length(n->packet_queue));
       /* Send first packet in the neighbor queue */
+#if CSMA_SEND_FROM_QUEUE
+      /* The frame is sent from the queuebuf, the packetbuf only holds
+         its attributes for the radio driver and the callbacks */
+      queuebuf_attr_to_packetbuf(q->buf);
+#else /* CSMA_SEND_FROM_QUEUE */
       queuebuf_to_packetbuf(q->buf);
+#endif /* CSMA_SEND_FROM_QUEUE */
       send_one_packet(n, q);
     }
   }
@@ -298,6 +376,14 @@ free_packet(struct neighbor_queue *n, struct packet_queue *p, int status)
   if(p != NULL) {
     /* Remove packet from queue and deallocate */
     list_remove(n->packet_queue, p);
+#if CSMA_WITH_PRIORITIES
+    csma_queue_stats[p->priority].queued--;
+    if(status == MAC_TX_OK) {
+      csma_queue_stats[p->priority].tx_ok++;
+    } else {
+      csma_queue_stats[p->priority].tx_failed++;
+    }
+#endif /* CSMA_WITH_PRIORITIES */
 
     queuebuf_free(p->buf);
     memb_free(&metadata_memb, p->ptr);
@@ -437,6 +523,40 @@ packet_sent(struct neighbor_queue *n,
   }
 }
 /*---------------------------------------------------------------------------*/
+#if CSMA_WITH_PRIORITIES
+/* Traffic class of the packet in packetbuf */
+static uint8_t
+packetbuf_priority(void)
+{
+  uint16_t priority = packetbuf_attr(PACKETBUF_ATTR_MAC_PRIORITY);
+  return MIN(priority, CSMA_NUM_PRIORITIES - 1);
+}
+/*---------------------------------------------------------------------------*/
+/* Queue the packet behind all packets of the same or a higher class. It
+   may only overtake the head if the head has not been attempted yet. */
+static void
+enqueue_packet(struct neighbor_queue *n, struct packet_queue *q)
+{
+  struct packet_queue *prev = list_head(n->packet_queue);
+  struct packet_queue *next;
+
+  if(prev == NULL) {
+    list_add(n->packet_queue, q);
+  } else if(q->priority > prev->priority
+            && n->transmissions == 0 && n->collisions == 0) {
+    list_push(n->packet_queue, q);
+  } else {
+    while((next = list_item_next(prev)) != NULL
+          && next->priority >= q->priority) {
+      prev = next;
+    }
+    list_insert(n->packet_queue, prev, q);
+  }
+  csma_queue_stats[q->priority].queued++;
+  csma_queue_stats[q->priority].enqueued++;
+}
+#endif /* CSMA_WITH_PRIORITIES */
+/*---------------------------------------------------------------------------*/
 void
 csma_output_packet(mac_callback_t sent, void *ptr)
 {
@@ -445,6 +565,10 @@ csma_output_packet(mac_callback_t sent, void *ptr)
   static uint8_t initialized = 0;
   static uint8_t seqno;
   const linkaddr_t *addr = packetbuf_addr(PACKETBUF_ADDR_RECEIVER);
+  int queue_has_room;
+#if CSMA_WITH_PRIORITIES
+  uint8_t priority = packetbuf_priority();
+#endif /* CSMA_WITH_PRIORITIES */
 
   if(!initialized) {
     initialized = 1;
@@ -460,6 +584,14 @@ csma_output_packet(mac_callback_t sent, void *ptr)
   packetbuf_set_attr(PACKETBUF_ATTR_MAC_SEQNO, seqno++);
   packetbuf_set_attr(PACKETBUF_ATTR_FRAME_TYPE, FRAME802154_DATAFRAME);
 
+#if CSMA_SEND_FROM_QUEUE
+  /* Create the frame once, retransmissions send it unchanged */
+  if(create_frame() < 0) {
+    mac_call_sent_callback(sent, ptr, MAC_TX_ERR_FATAL, 1);
+    return;
+  }
+#endif /* CSMA_SEND_FROM_QUEUE */
+
   /* Look for the neighbor entry */
   n = neighbor_queue_from_addr(addr);
   if(n == NULL) {
@@ -478,8 +610,16 @@ csma_output_packet(mac_callback_t sent, void *ptr)
   }
 
   if(n != NULL) {
+#if CSMA_WITH_PRIORITIES
+    /* Control packets are not subject to the per-neighbor limit */
+    queue_has_room = csma_queue_stats[priority].queued < class_limits[priority]
+      && (priority == PACKETBUF_ATTR_MAC_PRIORITY_CONTROL
+          || list_length(n->packet_queue) < CSMA_MAX_PACKET_PER_NEIGHBOR);
+#else /* CSMA_WITH_PRIORITIES */
+    queue_has_room = list_length(n->packet_queue) < CSMA_MAX_PACKET_PER_NEIGHBOR;
+#endif /* CSMA_WITH_PRIORITIES */
     /* Add packet to the neighbor's queue */
-    if(list_length(n->packet_queue) < CSMA_MAX_PACKET_PER_NEIGHBOR) {
+    if(queue_has_room) {
       q = memb_alloc(&packet_memb);
       if(q != NULL) {
         q->ptr = memb_alloc(&metadata_memb);
@@ -495,7 +635,15 @@ csma_output_packet(mac_callback_t sent, void *ptr)
             }
             metadata->sent = sent;
             metadata->cptr = ptr;
+#if PROFILE_ON
+            q->enqueued_at = PROFILE_NOW();
+#endif /* PROFILE_ON */
+#if CSMA_WITH_PRIORITIES
+            q->priority = priority;
+            enqueue_packet(n, q);
+#else /* CSMA_WITH_PRIORITIES */
             list_add(n->packet_queue, q);
+#endif /* CSMA_WITH_PRIORITIES */
 
             LOG_INFO("sending to ");
             LOG_INFO_LLADDR(addr);
@@ -527,6 +675,9 @@ csma_output_packet(mac_callback_t sent, void *ptr)
   } else {
     LOG_WARN("could not allocate neighbor, dropping packet\n");
   }
+#if CSMA_WITH_PRIORITIES
+  csma_queue_stats[priority].dropped++;
+#endif /* CSMA_WITH_PRIORITIES */
   mac_call_sent_callback(sent, ptr, MAC_TX_QUEUE_FULL, 1);
 }
 /*---------------------------------------------------------------------------*/
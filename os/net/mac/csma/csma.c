@@ -43,6 +43,7 @@
 #include "net/mac/mac-sequence.h"
 #include "net/packetbuf.h"
 #include "net/netstack.h"
+#include "sys/profile.h"
 
 /* Log configuration */
 #include "sys/log.h"
@@ -71,6 +72,19 @@ send_packet(mac_callback_t sent, void *ptr)
   csma_output_packet(sent, ptr);
 }
 /*---------------------------------------------------------------------------*/
+PROFILE_PROBE(parse_probe, "framer-parse");
+
+static int
+parse_frame(void)
+{
+  int ret;
+
+  PROFILE_BEGIN(parse_probe);
+  ret = csma_security_parse_frame();
+  PROFILE_END(parse_probe);
+  return ret;
+}
+/*---------------------------------------------------------------------------*/
 static void
 input_packet(void)
 {
@@ -81,7 +95,7 @@ input_packet(void)
   if(packetbuf_datalen() == CSMA_ACK_LEN) {
     /* Ignore ack packets */
     LOG_DBG("ignored ack\n");
-  } else if(csma_security_parse_frame() < 0) {
+  } else if(parse_frame() < 0) {
     LOG_ERR("failed to parse %u\n", packetbuf_datalen());
   } else if(!linkaddr_cmp(packetbuf_addr(PACKETBUF_ADDR_RECEIVER),
                                          &linkaddr_node_addr) &&
@@ -72,6 +72,27 @@
 #define CSMA_AFTER_ACK_DETECTED_WAIT_TIME       RTIMER_SECOND / 1500
 #endif /* CSMA_CONF_AFTER_ACK_DETECTED_WAIT_TIME */
 
+/* Create the frame when it is queued, and transmit it from the queue
+   on every attempt. Otherwise, the frame is copied to the packetbuf and
+   created again before each attempt. */
+#ifdef CSMA_CONF_SEND_FROM_QUEUE
+#define CSMA_SEND_FROM_QUEUE CSMA_CONF_SEND_FROM_QUEUE
+#else /* CSMA_CONF_SEND_FROM_QUEUE */
+#define CSMA_SEND_FROM_QUEUE 1
+#endif /* CSMA_CONF_SEND_FROM_QUEUE */
+
+/* Queue packets by traffic class (PACKETBUF_ATTR_MAC_PRIORITY): control
+   packets go ahead of latency-sensitive ones, which go ahead of data.
+   Each class is limited in how much of the packet pool it may hold. */
+#ifdef CSMA_CONF_WITH_PRIORITIES
+#define CSMA_WITH_PRIORITIES CSMA_CONF_WITH_PRIORITIES
+#else /* CSMA_CONF_WITH_PRIORITIES */
+#define CSMA_WITH_PRIORITIES 0
+#endif /* CSMA_CONF_WITH_PRIORITIES */
+
+/* The number of traffic classes, see packetbuf.h */
+#define CSMA_NUM_PRIORITIES (PACKETBUF_ATTR_MAC_PRIORITY_CONTROL + 1)
+
 #define CSMA_ACK_LEN 3
 
 /* just a default - with LLSEC, etc */
@@ -87,6 +108,19 @@ int csma_security_parse_frame(void);
 /* key management for CSMA */
 int csma_security_set_key(uint8_t index, const uint8_t *key);
 
+#if CSMA_WITH_PRIORITIES
+/* Per traffic class queue statistics */
+struct csma_queue_stats {
+  uint32_t enqueued;   /* packets accepted into a queue */
+  uint32_t dropped;    /* packets rejected because of queue limits */
+  uint32_t tx_ok;      /* packets sent successfully */
+  uint32_t tx_failed;  /* packets that were given up on */
+  uint8_t queued;      /* packets currently queued */
+};
+
+extern struct csma_queue_stats csma_queue_stats[CSMA_NUM_PRIORITIES];
+#endif /* CSMA_WITH_PRIORITIES */
+
 
 #endif /* CSMA_H_ */
 /**
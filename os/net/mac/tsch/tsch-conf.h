@@ -306,6 +306,31 @@
 #endif
 #endif
 
+/* The number of traffic classes per neighbor queue. Outgoing packets are
+ * classified by PACKETBUF_ATTR_MAC_PRIORITY (values above the highest class
+ * are capped to it) and higher classes are served first. Each class has a
+ * ring of TSCH_QUEUE_NUM_PER_NEIGHBOR entries */
+#ifdef TSCH_QUEUE_CONF_NUM_PRIORITIES
+#define TSCH_QUEUE_NUM_PRIORITIES TSCH_QUEUE_CONF_NUM_PRIORITIES
+#else
+#define TSCH_QUEUE_NUM_PRIORITIES 1
+#endif
+
+/* Drop packets that stayed queued for longer than their
+ * PACKETBUF_ATTR_MAC_LIFETIME instead of transmitting them */
+#ifdef TSCH_QUEUE_CONF_WITH_DEADLINES
+#define TSCH_QUEUE_WITH_DEADLINES TSCH_QUEUE_CONF_WITH_DEADLINES
+#else
+#define TSCH_QUEUE_WITH_DEADLINES 0
+#endif
+
+/* The maximum number of expired packets dropped within a single timeslot */
+#ifdef TSCH_QUEUE_CONF_MAX_EXPIRED_PER_SLOT
+#define TSCH_QUEUE_MAX_EXPIRED_PER_SLOT TSCH_QUEUE_CONF_MAX_EXPIRED_PER_SLOT
+#else
+#define TSCH_QUEUE_MAX_EXPIRED_PER_SLOT 4
+#endif
+
 /* The number of neighbor queues. There are two queues allocated at all times:
  * one for EBs, one for broadcasts. Other queues are for unicast to neighbors */
 #ifdef TSCH_QUEUE_CONF_MAX_NEIGHBOR_QUEUES
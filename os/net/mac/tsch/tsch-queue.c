@@ -75,12 +75,17 @@ NBR_TABLE(struct tsch_neighbor, tsch_neighbors);
 struct tsch_neighbor *n_broadcast;
 struct tsch_neighbor *n_eb;
 
+/* The neighbor served last by tsch_queue_get_unicast_packet_for_any,
+ * the next lookup starts after it (round-robin over shared links) */
+static struct tsch_neighbor *last_served_nbr;
+
 /*---------------------------------------------------------------------------*/
 /* Add a TSCH neighbor */
 struct tsch_neighbor *
 tsch_queue_add_nbr(const linkaddr_t *addr)
 {
   struct tsch_neighbor *n = NULL;
+  int i;
   /* If we have an entry for this neighbor already, we simply update it */
   n = tsch_queue_get_nbr(addr);
   if(n == NULL) {
@@ -94,7 +99,9 @@ tsch_queue_add_nbr(const linkaddr_t *addr)
         nbr_table_lock(tsch_neighbors, n);
         /* Initialize neighbor entry */
         memset(n, 0, sizeof(struct tsch_neighbor));
-        ringbufindex_init(&n->tx_ringbuf, TSCH_QUEUE_NUM_PER_NEIGHBOR);
+        for(i = 0; i < TSCH_QUEUE_NUM_PRIORITIES; i++) {
+          ringbufindex_init(&n->tx_ringbuf[i], TSCH_QUEUE_NUM_PER_NEIGHBOR);
+        }
         n->is_broadcast = linkaddr_cmp(addr, &tsch_eb_address)
           || linkaddr_cmp(addr, &tsch_broadcast_address);
         tsch_queue_backoff_reset(n);
@@ -218,12 +225,24 @@ tsch_queue_remove_nbr(struct tsch_neighbor *n)
       /* Flush queue */
       tsch_queue_flush_nbr_queue(n);
 
+      if(n == last_served_nbr) {
+        last_served_nbr = NULL;
+      }
+
       /* Free neighbor */
       nbr_table_remove(tsch_neighbors, n);
     }
   }
 }
 /*---------------------------------------------------------------------------*/
+/* Traffic class of the packet in packetbuf, i.e., the index of its ring */
+static uint8_t
+packetbuf_priority(void)
+{
+  uint16_t priority = packetbuf_attr(PACKETBUF_ATTR_MAC_PRIORITY);
+  return MIN(priority, TSCH_QUEUE_NUM_PRIORITIES - 1);
+}
+/*---------------------------------------------------------------------------*/
 /* Add packet to neighbor queue. Use same lockfree implementation as ringbuf.c (put is atomic) */
 struct tsch_packet *
 tsch_queue_add_packet(const linkaddr_t *addr, uint8_t max_transmissions,
@@ -232,6 +251,7 @@ tsch_queue_add_packet(const linkaddr_t *addr, uint8_t max_transmissions,
   struct tsch_neighbor *n = NULL;
   int16_t put_index = -1;
   struct tsch_packet *p = NULL;
+  uint8_t priority = packetbuf_priority();
 
 #ifdef TSCH_CALLBACK_PACKET_READY
   /* The scheduler provides a callback which sets the timeslot and other attributes */
@@ -245,7 +265,7 @@ tsch_queue_add_packet(const linkaddr_t *addr, uint8_t max_transmissions,
   if(!tsch_is_locked()) {
     n = tsch_queue_add_nbr(addr);
     if(n != NULL) {
-      put_index = ringbufindex_peek_put(&n->tx_ringbuf);
+      put_index = ringbufindex_peek_put(&n->tx_ringbuf[priority]);
       if(put_index != -1) {
         p = memb_alloc(&packet_memb);
         if(p != NULL) {
@@ -257,11 +277,17 @@ tsch_queue_add_packet(const linkaddr_t *addr, uint8_t max_transmissions,
             p->ret = MAC_TX_DEFERRED;
             p->transmissions = 0;
             p->max_transmissions = max_transmissions;
+            p->priority = priority;
+#if TSCH_QUEUE_WITH_DEADLINES
+            p->lifetime = packetbuf_attr(PACKETBUF_ATTR_MAC_LIFETIME);
+            p->enqueued_at = clock_time();
+#endif /* TSCH_QUEUE_WITH_DEADLINES */
             /* Add to ringbuf (actual add committed through atomic operation) */
-            n->tx_array[put_index] = p;
-            ringbufindex_put(&n->tx_ringbuf);
-            LOG_DBG("packet is added put_index %u, packet %p\n",
-                   put_index, p);
+            n->tx_array[priority][put_index] = p;
+            ringbufindex_put(&n->tx_ringbuf[priority]);
+            tsch_stats_on_enqueue(priority, 1);
+            LOG_DBG("packet is added put_index %u, priority %u, packet %p\n",
+                   put_index, priority, p);
             return p;
           } else {
             memb_free(&packet_memb, p);
@@ -270,6 +296,7 @@ tsch_queue_add_packet(const linkaddr_t *addr, uint8_t max_transmissions,
       }
     }
   }
+  tsch_stats_on_enqueue(priority, 0);
   LOG_ERR("! add packet failed: %u %p %d %p %p\n", tsch_is_locked(), n, put_index, p, p ? p->qb : NULL);
   return NULL;
 }
@@ -286,23 +313,40 @@ int
 tsch_queue_nbr_packet_count(const struct tsch_neighbor *n)
 {
   if(n != NULL) {
-    return ringbufindex_elements(&n->tx_ringbuf);
+    int i;
+    int count = 0;
+    for(i = 0; i < TSCH_QUEUE_NUM_PRIORITIES; i++) {
+      count += ringbufindex_elements(&n->tx_ringbuf[i]);
+    }
+    return count;
   }
   return -1;
 }
 /*---------------------------------------------------------------------------*/
-/* Remove first packet from a neighbor queue */
+/* Remove the head packet of one traffic class of a neighbor queue */
+static struct tsch_packet *
+remove_packet_of_class(struct tsch_neighbor *n, uint8_t priority)
+{
+  /* Get and remove packet from ringbuf (remove committed through an atomic operation */
+  int16_t get_index = ringbufindex_get(&n->tx_ringbuf[priority]);
+  if(get_index != -1) {
+    return n->tx_array[priority][get_index];
+  }
+  return NULL;
+}
+/*---------------------------------------------------------------------------*/
+/* Remove first packet from a neighbor queue, highest traffic class first */
 struct tsch_packet *
 tsch_queue_remove_packet_from_queue(struct tsch_neighbor *n)
 {
   if(!tsch_is_locked()) {
     if(n != NULL) {
-      /* Get and remove packet from ringbuf (remove committed through an atomic operation */
-      int16_t get_index = ringbufindex_get(&n->tx_ringbuf);
-      if(get_index != -1) {
-        return n->tx_array[get_index];
-      } else {
-        return NULL;
+      int i;
+      for(i = TSCH_QUEUE_NUM_PRIORITIES - 1; i >= 0; i--) {
+        struct tsch_packet *p = remove_packet_of_class(n, i);
+        if(p != NULL) {
+          return p;
+        }
       }
     }
   }
@@ -343,7 +387,7 @@ tsch_queue_packet_sent(struct tsch_neighbor *n, struct tsch_packet *p,
 
   if(mac_tx_status == MAC_TX_OK) {
     /* Successful transmission */
-    tsch_queue_remove_packet_from_queue(n);
+    remove_packet_of_class(n, p->priority);
     in_queue = 0;
 
     /* Update CSMA state in the unicast case */
@@ -358,7 +402,7 @@ tsch_queue_packet_sent(struct tsch_neighbor *n, struct tsch_packet *p,
     /* Failed transmission */
     if(p->transmissions >= p->max_transmissions) {
       /* Drop packet */
-      tsch_queue_remove_packet_from_queue(n);
+      remove_packet_of_class(n, p->priority);
       in_queue = 0;
     }
     /* Update CSMA state in the unicast case */
@@ -375,6 +419,25 @@ tsch_queue_packet_sent(struct tsch_neighbor *n, struct tsch_packet *p,
   return in_queue;
 }
 /*---------------------------------------------------------------------------*/
+#if TSCH_QUEUE_WITH_DEADLINES
+/* Has the packet stayed in the queue for longer than its lifetime? */
+int
+tsch_queue_packet_expired(const struct tsch_packet *p)
+{
+  return p->lifetime != 0
+    && (clock_time_t)(clock_time() - p->enqueued_at) > p->lifetime;
+}
+/*---------------------------------------------------------------------------*/
+/* Remove an expired packet from the head of its neighbor queue */
+void
+tsch_queue_drop_expired_packet(struct tsch_neighbor *n, struct tsch_packet *p)
+{
+  remove_packet_of_class(n, p->priority);
+  p->ret = MAC_TX_ERR;
+  tsch_stats_on_expiry(p->priority);
+}
+#endif /* TSCH_QUEUE_WITH_DEADLINES */
+/*---------------------------------------------------------------------------*/
 /* Flush all neighbor queues */
 void
 tsch_queue_reset(void)
@@ -417,31 +480,45 @@ tsch_queue_free_unused_neighbors(void)
 int
 tsch_queue_is_empty(const struct tsch_neighbor *n)
 {
-  return !tsch_is_locked() && n != NULL && ringbufindex_empty(&n->tx_ringbuf);
+  if(!tsch_is_locked() && n != NULL) {
+    int i;
+    for(i = 0; i < TSCH_QUEUE_NUM_PRIORITIES; i++) {
+      if(!ringbufindex_empty(&n->tx_ringbuf[i])) {
+        return 0;
+      }
+    }
+    return 1;
+  }
+  return 0;
 }
 /*---------------------------------------------------------------------------*/
-/* Returns the first packet from a neighbor queue */
+/* Returns the first packet from a neighbor queue, highest traffic class first */
 struct tsch_packet *
 tsch_queue_get_packet_for_nbr(const struct tsch_neighbor *n, struct tsch_link *link)
 {
   if(!tsch_is_locked()) {
     int is_shared_link = link != NULL && link->link_options & LINK_OPTION_SHARED;
-    if(n != NULL) {
-      int16_t get_index = ringbufindex_peek_get(&n->tx_ringbuf);
-      if(get_index != -1 &&
-          !(is_shared_link && !tsch_queue_backoff_expired(n))) {    /* If this is a shared link,
-                                                                    make sure the backoff has expired */
+    if(n != NULL &&
+        !(is_shared_link && !tsch_queue_backoff_expired(n))) {    /* If this is a shared link,
+                                                                  make sure the backoff has expired */
+      int i;
+      for(i = TSCH_QUEUE_NUM_PRIORITIES - 1; i >= 0; i--) {
+        int16_t get_index = ringbufindex_peek_get(&n->tx_ringbuf[i]);
+        if(get_index != -1) {
+          struct tsch_packet *p = n->tx_array[i][get_index];
 #if TSCH_WITH_LINK_SELECTOR
-        int packet_attr_slotframe = queuebuf_attr(n->tx_array[get_index]->qb, PACKETBUF_ATTR_TSCH_SLOTFRAME);
-        int packet_attr_timeslot = queuebuf_attr(n->tx_array[get_index]->qb, PACKETBUF_ATTR_TSCH_TIMESLOT);
-        if(packet_attr_slotframe != 0xffff && packet_attr_slotframe != link->slotframe_handle) {
-          return NULL;
-        }
-        if(packet_attr_timeslot != 0xffff && packet_attr_timeslot != link->timeslot) {
-          return NULL;
-        }
+          int packet_attr_slotframe = queuebuf_attr(p->qb, PACKETBUF_ATTR_TSCH_SLOTFRAME);
+          int packet_attr_timeslot = queuebuf_attr(p->qb, PACKETBUF_ATTR_TSCH_TIMESLOT);
+          if(packet_attr_slotframe != 0xffff && packet_attr_slotframe != link->slotframe_handle) {
+            /* Not for this link, try the next class */
+            continue;
+          }
+          if(packet_attr_timeslot != 0xffff && packet_attr_timeslot != link->timeslot) {
+            continue;
+          }
 #endif
-        return n->tx_array[get_index];
+          return p;
+        }
       }
     }
   }
@@ -459,26 +536,56 @@ tsch_queue_get_packet_for_dest_addr(const linkaddr_t *addr, struct tsch_link *li
 }
 /*---------------------------------------------------------------------------*/
 /* Returns the head packet of any neighbor queue with zero backoff counter.
- * Writes pointer to the neighbor in *n */
+ * The packet of the highest traffic class is returned; among equal classes,
+ * neighbors are served round-robin. Writes pointer to the neighbor in *n */
 struct tsch_packet *
 tsch_queue_get_unicast_packet_for_any(struct tsch_neighbor **n, struct tsch_link *link)
 {
   if(!tsch_is_locked()) {
-    struct tsch_neighbor *curr_nbr = (struct tsch_neighbor *)nbr_table_head(tsch_neighbors);
-    struct tsch_packet *p = NULL;
+    struct tsch_neighbor *head = (struct tsch_neighbor *)nbr_table_head(tsch_neighbors);
+    struct tsch_neighbor *first_nbr = NULL;
+    struct tsch_neighbor *curr_nbr;
+    struct tsch_neighbor *best_nbr = NULL;
+    struct tsch_packet *best = NULL;
+
+    /* Start right after the neighbor served last */
+    if(last_served_nbr != NULL) {
+      first_nbr = (struct tsch_neighbor *)nbr_table_next(tsch_neighbors, last_served_nbr);
+    }
+    if(first_nbr == NULL) {
+      first_nbr = head;
+    }
+
+    curr_nbr = first_nbr;
     while(curr_nbr != NULL) {
       if(!curr_nbr->is_broadcast && curr_nbr->tx_links_count == 0) {
         /* Only look up for non-broadcast neighbors we do not have a tx link to */
-        p = tsch_queue_get_packet_for_nbr(curr_nbr, link);
-        if(p != NULL) {
-          if(n != NULL) {
-            *n = curr_nbr;
+        struct tsch_packet *p = tsch_queue_get_packet_for_nbr(curr_nbr, link);
+        if(p != NULL && (best == NULL || p->priority > best->priority)) {
+          best = p;
+          best_nbr = curr_nbr;
+          if(p->priority == TSCH_QUEUE_NUM_PRIORITIES - 1) {
+            /* Nothing can beat this one */
+            break;
           }
-          return p;
         }
       }
       curr_nbr = (struct tsch_neighbor *)nbr_table_next(tsch_neighbors, curr_nbr);
+      if(curr_nbr == NULL) {
+        curr_nbr = head;
+      }
+      if(curr_nbr == first_nbr) {
+        break;
+      }
+    }
+
+    if(best != NULL) {
+      last_served_nbr = best_nbr;
+      if(n != NULL) {
+        *n = best_nbr;
+      }
     }
+    return best;
   }
   return NULL;
 }
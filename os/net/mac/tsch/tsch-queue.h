@@ -128,6 +128,21 @@ void tsch_queue_free_packets_to(const linkaddr_t *addr);
  * \return 1 if the packet remains in queue after the call, 0 if it was removed
  */
 int tsch_queue_packet_sent(struct tsch_neighbor *n, struct tsch_packet *p, struct tsch_link *link, uint8_t mac_tx_status);
+/**
+ * \brief Has a packet stayed in its queue for longer than its lifetime?
+ * Requires TSCH_QUEUE_WITH_DEADLINES
+ * \param p The packet
+ * \return 1 if the packet has expired, 0 otherwise
+ */
+int tsch_queue_packet_expired(const struct tsch_packet *p);
+/**
+ * \brief Remove an expired packet from the head of its neighbor queue. As with
+ * tsch_queue_packet_sent, the caller passes the packet on for later processing.
+ * Requires TSCH_QUEUE_WITH_DEADLINES
+ * \param n The neighbor queue
+ * \param p The expired packet, as returned by tsch_queue_get_packet_for_nbr
+ */
+void tsch_queue_drop_expired_packet(struct tsch_neighbor *n, struct tsch_packet *p);
 /**
  * \brief Reset neighbor queues module
  */
@@ -158,6 +173,7 @@ struct tsch_packet *tsch_queue_get_packet_for_nbr(const struct tsch_neighbor *n,
 struct tsch_packet *tsch_queue_get_packet_for_dest_addr(const linkaddr_t *addr, struct tsch_link *link);
 /**
  * \brief Gets the head packet of any neighbor queue with zero backoff counter.
+ * The highest traffic class wins; neighbors with equal classes are served round-robin.
  * \param n A pointer where to store the neighbor queue to be used for Tx
  * \param link The link to be used for Tx
  * \return The packet if any, else NULL
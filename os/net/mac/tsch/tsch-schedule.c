@@ -67,6 +67,80 @@ MEMB(link_memb, struct tsch_link, TSCH_SCHEDULE_MAX_LINKS);
 MEMB(slotframe_memb, struct tsch_slotframe, TSCH_SCHEDULE_MAX_SLOTFRAMES);
 /* List of slotframes (each slotframe holds its own list of links) */
 LIST(slotframe_list);
+/* Timeslot index of all links. Each slotframe owns a contiguous range
+ * (index_start, index_len), ranges follow the order of slotframe_list.
+ * Within a range, links are sorted by timeslot; links sharing a timeslot
+ * keep their links_list order so that ties are broken as by a linear scan. */
+static struct tsch_link *link_index[TSCH_SCHEDULE_MAX_LINKS];
+static uint16_t link_index_len;
+
+/*---------------------------------------------------------------------------*/
+/* Returns the position of the first link of the slotframe with a timeslot
+ * greater than the given one, index_len if there is none */
+static uint16_t
+link_index_upper_bound(const struct tsch_slotframe *sf, uint16_t timeslot)
+{
+  uint16_t lo = 0;
+  uint16_t hi = sf->index_len;
+  struct tsch_link **links = &link_index[sf->index_start];
+
+  while(lo < hi) {
+    uint16_t mid = (lo + hi) / 2;
+    if(links[mid]->timeslot > timeslot) {
+      hi = mid;
+    } else {
+      lo = mid + 1;
+    }
+  }
+  return lo;
+}
+/*---------------------------------------------------------------------------*/
+/* Shifts the ranges of the slotframes following sf by delta */
+static void
+link_index_shift_after(struct tsch_slotframe *sf, int delta)
+{
+  for(sf = list_item_next(sf); sf != NULL; sf = list_item_next(sf)) {
+    sf->index_start += delta;
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* Adds a link to the index, after the links with the same timeslot.
+ * Called with the lock held. */
+static void
+link_index_add(struct tsch_slotframe *sf, struct tsch_link *l)
+{
+  uint16_t pos = sf->index_start + link_index_upper_bound(sf, l->timeslot);
+
+  memmove(&link_index[pos + 1], &link_index[pos],
+          (link_index_len - pos) * sizeof(link_index[0]));
+  link_index[pos] = l;
+  link_index_len++;
+  sf->index_len++;
+  link_index_shift_after(sf, 1);
+}
+/*---------------------------------------------------------------------------*/
+/* Removes a link from the index. Called with the lock held. */
+static void
+link_index_remove(struct tsch_slotframe *sf, struct tsch_link *l)
+{
+  uint16_t pos = sf->index_start + link_index_upper_bound(sf, l->timeslot);
+
+  /* The link is among those with the same timeslot, just before pos */
+  while(pos > sf->index_start && link_index[pos - 1] != l) {
+    pos--;
+  }
+  if(pos == sf->index_start) {
+    return;
+  }
+  pos--;
+
+  memmove(&link_index[pos], &link_index[pos + 1],
+          (link_index_len - pos - 1) * sizeof(link_index[0]));
+  link_index_len--;
+  sf->index_len--;
+  link_index_shift_after(sf, -1);
+}
+/*---------------------------------------------------------------------------*/
 
 /* Adds and returns a slotframe (NULL if failure) */
 struct tsch_slotframe *
@@ -88,6 +162,9 @@ tsch_schedule_add_slotframe(uint16_t handle, uint16_t size)
       sf->handle = handle;
       TSCH_ASN_DIVISOR_INIT(sf->size, size);
       LIST_STRUCT_INIT(sf, links_list);
+      /* The slotframe goes last, so does its (empty) index range */
+      sf->index_start = link_index_len;
+      sf->index_len = 0;
       /* Add the slotframe to the global list */
       list_add(slotframe_list, sf);
     }
@@ -256,6 +333,7 @@ tsch_schedule_add_link(struct tsch_slotframe *slotframe,
           address = &linkaddr_null;
         }
         linkaddr_copy(&l->addr, address);
+        link_index_add(slotframe, l);
 
         LOG_INFO("add_link sf=%u opt=%s type=%s ts=%u ch=%u addr=",
                  slotframe->handle,
@@ -308,6 +386,7 @@ tsch_schedule_remove_link(struct tsch_slotframe *slotframe, struct tsch_link *l)
       LOG_INFO_LLADDR(&l->addr);
       LOG_INFO_("\n");
 
+      link_index_remove(slotframe, l);
       list_remove(slotframe->links_list, l);
       memb_free(&link_memb, l);
 
@@ -364,15 +443,19 @@ tsch_schedule_get_link_by_timeslot(struct tsch_slotframe *slotframe,
 {
   if(!tsch_is_locked()) {
     if(slotframe != NULL) {
-      struct tsch_link *l = list_head(slotframe->links_list);
-      /* Loop over all items. Assume there is max one link per timeslot and channel_offset */
-      while(l != NULL) {
-        if(l->timeslot == timeslot && l->channel_offset == channel_offset) {
-          return l;
+      struct tsch_link **links = &link_index[slotframe->index_start];
+      uint16_t i = link_index_upper_bound(slotframe, timeslot);
+      /* Walk back over the links at this timeslot, the first match in list
+       * order is the last one found. Assume there is max one link per
+       * timeslot and channel_offset */
+      struct tsch_link *match = NULL;
+      while(i > 0 && links[i - 1]->timeslot == timeslot) {
+        i--;
+        if(links[i]->channel_offset == channel_offset) {
+          match = links[i];
         }
-        l = list_item_next(l);
       }
-      return l;
+      return match;
     }
   }
   return NULL;
@@ -390,8 +473,8 @@ default_tsch_link_comparator(struct tsch_link *a, struct tsch_link *b)
   if(!linkaddr_cmp(&a->addr, &b->addr)) {
     struct tsch_neighbor *an = tsch_queue_get_nbr(&a->addr);
     struct tsch_neighbor *bn = tsch_queue_get_nbr(&b->addr);
-    int a_packet_count = an ? ringbufindex_elements(&an->tx_ringbuf) : 0;
-    int b_packet_count = bn ? ringbufindex_elements(&bn->tx_ringbuf) : 0;
+    int a_packet_count = an ? tsch_queue_nbr_packet_count(an) : 0;
+    int b_packet_count = bn ? tsch_queue_nbr_packet_count(bn) : 0;
     /* Compare the number of packets in the queue */
     return a_packet_count >= b_packet_count ? a : b;
   }
@@ -400,87 +483,115 @@ default_tsch_link_comparator(struct tsch_link *a, struct tsch_link *b)
   return a;
 }
 
+/*---------------------------------------------------------------------------*/
+/* Candidate state of tsch_schedule_get_next_active_link() */
+struct next_link_selection {
+  uint16_t time_to_curr_best;
+  struct tsch_link *curr_best;
+  struct tsch_link *curr_backup; /* Keep a back link in case the current link
+  turns out useless when the time comes. For instance, for a Tx-only link, if there is
+  no outgoing packet in queue. In that case, run the backup link instead. The backup link
+  must have Rx flag set. */
+};
+/*---------------------------------------------------------------------------*/
+/* Considers link l, occurring in time_to_timeslot slots, as the next active link */
+static void
+select_next_link(struct next_link_selection *sel, struct tsch_link *l,
+                 uint16_t time_to_timeslot)
+{
+  struct tsch_link *curr_best = sel->curr_best;
+
+  if(curr_best == NULL || time_to_timeslot < sel->time_to_curr_best) {
+    sel->time_to_curr_best = time_to_timeslot;
+    sel->curr_best = l;
+    sel->curr_backup = NULL;
+  } else if(time_to_timeslot == sel->time_to_curr_best) {
+    struct tsch_link *new_best = NULL;
+    /* Two links are overlapping, we need to select one of them.
+     * By standard: prioritize Tx links first, second by lowest handle */
+    if((curr_best->link_options & LINK_OPTION_TX) == (l->link_options & LINK_OPTION_TX)) {
+      /* Both or neither links have Tx, select the one with lowest handle */
+      if(l->slotframe_handle != curr_best->slotframe_handle) {
+        if(l->slotframe_handle < curr_best->slotframe_handle) {
+          new_best = l;
+        }
+      } else {
+        /* compare the link against the current best link and return the newly selected one */
+        new_best = TSCH_LINK_COMPARATOR(curr_best, l);
+      }
+    } else {
+      /* Select the link that has the Tx option */
+      if(l->link_options & LINK_OPTION_TX) {
+        new_best = l;
+      }
+    }
+
+    /* Maintain backup_link */
+    /* Check if 'l' best can be used as backup */
+    if(new_best != l && (l->link_options & LINK_OPTION_RX)) { /* Does 'l' have Rx flag? */
+      if(sel->curr_backup == NULL || l->slotframe_handle < sel->curr_backup->slotframe_handle) {
+        sel->curr_backup = l;
+      }
+    }
+    /* Check if curr_best can be used as backup */
+    if(new_best != curr_best && (curr_best->link_options & LINK_OPTION_RX)) { /* Does curr_best have Rx flag? */
+      if(sel->curr_backup == NULL || curr_best->slotframe_handle < sel->curr_backup->slotframe_handle) {
+        sel->curr_backup = curr_best;
+      }
+    }
+
+    /* Maintain curr_best */
+    if(new_best != NULL) {
+      sel->curr_best = new_best;
+    }
+  }
+}
 /*---------------------------------------------------------------------------*/
 /* Returns the next active link after a given ASN, and a backup link (for the same ASN, with Rx flag) */
 struct tsch_link *
 tsch_schedule_get_next_active_link(struct tsch_asn_t *asn, uint16_t *time_offset,
     struct tsch_link **backup_link)
 {
-  uint16_t time_to_curr_best = 0;
-  struct tsch_link *curr_best = NULL;
-  struct tsch_link *curr_backup = NULL; /* Keep a back link in case the current link
-  turns out useless when the time comes. For instance, for a Tx-only link, if there is
-  no outgoing packet in queue. In that case, run the backup link instead. The backup link
-  must have Rx flag set. */
+  struct next_link_selection sel = { 0, NULL, NULL };
+
   if(!tsch_is_locked()) {
     struct tsch_slotframe *sf = list_head(slotframe_list);
-    /* For each slotframe, look for the earliest occurring link */
+    /* For each slotframe, look for the earliest occurring links. Only these
+     * can win, so they are the only ones handed to select_next_link(),
+     * in links_list order. */
     while(sf != NULL) {
-      /* Get timeslot from ASN, given the slotframe length */
-      uint16_t timeslot = TSCH_ASN_MOD(*asn, sf->size);
-      struct tsch_link *l = list_head(sf->links_list);
-      while(l != NULL) {
-        uint16_t time_to_timeslot =
-          l->timeslot > timeslot ?
-          l->timeslot - timeslot :
-          sf->size.val + l->timeslot - timeslot;
-        if(curr_best == NULL || time_to_timeslot < time_to_curr_best) {
-          time_to_curr_best = time_to_timeslot;
-          curr_best = l;
-          curr_backup = NULL;
-        } else if(time_to_timeslot == time_to_curr_best) {
-          struct tsch_link *new_best = NULL;
-          /* Two links are overlapping, we need to select one of them.
-           * By standard: prioritize Tx links first, second by lowest handle */
-          if((curr_best->link_options & LINK_OPTION_TX) == (l->link_options & LINK_OPTION_TX)) {
-            /* Both or neither links have Tx, select the one with lowest handle */
-            if(l->slotframe_handle != curr_best->slotframe_handle) {
-              if(l->slotframe_handle < curr_best->slotframe_handle) {
-                new_best = l;
-              }
-            } else {
-              /* compare the link against the current best link and return the newly selected one */
-              new_best = TSCH_LINK_COMPARATOR(curr_best, l);
-            }
-          } else {
-            /* Select the link that has the Tx option */
-            if(l->link_options & LINK_OPTION_TX) {
-              new_best = l;
-            }
-          }
-
-          /* Maintain backup_link */
-          /* Check if 'l' best can be used as backup */
-          if(new_best != l && (l->link_options & LINK_OPTION_RX)) { /* Does 'l' have Rx flag? */
-            if(curr_backup == NULL || l->slotframe_handle < curr_backup->slotframe_handle) {
-              curr_backup = l;
-            }
-          }
-          /* Check if curr_best can be used as backup */
-          if(new_best != curr_best && (curr_best->link_options & LINK_OPTION_RX)) { /* Does curr_best have Rx flag? */
-            if(curr_backup == NULL || curr_best->slotframe_handle < curr_backup->slotframe_handle) {
-              curr_backup = curr_best;
-            }
-          }
-
-          /* Maintain curr_best */
-          if(new_best != NULL) {
-            curr_best = new_best;
-          }
+      if(sf->index_len > 0) {
+        /* Get timeslot from ASN, given the slotframe length */
+        uint16_t timeslot = TSCH_ASN_MOD(*asn, sf->size);
+        struct tsch_link **links = &link_index[sf->index_start];
+        uint16_t i = link_index_upper_bound(sf, timeslot);
+        uint16_t next_timeslot;
+        uint16_t time_to_timeslot;
+
+        if(i == sf->index_len) {
+          /* No link later in this slotframe, wrap around */
+          i = 0;
+        }
+        next_timeslot = links[i]->timeslot;
+        time_to_timeslot =
+          next_timeslot > timeslot ?
+          next_timeslot - timeslot :
+          sf->size.val + next_timeslot - timeslot;
+
+        for(; i < sf->index_len && links[i]->timeslot == next_timeslot; i++) {
+          select_next_link(&sel, links[i], time_to_timeslot);
         }
-
-        l = list_item_next(l);
       }
       sf = list_item_next(sf);
     }
     if(time_offset != NULL) {
-      *time_offset = time_to_curr_best;
+      *time_offset = sel.time_to_curr_best;
     }
   }
   if(backup_link != NULL) {
-    *backup_link = curr_backup;
+    *backup_link = sel.curr_backup;
   }
-  return curr_best;
+  return sel.curr_best;
 }
 /*---------------------------------------------------------------------------*/
 /* Module initialization, call only once at startup. Returns 1 is success, 0 if failure. */
@@ -491,6 +602,7 @@ tsch_schedule_init(void)
     memb_init(&link_memb);
     memb_init(&slotframe_memb);
     list_init(slotframe_list);
+    link_index_len = 0;
     tsch_release_lock();
     return 1;
   } else {
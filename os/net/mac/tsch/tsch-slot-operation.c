@@ -53,6 +53,7 @@
 #include "net/mac/framer/framer-802154.h"
 #include "net/mac/tsch/tsch.h"
 #include "sys/critical.h"
+#include "sys/profile.h"
 #if BUILD_WITH_JAMSENSE
 #include "services/jamsense/specksense.h"
 #endif 
@@ -190,6 +191,10 @@ static struct pt slot_operation_pt;
 static PT_THREAD(tsch_tx_slot(struct pt *pt, struct rtimer *t));
 static PT_THREAD(tsch_rx_slot(struct pt *pt, struct rtimer *t));
 
+/* Whole TX and RX slot operations */
+PROFILE_PROBE(tx_slot_probe, "tsch-tx-slot");
+PROFILE_PROBE(rx_slot_probe, "tsch-rx-slot");
+
 /*---------------------------------------------------------------------------*/
 /* TSCH locking system. TSCH is locked during slot operations */
 
@@ -352,7 +357,7 @@ tsch_schedule_slot_operation(struct rtimer *tm, rtimer_clock_t ref_time, rtimer_
 /*---------------------------------------------------------------------------*/
 /* Get EB, broadcast or unicast packet to be sent, and target neighbor. */
 static struct tsch_packet *
-get_packet_and_neighbor_for_link(struct tsch_link *link, struct tsch_neighbor **target_neighbor)
+find_packet_and_neighbor_for_link(struct tsch_link *link, struct tsch_neighbor **target_neighbor)
 {
   struct tsch_packet *p = NULL;
   struct tsch_neighbor *n = NULL;
@@ -386,6 +391,55 @@ get_packet_and_neighbor_for_link(struct tsch_link *link, struct tsch_neighbor **
   return p;
 }
 /*---------------------------------------------------------------------------*/
+#if TSCH_QUEUE_WITH_DEADLINES
+/* Dequeue the packet if it has expired. It is then passed to the upper
+ * layer via dequeued_ringbuf, like packets that ran out of retransmissions.
+ * Returns 1 if the packet was dropped */
+static int
+drop_expired_packet(struct tsch_neighbor *n, struct tsch_packet *p)
+{
+  int16_t dequeued_index;
+
+  if(!tsch_queue_packet_expired(p)) {
+    return 0;
+  }
+  dequeued_index = ringbufindex_peek_put(&dequeued_ringbuf);
+  if(dequeued_index == -1) {
+    /* No room to dequeue it; transmit it anyway */
+    return 0;
+  }
+  tsch_queue_drop_expired_packet(n, p);
+  dequeued_array[dequeued_index] = p;
+  ringbufindex_put(&dequeued_ringbuf);
+  /* Poll process for later processing of the packet sent event */
+  process_poll(&tsch_pending_events_process);
+  return 1;
+}
+#endif /* TSCH_QUEUE_WITH_DEADLINES */
+/*---------------------------------------------------------------------------*/
+/* Get the packet to be sent on a link and its target neighbor, skipping
+ * packets whose deadline has passed */
+static struct tsch_packet *
+get_packet_and_neighbor_for_link(struct tsch_link *link, struct tsch_neighbor **target_neighbor)
+{
+  struct tsch_neighbor *n = NULL;
+  struct tsch_packet *p = find_packet_and_neighbor_for_link(link, &n);
+#if TSCH_QUEUE_WITH_DEADLINES
+  /* Bound the number of drops to keep the slot operation short */
+  int drops = 0;
+  while(p != NULL && drops < TSCH_QUEUE_MAX_EXPIRED_PER_SLOT
+        && drop_expired_packet(n, p)) {
+    drops++;
+    p = find_packet_and_neighbor_for_link(link, &n);
+  }
+#endif /* TSCH_QUEUE_WITH_DEADLINES */
+  /* return nbr (by reference) */
+  if(target_neighbor != NULL) {
+    *target_neighbor = n;
+  }
+  return p;
+}
+/*---------------------------------------------------------------------------*/
 static
 void update_link_backoff(struct tsch_link *link) {
   if(link != NULL
@@ -1113,11 +1167,15 @@ PT_THREAD(tsch_slot_operation(struct rtimer *t, void *ptr))
            * 3. post tx callback
            **/
           static struct pt slot_tx_pt;
+          PROFILE_BEGIN(tx_slot_probe);
           PT_SPAWN(&slot_operation_pt, &slot_tx_pt, tsch_tx_slot(&slot_tx_pt, t));
+          PROFILE_END(tx_slot_probe);
         } else {
           /* Listen */
           static struct pt slot_rx_pt;
+          PROFILE_BEGIN(rx_slot_probe);
           PT_SPAWN(&slot_operation_pt, &slot_rx_pt, tsch_rx_slot(&slot_rx_pt, t));
+          PROFILE_END(rx_slot_probe);
         }
       } else {
         /* Make sure to end the burst in cast, for some reason, we were
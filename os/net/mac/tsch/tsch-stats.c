@@ -137,6 +137,26 @@ tsch_stats_on_time_synchronization(int32_t sync_error)
 }
 /*---------------------------------------------------------------------------*/
 void
+tsch_stats_on_enqueue(uint8_t priority, uint8_t success)
+{
+  if(priority < TSCH_QUEUE_NUM_PRIORITIES) {
+    if(success) {
+      tsch_stats.queue_enqueued[priority]++;
+    } else {
+      tsch_stats.queue_full[priority]++;
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+void
+tsch_stats_on_expiry(uint8_t priority)
+{
+  if(priority < TSCH_QUEUE_NUM_PRIORITIES) {
+    tsch_stats.queue_expired[priority]++;
+  }
+}
+/*---------------------------------------------------------------------------*/
+void
 tsch_stats_sample_rssi(void)
 {
 #if TSCH_STATS_SAMPLE_NOISE_RSSI
@@ -149,6 +149,12 @@ struct tsch_global_stats {
   /* derived from `noise_rssi` and BUSY_CHANNEL_RSSI */
   tsch_stat_t channel_free_ewma[TSCH_STATS_NUM_CHANNELS];
 #endif /* TSCH_STATS_SAMPLE_NOISE_RSSI */
+  /* per traffic class: packets queued for transmission */
+  uint32_t queue_enqueued[TSCH_QUEUE_NUM_PRIORITIES];
+  /* per traffic class: packets rejected by a full queue */
+  uint32_t queue_full[TSCH_QUEUE_NUM_PRIORITIES];
+  /* per traffic class: packets dropped because their deadline passed */
+  uint32_t queue_expired[TSCH_QUEUE_NUM_PRIORITIES];
 };
 
 struct tsch_channel_stats {
@@ -194,6 +200,10 @@ struct tsch_neighbor_stats *tsch_stats_get_from_neighbor(struct tsch_neighbor *)
 
 void tsch_stats_reset_neighbor_stats(void);
 
+void tsch_stats_on_enqueue(uint8_t priority, uint8_t success);
+
+void tsch_stats_on_expiry(uint8_t priority);
+
 #else /* TSCH_STATS_ON */
 
 #define tsch_stats_init()
@@ -203,6 +213,8 @@ void tsch_stats_reset_neighbor_stats(void);
 #define tsch_stats_sample_rssi()
 #define tsch_stats_get_from_neighbor(neighbor) NULL
 #define tsch_stats_reset_neighbor_stats()
+#define tsch_stats_on_enqueue(priority, success)
+#define tsch_stats_on_expiry(priority)
 
 #endif /* TSCH_STATS_ON */
 
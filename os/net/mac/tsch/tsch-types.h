@@ -91,6 +91,10 @@ struct tsch_slotframe {
   struct tsch_asn_divisor_t size;
   /* List of links belonging to this slotframe */
   LIST_STRUCT(links_list);
+  /* Position and number of this slotframe's links in the schedule's
+   * timeslot index, see tsch-schedule.c */
+  uint16_t index_start;
+  uint16_t index_len;
 };
 
 /** \brief TSCH packet information */
@@ -103,6 +107,11 @@ struct tsch_packet {
   uint8_t ret; /* status -- MAC return code */
   uint8_t header_len; /* length of header and header IEs (needed for link-layer security) */
   uint8_t tsch_sync_ie_offset; /* Offset within the frame used for quick update of EB ASN and join priority */
+  uint8_t priority; /* traffic class, selects the neighbor ring the packet is queued in */
+#if TSCH_QUEUE_WITH_DEADLINES
+  uint16_t lifetime; /* max. time in the queue in clock ticks, 0 for none */
+  clock_time_t enqueued_at; /* time at which the packet was queued */
+#endif /* TSCH_QUEUE_WITH_DEADLINES */
 };
 
 /** \brief TSCH neighbor information */
@@ -114,11 +123,11 @@ struct tsch_neighbor {
   uint8_t last_backoff_window; /* Last CSMA backoff window */
   uint8_t tx_links_count; /* How many links do we have to this neighbor? */
   uint8_t dedicated_tx_links_count; /* How many dedicated links do we have to this neighbor? */
-  /* Array for the ringbuf. Contains pointers to packets.
-   * Its size must be a power of two to allow for atomic put */
-  struct tsch_packet *tx_array[TSCH_QUEUE_NUM_PER_NEIGHBOR];
-  /* Circular buffer of pointers to packet. */
-  struct ringbufindex tx_ringbuf;
+  /* Arrays for the ringbufs, one per traffic class. Contain pointers to packets.
+   * Their size must be a power of two to allow for atomic put */
+  struct tsch_packet *tx_array[TSCH_QUEUE_NUM_PRIORITIES][TSCH_QUEUE_NUM_PER_NEIGHBOR];
+  /* Circular buffers of pointers to packet, one per traffic class. */
+  struct ringbufindex tx_ringbuf[TSCH_QUEUE_NUM_PRIORITIES];
 };
 
 /** \brief TSCH timeslot timing elements. Used to index timeslot timing
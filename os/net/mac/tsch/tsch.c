@@ -324,6 +324,8 @@ keepalive_send(void *ptr)
         /* Simply send an empty packet */
         packetbuf_clear();
         packetbuf_set_addr(PACKETBUF_ADDR_RECEIVER, destination);
+        packetbuf_set_attr(PACKETBUF_ATTR_MAC_PRIORITY,
+                           PACKETBUF_ATTR_MAC_PRIORITY_CONTROL);
         NETSTACK_MAC.send(keepalive_packet_sent, NULL);
         LOG_INFO("sending KA to ");
         LOG_INFO_LLADDR(destination);
@@ -1229,6 +1231,7 @@ turn_on(void)
   if(tsch_is_initialized == 1 && tsch_is_started == 0) {
     tsch_is_started = 1;
     /* Process tx/rx callback and log messages whenever polled */
+    process_set_priority(&tsch_pending_events_process, PROCESS_PRIORITY_HIGH);
     process_start(&tsch_pending_events_process, NULL);
     if(TSCH_EB_PERIOD > 0) {
       /* periodically send TSCH EBs */
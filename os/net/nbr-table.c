@@ -70,6 +70,20 @@ static unsigned num_tables;
 MEMB(neighbor_addr_mem, nbr_table_key_t, NBR_TABLE_MAX_NEIGHBORS);
 LIST(nbr_table_keys);
 
+#if NBR_TABLE_WITH_INDEX
+#if NBR_TABLE_INDEX_SIZE <= NBR_TABLE_MAX_NEIGHBORS
+#error NBR_TABLE_CONF_INDEX_SIZE must be larger than NBR_TABLE_CONF_MAX_NEIGHBORS
+#endif
+#if NBR_TABLE_MAX_NEIGHBORS < 255
+typedef uint8_t index_slot_t;
+#else
+typedef uint16_t index_slot_t;
+#endif
+/* Link-layer address hash table with linear probing. A slot holds the
+ * neighbor index plus one, 0 for an empty slot. */
+static index_slot_t lladdr_index[NBR_TABLE_INDEX_SIZE];
+#endif /* NBR_TABLE_WITH_INDEX */
+
 /*---------------------------------------------------------------------------*/
 static void remove_key(nbr_table_key_t *key, bool do_free);
 /*---------------------------------------------------------------------------*/
@@ -115,16 +129,82 @@ key_from_item(nbr_table_t *table, const nbr_table_item_t *item)
   return key_from_index(index_from_item(table, item));
 }
 /*---------------------------------------------------------------------------*/
+#if NBR_TABLE_WITH_INDEX
+/* Home slot of a link-layer address in the index */
+static unsigned
+index_slot(const linkaddr_t *lladdr)
+{
+  uint32_t h = 0;
+  int i;
+
+  for(i = 0; i < LINKADDR_SIZE; i++) {
+    h = h * 31 + lladdr->u8[i];
+  }
+  return h % NBR_TABLE_INDEX_SIZE;
+}
+/*---------------------------------------------------------------------------*/
+static void
+index_add(nbr_table_key_t *key)
+{
+  unsigned i = index_slot(&key->lladdr);
+
+  while(lladdr_index[i] != 0) {
+    i = (i + 1) % NBR_TABLE_INDEX_SIZE;
+  }
+  lladdr_index[i] = index_from_key(key) + 1;
+}
+/*---------------------------------------------------------------------------*/
+static void
+index_remove(nbr_table_key_t *key)
+{
+  unsigned i = index_slot(&key->lladdr);
+  unsigned j;
+  unsigned home;
+
+  while(lladdr_index[i] != index_from_key(key) + 1) {
+    if(lladdr_index[i] == 0) {
+      return;
+    }
+    i = (i + 1) % NBR_TABLE_INDEX_SIZE;
+  }
+
+  /* Move back the following entries of the probe run that would no
+   * longer be reachable from their home slot once slot i is empty */
+  for(j = (i + 1) % NBR_TABLE_INDEX_SIZE; lladdr_index[j] != 0;
+      j = (j + 1) % NBR_TABLE_INDEX_SIZE) {
+    home = index_slot(&key_from_index(lladdr_index[j] - 1)->lladdr);
+    if((j > i && (home <= i || home > j)) ||
+       (j < i && home <= i && home > j)) {
+      lladdr_index[i] = lladdr_index[j];
+      i = j;
+    }
+  }
+  lladdr_index[i] = 0;
+}
+#endif /* NBR_TABLE_WITH_INDEX */
+/*---------------------------------------------------------------------------*/
 /* Get the index of a neighbor from its link-layer address */
 static int
 index_from_lladdr(const linkaddr_t *lladdr)
 {
   nbr_table_key_t *key;
+#if NBR_TABLE_WITH_INDEX
+  unsigned i;
+#endif /* NBR_TABLE_WITH_INDEX */
   /* Allow lladdr-free insertion, useful e.g. for IPv6 ND.
    * Only one such entry is possible at a time, indexed by linkaddr_null. */
   if(lladdr == NULL) {
     lladdr = &linkaddr_null;
   }
+#if NBR_TABLE_WITH_INDEX
+  for(i = index_slot(lladdr); lladdr_index[i] != 0;
+      i = (i + 1) % NBR_TABLE_INDEX_SIZE) {
+    key = key_from_index(lladdr_index[i] - 1);
+    if(linkaddr_cmp(lladdr, &key->lladdr)) {
+      return lladdr_index[i] - 1;
+    }
+  }
+#else /* NBR_TABLE_WITH_INDEX */
   key = list_head(nbr_table_keys);
   while(key != NULL) {
     if(lladdr && linkaddr_cmp(lladdr, &key->lladdr)) {
@@ -132,6 +212,7 @@ index_from_lladdr(const linkaddr_t *lladdr)
     }
     key = list_item_next(key);
   }
+#endif /* NBR_TABLE_WITH_INDEX */
   return -1;
 }
 /*---------------------------------------------------------------------------*/
@@ -185,6 +266,9 @@ remove_key(nbr_table_key_t *key, bool do_free)
   locked_map[index_from_key(key)] = 0;
   /* Remove neighbor from list */
   list_remove(nbr_table_keys, key);
+#if NBR_TABLE_WITH_INDEX
+  index_remove(key);
+#endif /* NBR_TABLE_WITH_INDEX */
   if(do_free) {
     /* Release the memory */
     memb_free(&neighbor_addr_mem, key);
@@ -426,6 +510,9 @@ nbr_table_add_lladdr(nbr_table_t *table, const linkaddr_t *lladdr, nbr_table_rea
 
     /* Set link-layer address */
     linkaddr_copy(&key->lladdr, lladdr);
+#if NBR_TABLE_WITH_INDEX
+    index_add(key);
+#endif /* NBR_TABLE_WITH_INDEX */
   }
 
   /* Get item in the current table */
@@ -55,6 +55,22 @@ typedef enum {
 
 #define NBR_TABLE_MAX_NEIGHBORS NBR_TABLE_CONF_MAX_NEIGHBORS
 
+/* Index neighbors by link-layer address in an open-addressing hash table,
+ * for constant-time lookups instead of a walk of all neighbors */
+#ifdef NBR_TABLE_CONF_WITH_INDEX
+#define NBR_TABLE_WITH_INDEX NBR_TABLE_CONF_WITH_INDEX
+#else /* NBR_TABLE_CONF_WITH_INDEX */
+#define NBR_TABLE_WITH_INDEX 1
+#endif /* NBR_TABLE_CONF_WITH_INDEX */
+
+/* Number of slots in the index, at least NBR_TABLE_MAX_NEIGHBORS + 1.
+ * Each slot takes one byte, or two with more than 254 neighbors. */
+#ifdef NBR_TABLE_CONF_INDEX_SIZE
+#define NBR_TABLE_INDEX_SIZE NBR_TABLE_CONF_INDEX_SIZE
+#else /* NBR_TABLE_CONF_INDEX_SIZE */
+#define NBR_TABLE_INDEX_SIZE (2 * NBR_TABLE_MAX_NEIGHBORS)
+#endif /* NBR_TABLE_CONF_INDEX_SIZE */
+
 #ifdef NBR_TABLE_CONF_GC_GET_WORST
 #define NBR_TABLE_GC_GET_WORST NBR_TABLE_CONF_GC_GET_WORST
 #else /* NBR_TABLE_CONF_GC_GET_WORST */
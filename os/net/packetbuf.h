@@ -209,6 +209,12 @@ struct packetbuf_addr {
 #define PACKETBUF_ATTR_PACKET_TYPE_STREAM_END 3
 #define PACKETBUF_ATTR_PACKET_TYPE_TIMESTAMP 4
 
+/* Traffic classes for PACKETBUF_ATTR_MAC_PRIORITY. MAC layers that
+   queue per class serve higher values first. */
+#define PACKETBUF_ATTR_MAC_PRIORITY_DATA     0
+#define PACKETBUF_ATTR_MAC_PRIORITY_LATENCY  1
+#define PACKETBUF_ATTR_MAC_PRIORITY_CONTROL  2
+
 enum {
   PACKETBUF_ATTR_NONE,
 
@@ -224,6 +230,8 @@ enum {
   PACKETBUF_ATTR_MAC_METADATA,
   PACKETBUF_ATTR_MAC_NO_SRC_ADDR,
   PACKETBUF_ATTR_MAC_NO_DEST_ADDR,
+  PACKETBUF_ATTR_MAC_PRIORITY,
+  PACKETBUF_ATTR_MAC_LIFETIME, /* max. queueing time in clock ticks, 0: none */
 #if TSCH_WITH_LINK_SELECTOR
   PACKETBUF_ATTR_TSCH_SLOTFRAME,
   PACKETBUF_ATTR_TSCH_TIMESLOT,
@@ -105,6 +105,9 @@ void queuebuf_update_attr_from_packetbuf(struct queuebuf *b);
 void queuebuf_update_from_packetbuf(struct queuebuf *b);
 
 void queuebuf_to_packetbuf(struct queuebuf *b);
+/* Copy only the attributes and addresses of a queuebuf to the
+   packetbuf, for frames sent from queuebuf_dataptr() */
+void queuebuf_attr_to_packetbuf(struct queuebuf *b);
 void queuebuf_free(struct queuebuf *b);
 
 void *queuebuf_dataptr(struct queuebuf *b);
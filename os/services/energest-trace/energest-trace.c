@@ -0,0 +1,215 @@
+/*
+ * Copyright (c) 2026, Contiki-NG contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \addtogroup energest-trace
+ * @{
+ *
+ * \file
+ *         A process that periodically writes the Energest times as
+ *         binary frames
+ */
+
+#include "contiki.h"
+#include "sys/energest.h"
+#include "lib/crc16.h"
+#include "energest-trace.h"
+#if ENERGEST_TRACE_OUTPUT == ENERGEST_TRACE_OUTPUT_CFS
+#include "cfs/cfs.h"
+#endif /* ENERGEST_TRACE_OUTPUT == ENERGEST_TRACE_OUTPUT_CFS */
+
+#include <stdio.h>
+#include <string.h>
+
+/* Log configuration */
+#include "sys/log.h"
+#define LOG_MODULE "Energest"
+#define LOG_LEVEL LOG_LEVEL_INFO
+
+#if ENERGEST_WITH_PROCESSES
+#define NUM_ENTRIES (ENERGEST_PROCESSES_MAX + 1)
+#else /* ENERGEST_WITH_PROCESSES */
+#define NUM_ENTRIES 1
+#endif /* ENERGEST_WITH_PROCESSES */
+
+#define HEADER_LEN  5
+#define CRC_LEN     2
+#define FRAME_MAX   (HEADER_LEN + 14 + CRC_LEN + NUM_ENTRIES * \
+                     (1 + ENERGEST_TRACE_NAME_LEN + 4 * ENERGEST_TYPE_MAX))
+
+static uint8_t frame[FRAME_MAX];
+static uint32_t last_times[NUM_ENTRIES][ENERGEST_TYPE_MAX];
+static uint32_t last_total;
+static uint32_t sequence;
+
+PROCESS(energest_trace_process, "Energest trace");
+/*---------------------------------------------------------------------------*/
+static uint8_t *
+put_u16(uint8_t *p, uint16_t v)
+{
+  *p++ = v & 0xff;
+  *p++ = v >> 8;
+  return p;
+}
+/*---------------------------------------------------------------------------*/
+static uint8_t *
+put_u32(uint8_t *p, uint32_t v)
+{
+  p = put_u16(p, v & 0xffff);
+  return put_u16(p, v >> 16);
+}
+/*---------------------------------------------------------------------------*/
+static int
+entry_count(void)
+{
+#if ENERGEST_WITH_PROCESSES
+  return energest_process_count();
+#else /* ENERGEST_WITH_PROCESSES */
+  return 1;
+#endif /* ENERGEST_WITH_PROCESSES */
+}
+/*---------------------------------------------------------------------------*/
+static uint32_t
+entry_time(int entry, energest_type_t type)
+{
+#if ENERGEST_WITH_PROCESSES
+  return energest_process_time(entry, type);
+#else /* ENERGEST_WITH_PROCESSES */
+  return (uint32_t)energest_type_time(type);
+#endif /* ENERGEST_WITH_PROCESSES */
+}
+/*---------------------------------------------------------------------------*/
+static const char *
+entry_name(int entry)
+{
+#if ENERGEST_WITH_PROCESSES
+  struct process *p = energest_process_get(entry);
+  if(p != NULL) {
+    return PROCESS_NAME_STRING(p);
+  }
+#endif /* ENERGEST_WITH_PROCESSES */
+  return "";
+}
+/*---------------------------------------------------------------------------*/
+static void
+output(const uint8_t *data, int len)
+{
+#if ENERGEST_TRACE_OUTPUT == ENERGEST_TRACE_OUTPUT_CFS
+  int fd = cfs_open(ENERGEST_TRACE_FILE, CFS_WRITE | CFS_APPEND);
+  if(fd < 0) {
+    LOG_WARN("cannot open %s\n", ENERGEST_TRACE_FILE);
+    return;
+  }
+  if(cfs_write(fd, data, len) != len) {
+    LOG_WARN("cannot write %s\n", ENERGEST_TRACE_FILE);
+  }
+  cfs_close(fd);
+#else /* ENERGEST_TRACE_OUTPUT == ENERGEST_TRACE_OUTPUT_CFS */
+  while(len--) {
+    putchar(*data++);
+  }
+#endif /* ENERGEST_TRACE_OUTPUT == ENERGEST_TRACE_OUTPUT_CFS */
+}
+/*---------------------------------------------------------------------------*/
+void
+energest_trace_write(void)
+{
+  uint8_t *p = frame + HEADER_LEN;
+  uint32_t total;
+  uint32_t now;
+  int count;
+  int i;
+  int t;
+
+  energest_flush();
+  count = entry_count();
+  total = (uint32_t)ENERGEST_GET_TOTAL_TIME();
+
+  p = put_u32(p, sequence++);
+  p = put_u32(p, ENERGEST_SECOND);
+  p = put_u32(p, total - last_total);
+  *p++ = ENERGEST_TYPE_MAX;
+  *p++ = count;
+  last_total = total;
+
+  for(i = 0; i < count; i++) {
+    const char *name = entry_name(i);
+    uint8_t len = MIN(strlen(name), ENERGEST_TRACE_NAME_LEN);
+
+    *p++ = len;
+    memcpy(p, name, len);
+    p += len;
+    for(t = 0; t < ENERGEST_TYPE_MAX; t++) {
+      now = entry_time(i, t);
+      p = put_u32(p, now - last_times[i][t]);
+      last_times[i][t] = now;
+    }
+  }
+
+  frame[0] = ENERGEST_TRACE_SYNC1;
+  frame[1] = ENERGEST_TRACE_SYNC2;
+  frame[2] = ENERGEST_TRACE_VERSION;
+  put_u16(&frame[3], p - frame - HEADER_LEN);
+  p = put_u16(p, crc16_data(&frame[2], p - frame - 2, 0));
+
+  output(frame, p - frame);
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(energest_trace_process, ev, data)
+{
+  static struct etimer periodic_timer;
+  PROCESS_BEGIN();
+
+  etimer_set(&periodic_timer, ENERGEST_TRACE_PERIOD);
+  while(1) {
+    PROCESS_WAIT_EVENT_UNTIL(etimer_expired(&periodic_timer));
+    etimer_reset(&periodic_timer);
+    energest_trace_write();
+  }
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
+void
+energest_trace_init(void)
+{
+  int i;
+  int t;
+
+  energest_flush();
+  last_total = (uint32_t)ENERGEST_GET_TOTAL_TIME();
+  for(i = 0; i < entry_count(); i++) {
+    for(t = 0; t < ENERGEST_TYPE_MAX; t++) {
+      last_times[i][t] = entry_time(i, t);
+    }
+  }
+  process_start(&energest_trace_process, NULL);
+}
+/*---------------------------------------------------------------------------*/
+/** @} */
@@ -0,0 +1,123 @@
+/*
+ * Copyright (c) 2026, Contiki-NG contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \addtogroup lib
+ * @{
+ *
+ * \defgroup energest-trace Binary Energest trace
+ *
+ * A process that periodically writes the Energest times of the period,
+ * per process when ENERGEST_CONF_WITH_PROCESSES is set, as binary
+ * frames to the serial line or to a CFS file. The frames are decoded on
+ * the host with tools/energest-trace/energest-decode.
+ *
+ * Each frame is, with all integers little-endian:
+ *
+ * - 0xE5 0x7E: sync bytes
+ * - uint8: format version, ENERGEST_TRACE_VERSION
+ * - uint16: payload length
+ * - payload:
+ *   - uint32: frame sequence number
+ *   - uint32: ENERGEST_SECOND
+ *   - uint32: period length, in Energest ticks
+ *   - uint8: number of Energest types, T
+ *   - uint8: number of entries, N
+ *   - N entries, each:
+ *     - uint8: name length, then the name. Entry 0, for the time outside
+ *       processes, has no name.
+ *     - T x uint32: time in each Energest type during the period
+ * - uint16: CRC-16 (crc16_data()) of the version, length and payload
+ *
+ * The sync bytes and the CRC let the decoder find frames in a serial
+ * stream that also carries log output.
+ * @{
+ */
+
+/**
+ * \file
+ *         Header file for the binary Energest trace
+ */
+
+#ifndef ENERGEST_TRACE_H_
+#define ENERGEST_TRACE_H_
+
+#include "contiki.h"
+
+/** \brief The period of the frames */
+#ifdef ENERGEST_TRACE_CONF_PERIOD
+#define ENERGEST_TRACE_PERIOD ENERGEST_TRACE_CONF_PERIOD
+#else /* ENERGEST_TRACE_CONF_PERIOD */
+#define ENERGEST_TRACE_PERIOD (CLOCK_SECOND * 60)
+#endif /* ENERGEST_TRACE_CONF_PERIOD */
+
+#define ENERGEST_TRACE_OUTPUT_SERIAL 0
+#define ENERGEST_TRACE_OUTPUT_CFS    1
+
+/** \brief Where the frames are written */
+#ifdef ENERGEST_TRACE_CONF_OUTPUT
+#define ENERGEST_TRACE_OUTPUT ENERGEST_TRACE_CONF_OUTPUT
+#else /* ENERGEST_TRACE_CONF_OUTPUT */
+#define ENERGEST_TRACE_OUTPUT ENERGEST_TRACE_OUTPUT_SERIAL
+#endif /* ENERGEST_TRACE_CONF_OUTPUT */
+
+/** \brief The CFS file that the frames are appended to */
+#ifdef ENERGEST_TRACE_CONF_FILE
+#define ENERGEST_TRACE_FILE ENERGEST_TRACE_CONF_FILE
+#else /* ENERGEST_TRACE_CONF_FILE */
+#define ENERGEST_TRACE_FILE "energest.trc"
+#endif /* ENERGEST_TRACE_CONF_FILE */
+
+/** \brief The longest process name written, longer names are truncated */
+#ifdef ENERGEST_TRACE_CONF_NAME_LEN
+#define ENERGEST_TRACE_NAME_LEN ENERGEST_TRACE_CONF_NAME_LEN
+#else /* ENERGEST_TRACE_CONF_NAME_LEN */
+#define ENERGEST_TRACE_NAME_LEN 16
+#endif /* ENERGEST_TRACE_CONF_NAME_LEN */
+
+#define ENERGEST_TRACE_SYNC1   0xe5
+#define ENERGEST_TRACE_SYNC2   0x7e
+#define ENERGEST_TRACE_VERSION 1
+
+/**
+ * Initialize the binary Energest trace and start its process
+ */
+void energest_trace_init(void);
+
+/**
+ * Write a frame with the Energest times since the previous one
+ */
+void energest_trace_write(void);
+
+#endif /* ENERGEST_TRACE_H_ */
+/**
+ * @}
+ * @}
+ */
@@ -0,0 +1,5 @@
+#define BUILD_WITH_ENERGEST_TRACE 1
+#define ENERGEST_CONF_ON 1
+#ifndef ENERGEST_CONF_WITH_PROCESSES
+#define ENERGEST_CONF_WITH_PROCESSES 1
+#endif /* ENERGEST_CONF_WITH_PROCESSES */
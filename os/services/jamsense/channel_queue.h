@@ -162,6 +162,20 @@ queue_dequeue(queue_t queue)
   return list_pop(queue);
 }
 /*---------------------------------------------------------------------------*/
+/**
+ * \brief Removes a channel from anywhere in the queue
+ * \param queue The queue
+ * \param channel The channel to be removed
+ */
+static inline void
+queue_remove(queue_t queue, unsigned int channel)
+{
+  if(channel>10&&channel<30)
+  {
+    list_remove(queue, &elements[channel - 10]);
+  }
+}
+/*---------------------------------------------------------------------------*/
 /**
  * \brief Returns the front element of the queue, without removing it
  * \param queue The queue
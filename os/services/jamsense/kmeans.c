@@ -22,6 +22,10 @@
 #define TVARIANCE 7
 #define TVARIANCE_CUMULATIVE 30
 
+#if ONLINE_KMEANS_MAX_CLUSTERS > 10
+#error "ONLINE_KMEANS_MAX_CLUSTERS must not exceed the size of clusters[] (10)"
+#endif
+
 //static rtimer_clock_t start, end, end_time, avg_time;
 //static int func_times = 0;
 
@@ -70,11 +74,9 @@ static unsigned sum_points1 = 0,
 
 static int stop_threshold = 1;
 
-static int suspicion_arr_cnt = 0;
-static int suspicion_vector_array[5];
-static uint16_t PCJ_cnt = 0;
-static uint16_t RSJ_cnt = 0;
-static uint16_t RAJ_cnt = 0;
+/* Evidence of the channel being classified, see kmeans_set_suspicion() */
+static struct jamming_suspicion default_suspicion;
+static struct jamming_suspicion *suspicion = &default_suspicion;
 
 static struct cluster_info
 {
@@ -114,12 +116,26 @@ void swap(struct cluster_info *xp, struct cluster_info *yp)
     *yp = temp;
 }
 /*---------------------------------------------------------------------------*/
+void kmeans_set_suspicion(struct jamming_suspicion *s)
+{
+    suspicion = s != NULL ? s : &default_suspicion;
+}
+/*---------------------------------------------------------------------------*/
+size_t kmeans_state_size(void)
+{
+    /* The buffers; the scalar bookkeeping adds about another hundred bytes */
+    return sizeof(burst_interval) + sizeof(burst_ts) + sizeof(burst_label) +
+           sizeof(tlist) + sizeof(X) + sizeof(K) + sizeof(vector_label) +
+           sizeof(prev_K_final) + sizeof(K_final) + sizeof(clusters) +
+           sizeof(clusters_old) + sizeof(default_suspicion);
+}
+/*---------------------------------------------------------------------------*/
 void reset_kmeans(void)
 {
-    suspicion_arr_cnt = 0;
-    PCJ_cnt = 0;
-    RSJ_cnt = 0;
-    RAJ_cnt = 0;
+    suspicion->arr_cnt = 0;
+    suspicion->pcj_cnt = 0;
+    suspicion->rsj_cnt = 0;
+    suspicion->raj_cnt = 0;
 }
 /*---------------------------------------------------------------------------*/
 void init_kmeans(struct record *record, int rle_ptr)
@@ -206,30 +222,30 @@ void calc_consistency(void)
     int suspicious_median = 0;
     for (int i = 0; i < INTERFERENCE_NUMBER_SAMPLES; i++)
     {
-        // printf("Suspecious values: %d\n", suspicion_vector_array[i]);
-        suspicious_median += suspicion_vector_array[i];
+        // printf("Suspecious values: %d\n", suspicion->vector_array[i]);
+        suspicious_median += suspicion->vector_array[i];
     }
     suspicious_median /= INTERFERENCE_NUMBER_SAMPLES;
     // printf("Median is: %d\n", suspicious_median);
     for (int i = 0; i < INTERFERENCE_NUMBER_SAMPLES; i++)
     {
-        //printf("Difference: %d >= Threashold: %d\n", abs(suspicious_median - suspicion_vector_array[i]), INTERFERENCE_DURATION_RANDOM);
-        if (abs(suspicious_median - suspicion_vector_array[i]) >= INTERFERENCE_DURATION_RANDOM)
+        //printf("Difference: %d >= Threashold: %d\n", abs(suspicious_median - suspicion->vector_array[i]), INTERFERENCE_DURATION_RANDOM);
+        if (abs(suspicious_median - suspicion->vector_array[i]) >= INTERFERENCE_DURATION_RANDOM)
         {
-           RAJ_cnt ++;
+           suspicion->raj_cnt ++;
         }
     }
-    suspicion_arr_cnt = 0;
-    LOG_DBG("RAJ_cnt: %d \n",RAJ_cnt);
-    if (RAJ_cnt >= 1 && RAJ_cnt >= PCJ_cnt)
+    suspicion->arr_cnt = 0;
+    LOG_DBG("RAJ_cnt: %d \n",suspicion->raj_cnt);
+    if (suspicion->raj_cnt >= 1 && suspicion->raj_cnt >= suspicion->pcj_cnt)
     {
         LOG_INFO("RANDOM JAMMER SUSPICIOUS\n");
     }
-    else if (PCJ_cnt >= 1)
+    else if (suspicion->pcj_cnt >= 1)
     {
         LOG_INFO("CONSTANT JAMMER SUSPICIOUS\n");
     }
-    else if (RSJ_cnt >= 1)
+    else if (suspicion->rsj_cnt >= 1)
     {
         LOG_INFO("REACTIVE JAMMER SUSPICIOUS\n");
     }
@@ -238,9 +254,9 @@ void calc_consistency(void)
         // printf("UNKNOWN CASE\n");
     }
 
-    PCJ_cnt = 0;
-    RSJ_cnt = 0;
-    RAJ_cnt = 0;
+    suspicion->pcj_cnt = 0;
+    suspicion->rsj_cnt = 0;
+    suspicion->raj_cnt = 0;
 
     //times += 1;
 }
@@ -283,18 +299,18 @@ int check_similarity(int profiling)
             // printf(" \n");
             //  printf("THE REAL SFD REACTIVE INTERFERENCE JAMMER\n");
             // printf(" \n");
-            //suspicion_vector_array[suspicion_arr_cnt] = clusters[i].vector_duration;
-            suspicion_arr_cnt++;
-            RSJ_cnt += 1;
+            //suspicion->vector_array[suspicion->arr_cnt] = clusters[i].vector_duration;
+            suspicion->arr_cnt++;
+            suspicion->rsj_cnt += 1;
         }
         else if (clusters[i].vector_duration >= INTERFERENCE_DURATION_MID_MIN )
         {
             // printf(" \n");
             //  printf("THE REAL PROACTIVE CONSTANT INTERFERENCE JAMMER\n");
             // printf(" \n");
-            //suspicion_vector_array[suspicion_arr_cnt] = clusters[i].vector_duration;
-            suspicion_arr_cnt++;
-            PCJ_cnt += 1;
+            //suspicion->vector_array[suspicion->arr_cnt] = clusters[i].vector_duration;
+            suspicion->arr_cnt++;
+            suspicion->pcj_cnt += 1;
         }
 #else
         if (clusters[i].vector_duration >= INTERFERENCE_DURATION_PROACTIVE)
@@ -303,9 +319,9 @@ int check_similarity(int profiling)
             //  printf("THE REAL PROACTIVE CONSTANT INTERFERENCE JAMMER\n");
             // printf(" \n");
 
-            suspicion_vector_array[suspicion_arr_cnt] = clusters[i].vector_duration;
-            suspicion_arr_cnt++;
-            PCJ_cnt += 1;
+            suspicion->vector_array[suspicion->arr_cnt] = clusters[i].vector_duration;
+            suspicion->arr_cnt++;
+            suspicion->pcj_cnt += 1;
         }
         else if (clusters[i].vector_duration >= INTERFERENCE_DURATION_SFD_MIN && clusters[i].vector_duration <= INTERFERENCE_DURATION_SFD_MAX)
         {
@@ -313,30 +329,30 @@ int check_similarity(int profiling)
             // printf(" \n");
             //  printf("THE REAL SFD REACTIVE INTERFERENCE JAMMER\n");
             // printf(" \n");
-            suspicion_vector_array[suspicion_arr_cnt] = clusters[i].vector_duration;
-            suspicion_arr_cnt++;
-            RSJ_cnt += 1;
+            suspicion->vector_array[suspicion->arr_cnt] = clusters[i].vector_duration;
+            suspicion->arr_cnt++;
+            suspicion->rsj_cnt += 1;
         }
         else if (clusters[i].vector_duration >= INTERFERENCE_DURATION_MID_MIN && clusters[i].vector_duration <= INTERFERENCE_DURATION_MID_MAX)
         {
 
             //printf("SUS RANDOM JAMMER\n");
-            suspicion_vector_array[suspicion_arr_cnt] = clusters[i].vector_duration;
-            suspicion_arr_cnt++;
+            suspicion->vector_array[suspicion->arr_cnt] = clusters[i].vector_duration;
+            suspicion->arr_cnt++;
         }
 #endif
     }
-    int suspicion_arr_cnt_temp = suspicion_arr_cnt;
-    //LOG_INFO("suspicion_arr_cnt: %d \n",suspicion_arr_cnt);
+    int suspicion_arr_cnt_temp = suspicion->arr_cnt;
+    //LOG_INFO("suspicion_arr_cnt: %d \n",suspicion->arr_cnt);
    
-    if (suspicion_arr_cnt >= INTERFERENCE_NUMBER_SAMPLES)
+    if (suspicion->arr_cnt >= INTERFERENCE_NUMBER_SAMPLES)
     {
-        LOG_DBG("PCJ_cnt: %d \n",PCJ_cnt);
-        LOG_DBG("RSJ_cnt: %d \n",RSJ_cnt);
+        LOG_DBG("PCJ_cnt: %d \n",suspicion->pcj_cnt);
+        LOG_DBG("RSJ_cnt: %d \n",suspicion->rsj_cnt);
 #if QUICK_PROACTIVE == 1
-        int jammer_channel = specksense_channel_peek();
-        suspicion_arr_cnt = 0;
-        if (PCJ_cnt >= RSJ_cnt)
+        int jammer_channel = suspicion->channel;
+        suspicion->arr_cnt = 0;
+        if (suspicion->pcj_cnt >= suspicion->rsj_cnt)
         {
             LOG_INFO("CH%d: PROACTIVE JAMMER SUSPICIOUS\n",jammer_channel);
             update_jammer_status(jammer_channel,1);
@@ -346,8 +362,8 @@ int check_similarity(int profiling)
             LOG_INFO("CH%d: REACTIVE JAMMER SUSPICIOUS\n",jammer_channel);
             update_jammer_status(jammer_channel,2);
         }
-        PCJ_cnt = 0;
-        RSJ_cnt = 0;
+        suspicion->pcj_cnt = 0;
+        suspicion->rsj_cnt = 0;
         num_jamming_cluster = 0;
 #else
         calc_consistency();
@@ -652,6 +668,137 @@ int kmeans(struct record *record, int rle_ptr)
 }
 /*---------------------------------------------------------------------------*/
 
+/*-------------- START Streaming k-means --------------*/
+
+/* Centroids are kept with 4 fractional bits so that the incremental mean
+ * does not drift towards zero because of integer truncation. */
+#define ONLINE_FP_SHIFT 4
+
+/*---------------------------------------------------------------------------*/
+static uint32_t online_distance(int32_t *k, int duration, int plevel)
+{
+    int32_t d0 = (k[0] >> ONLINE_FP_SHIFT) - duration;
+    int32_t d1 = (k[1] >> ONLINE_FP_SHIFT) - plevel;
+
+    return (uint32_t)(d0 * d0) + (uint32_t)(d1 * d1) * EUCLIDEAN_DISTANCE_WEIGHT;
+}
+/*---------------------------------------------------------------------------*/
+/* Frees one centroid slot by merging the two closest centroids */
+static void online_merge_closest(struct kmeans_online *km)
+{
+    uint32_t best = 0xFFFFFFFF;
+    uint8_t a = 0, b = 1, m, n;
+    uint32_t total;
+
+    for (m = 0; m < km->num_clusters; m++)
+    {
+        for (n = m + 1; n < km->num_clusters; n++)
+        {
+            uint32_t d = online_distance(km->centroid[m],
+                                         km->centroid[n][0] >> ONLINE_FP_SHIFT,
+                                         km->centroid[n][1] >> ONLINE_FP_SHIFT);
+            if (d < best)
+            {
+                best = d;
+                a = m;
+                b = n;
+            }
+        }
+    }
+
+    total = km->members[a] + km->members[b];
+    km->centroid[a][0] = (km->centroid[a][0] * km->members[a] + km->centroid[b][0] * km->members[b]) / total;
+    km->centroid[a][1] = (km->centroid[a][1] * km->members[a] + km->centroid[b][1] * km->members[b]) / total;
+    km->members[a] = total > ONLINE_KMEANS_MEMBER_CAP ? ONLINE_KMEANS_MEMBER_CAP : total;
+
+    /* Move the last centroid into the freed slot */
+    km->num_clusters--;
+    if (b != km->num_clusters)
+    {
+        km->centroid[b][0] = km->centroid[km->num_clusters][0];
+        km->centroid[b][1] = km->centroid[km->num_clusters][1];
+        km->members[b] = km->members[km->num_clusters];
+    }
+}
+/*---------------------------------------------------------------------------*/
+void kmeans_online_init(struct kmeans_online *km)
+{
+    km->num_clusters = 0;
+    km->num_vectors = 0;
+}
+/*---------------------------------------------------------------------------*/
+void kmeans_online_update(struct kmeans_online *km, int plevel, int duration)
+{
+    uint32_t d, nearest_distance = 0xFFFFFFFF;
+    uint8_t c, nearest = 0;
+
+    /* Same filter as init_kmeans(): runs close to the noise floor are not clustered */
+    if (plevel <= INTERFERENCE_POWER_LEVEL_THRESHOLD / 2 || duration <= 0)
+    {
+        return;
+    }
+    km->num_vectors++;
+
+    for (c = 0; c < km->num_clusters; c++)
+    {
+        d = online_distance(km->centroid[c], duration, plevel);
+        if (d < nearest_distance)
+        {
+            nearest_distance = d;
+            nearest = c;
+        }
+    }
+
+    /* Far from every centroid: open a new one, merging the two closest
+     * centroids first if the table is full, so that outliers (e.g. a short
+     * reactive burst among constant jamming) keep a cluster of their own. */
+    if (km->num_clusters == 0 || nearest_distance > ONLINE_KMEANS_SPAWN_DISTANCE)
+    {
+        if (km->num_clusters >= ONLINE_KMEANS_MAX_CLUSTERS)
+        {
+            online_merge_closest(km);
+        }
+        c = km->num_clusters++;
+        km->centroid[c][0] = (int32_t)duration << ONLINE_FP_SHIFT;
+        km->centroid[c][1] = (int32_t)plevel << ONLINE_FP_SHIFT;
+        km->members[c] = 1;
+        return;
+    }
+
+    /* Sequential (MacQueen) update: move the centroid by 1/n towards the run */
+    if (km->members[nearest] < ONLINE_KMEANS_MEMBER_CAP)
+    {
+        km->members[nearest]++;
+    }
+    km->centroid[nearest][0] += (((int32_t)duration << ONLINE_FP_SHIFT) - km->centroid[nearest][0]) / km->members[nearest];
+    km->centroid[nearest][1] += (((int32_t)plevel << ONLINE_FP_SHIFT) - km->centroid[nearest][1]) / km->members[nearest];
+}
+/*---------------------------------------------------------------------------*/
+int kmeans_online_classify(struct kmeans_online *km)
+{
+    uint8_t c;
+    int duration, level;
+
+    num_vectors = km->num_vectors;
+    num_jamming_cluster = 0;
+    for (c = 0; c < km->num_clusters; c++)
+    {
+        duration = (km->centroid[c][0] + (1 << (ONLINE_FP_SHIFT - 1))) >> ONLINE_FP_SHIFT;
+        level = (km->centroid[c][1] + (1 << (ONLINE_FP_SHIFT - 1))) >> ONLINE_FP_SHIFT;
+        if (level >= INTERFERENCE_POWER_LEVEL_THRESHOLD)
+        {
+            clusters[num_jamming_cluster].vector_duration = duration;
+            clusters[num_jamming_cluster].plevel = level;
+            num_jamming_cluster++;
+        }
+        LOG_DBG("cluster %d : vector_duration: %d plevel: %d members: %d\n", c, duration, level, km->members[c]);
+    }
+
+    return num_jamming_cluster;
+}
+
+/*-------------- END Streaming k-means --------------*/
+
 /*-------------- START This is for classification --------------*/
 
 void channel_rate(struct record *record, int n_clusters)
@@ -675,9 +822,9 @@ void channel_rate(struct record *record, int n_clusters)
             record_ptr++;
         }
 
-    printf("WiFi-%d: Clusters-%d: Cost-%ld: fs-%lu: ts-%lu: ",
-           wifi_beacon, n_clusters, prev_cost_final,
-           free_samples, (free_samples + busy_samples));
+    printf("WiFi-%d: Clusters-%d: Cost-%lu: fs-%lu: ts-%lu: ",
+           wifi_beacon, n_clusters, (unsigned long)prev_cost_final,
+           (unsigned long)free_samples, (unsigned long)(free_samples + busy_samples));
 }
 
 void update_tlist(uint16_t ts_diff)
@@ -812,7 +959,7 @@ void check_periodic(uint16_t itr_cnt, int cluster_id)
         mean_t = (uint32_t)sum_term / (num_occurrences - 1);
         printf("Channel %d: Kperiod(%d,%d): mean: %lu:",
                itr_cnt, clusters_old[cluster_id].burst_size,
-               clusters_old[cluster_id].plevel, mean_t);
+               clusters_old[cluster_id].plevel, (unsigned long)mean_t);
 
         for (i = 0; i < 15; i++)
             if (!tlist[i][0])
@@ -886,10 +1033,10 @@ void print_interarrival(uint16_t itr_cnt, int num_clusters)
                 {
                     if (num_occurrences > 1)
                         printf(",%lu",
-                               (uint32_t)(burst_ts[i] - burst_ts[prev_burst]));
+                               (unsigned long)(burst_ts[i] - burst_ts[prev_burst]));
                     else
                         printf("%lu",
-                               (uint32_t)(burst_ts[i] - burst_ts[prev_burst]));
+                               (unsigned long)(burst_ts[i] - burst_ts[prev_burst]));
                 }
                 prev_burst = i;
                 num_occurrences++;
@@ -1178,10 +1325,10 @@ int kmeans_old(struct record *record, int rle_ptr) // What is the rle_ptr when i
         }
     } /* ((cluster_test < 10) && (diffcost_between_clusters > 3)) */
 
-    printf("num_clusters:%d, cost:%ld, samples: %lu (%lu,%lu)\n",
-           prev_num_clusters_final, prev_cost_final,
-           free_samples + busy_samples,
-           free_samples, busy_samples);
+    printf("num_clusters:%d, cost:%lu, samples: %lu (%lu,%lu)\n",
+           prev_num_clusters_final, (unsigned long)prev_cost_final,
+           (unsigned long)(free_samples + busy_samples),
+           (unsigned long)free_samples, (unsigned long)busy_samples);
     for (i = 0; i < prev_num_clusters_final; i++)
     {
         clusters_old[i].burst_size = prev_K_final[i][0];
@@ -1232,8 +1379,8 @@ float channel_metric_rssi_threshold(struct record *record, int rle_ptr)
             record_ptr++;
     }
 
-    printf("free samples = %d, busy samples = %ld\n",
-           free_samples, busy_samples);
+    printf("free samples = %d, busy samples = %lu\n",
+           free_samples, (unsigned long)busy_samples);
     return (((float)(free_samples * 1.0)) / (free_samples + busy_samples));
 }
 /*---------------------------------------------------------------------------*/
@@ -4,12 +4,83 @@
 #include "stdlib.h"
 #include "lib/random.h"
 
+/* Classify with the streaming k-means engine (default) rather than
+ * re-clustering the whole RLE buffer in batch */
+#ifndef ONLINE_KMEANS
+#define ONLINE_KMEANS 1
+#endif
+
+/* Maximum number of centroids tracked by the streaming engine */
+#ifndef ONLINE_KMEANS_MAX_CLUSTERS
+#define ONLINE_KMEANS_MAX_CLUSTERS 10
+#endif
+
+/* Weighted squared distance above which a run opens a new centroid */
+#ifndef ONLINE_KMEANS_SPAWN_DISTANCE
+#define ONLINE_KMEANS_SPAWN_DISTANCE (2 * EUCLIDEAN_DISTANCE_WEIGHT)
+#endif
+
+/* Cap on the member count used as centroid learning rate, so that
+ * old runs are gradually forgotten */
+#ifndef ONLINE_KMEANS_MEMBER_CAP
+#define ONLINE_KMEANS_MEMBER_CAP 64
+#endif
 
 struct record{
      int 	rssi_rle[RUN_LENGTH][2];
      uint8_t 	sequence_num;
 };
 
+/**
+ * @brief Jamming evidence accumulated by check_similarity() for one channel.
+ */
+struct jamming_suspicion{
+     int        channel;
+     int        arr_cnt;
+     int        vector_array[5];
+     uint16_t   pcj_cnt;
+     uint16_t   rsj_cnt;
+     uint16_t   raj_cnt;
+};
+
+/**
+ * @brief State of the streaming k-means engine. Centroids are kept in
+ * fixed point (4 fractional bits) as {duration, power level}.
+ */
+struct kmeans_online{
+     int32_t    centroid[ONLINE_KMEANS_MAX_CLUSTERS][2];
+     uint16_t   members[ONLINE_KMEANS_MAX_CLUSTERS];
+     uint8_t    num_clusters;
+     uint16_t   num_vectors;
+};
+
+/**
+ * @brief Function for resetting the streaming k-means engine.
+ *
+ * @param[in] km Pointer to the engine state.
+ */
+void kmeans_online_init(struct kmeans_online *km);
+
+/**
+ * @brief Function for feeding one completed RLE run into the streaming
+ * k-means engine. Runs below the power level threshold are discarded, the
+ * nearest centroid is moved towards the run, or a new centroid is opened.
+ *
+ * @param[in] km Pointer to the engine state.
+ * @param[in] plevel Power level of the run.
+ * @param[in] duration Duration (samples) of the run.
+ */
+void kmeans_online_update(struct kmeans_online *km, int plevel, int duration);
+
+/**
+ * @brief Function for extracting the jamming clusters from the streaming
+ * k-means engine, to be checked with check_similarity().
+ *
+ * @param[in] km Pointer to the engine state.
+ * @return number of clusters above the power level threshold.
+ */
+int kmeans_online_classify(struct kmeans_online *km);
+
 /**
  * @brief Function for k-means clustering algorithm, used for jamming attacks.
  *
@@ -24,7 +95,17 @@ int kmeans(struct record *, int rle_ptr);
  */
 int kmeans_old(struct record *, int rle_ptr);
 
+/**
+ * @brief Function for selecting the evidence that check_similarity(),
+ * calc_consistency() and reset_kmeans() work on.
+ *
+ * @param[in] s Evidence of the channel being classified, NULL for a default set.
+ */
+void kmeans_set_suspicion(struct jamming_suspicion *s);
+
 void reset_kmeans(void);
+/* Static RAM of the classifier buffers in bytes, for reporting */
+size_t kmeans_state_size(void);
 float channel_metric_rssi_threshold(struct record *record, int rle_ptr);
 void channel_rate(struct record *record, int n_clusters);
 void add_to_tlist(uint16_t ts_diff);
@@ -13,6 +13,7 @@
 #include <math.h>
 #include <stdio.h> /* For printf() */
 #include <stdlib.h>
+#include <string.h>
 #include "net/netstack.h"
 #include "net/packetbuf.h"
 #include "net/mac/tsch/tsch.h"
@@ -40,8 +41,6 @@
 #include "kmeans.h"
 #include "channel_queue.h"
 #include "cfs/cfs.h"
-#include "nrf52840_bitfields.h"
-#include "nrf52840.h"
 
 QUEUE(jamsense_queue);
 /*---------------------------------------------------------------------------*/
@@ -69,18 +68,66 @@ static uint16_t classification_status = 0;
 
 //! Global variables for RSSI scan
 static int rssi_val, /*rssi_valB,*/ rle_ptr = -1, /*rle_ptrB = -1,*/
-		   pre_rssi_val = 0, /*previous rssi_valB,*/
- 		   cond, itr,
-		   rssi_val_mod;
+ 		   itr;
 
 static unsigned rssi_levels[RSSI_SIZE];
+
+#if ONLINE_KMEANS
+/* One sampling/classification context per channel of the hopping sequence */
+#ifndef SPECKSENSE_CHANNEL_CONTEXTS
+#define SPECKSENSE_CHANNEL_CONTEXTS TSCH_HOPPING_SEQUENCE_MAX_LEN
+#endif
+#else
+/* The batch classifier works on the whole RLE record, one channel at a time */
+#undef SPECKSENSE_CHANNEL_CONTEXTS
+#define SPECKSENSE_CHANNEL_CONTEXTS 1
 static struct record record;
+#endif
+
+/**
+ * \brief Sampling and classification state of one channel
+ */
+struct channel_context {
+  uint8_t channel;  //0 if the context is free
+  uint8_t specksense_loop;
+  int sample_cnt;
+  int run_level;    //RLE run that is still being extended by the sampler
+  int run_duration;
+  int pre_rssi_val;
+#if ONLINE_KMEANS
+  struct kmeans_online kmeans;
+#endif
+  struct jamming_suspicion suspicion;
+};
+
+static struct channel_context channel_contexts[SPECKSENSE_CHANNEL_CONTEXTS];
+/* Context handed to the classification process, NULL when idle */
+static struct channel_context *classify_ctx;
 //static struct etimer jamsense_timer;
 
 static int packet_cnt = 0;
-static int sample_cnt = 0;
-static uint8_t pre_measurement_channel = 0;
-static uint8_t specksense_loop = 0;
+
+static void channel_release(int channel);
+
+/*Background RSSI capture by the radio, falls back to polling when the radio has none*/
+#ifndef SPECKSENSE_RSSI_CAPTURE
+#define SPECKSENSE_RSSI_CAPTURE 1
+#endif
+#if SPECKSENSE_RSSI_CAPTURE
+#ifndef SPECKSENSE_CAPTURE_INTERVAL_US
+#define SPECKSENSE_CAPTURE_INTERVAL_US 16
+#endif
+#ifndef SPECKSENSE_CAPTURE_BATCH
+#define SPECKSENSE_CAPTURE_BATCH 32
+#endif
+static int8_t capture_buf[SPECKSENSE_CAPTURE_BATCH];
+static radio_rssi_capture_t rssi_capture;
+static struct channel_context *capture_ctx; //context being filled by the capture, NULL when idle
+static int capture_target;                  //rle_ptr value that ends the capture
+static bool capture_supported = true;
+
+static void rssi_capture_cancel(void);
+#endif
 
 #if CHANNEL_METRIC == 2
 static uint16_t cidx;
@@ -117,6 +164,20 @@ void update_jammer_status(int channel, int type)
 	channel = channel - 10;
 	jammer_queue[channel].type = type;
 	jammer_queue[channel].time = RTIMER_NOW();
+#ifdef SPECKSENSE_CALLBACK_JAMMER_DETECTED
+	SPECKSENSE_CALLBACK_JAMMER_DETECTED(channel + 10, type);
+#endif
+}
+/*---------------------------------------------------------------------------*/
+int specksense_jammer_type(int channel)
+{
+	channel = channel - 10;
+	if(channel < 0 || channel >= CHANNEL_SEQUENCE_AMOUNT
+	   || RTIMER_NOW() - jammer_queue[channel].time > tick_minute)
+	{
+		return 0;
+	}
+	return jammer_queue[channel].type;
 }
 /*---------------------------------------------------------------------------*/
 static bool check_jammer_status(int channel)
@@ -130,36 +191,260 @@ static bool check_jammer_status(int channel)
 	{
 		if(jammer_queue[channel].type == 1)
 		{
-			LOG_INFO("CH%d: PROACTIVE JAMMER RECORD EXIST\n",specksense_channel_peek());
+			LOG_INFO("CH%d: PROACTIVE JAMMER RECORD EXIST\n",channel + 10);
 		}
 		else if (jammer_queue[channel].type == 2)
 		{
-			LOG_INFO("CH%d: REACTIVE JAMMER RECORD EXIST\n",specksense_channel_peek());
+			LOG_INFO("CH%d: REACTIVE JAMMER RECORD EXIST\n",channel + 10);
+		}
+		channel_release(channel + 10);
+		return false;
+	}
+}
+/*---------------------------------------------------------------------------*/
+/* Drops the open run and any partial classifier state */
+static void rle_reset(struct channel_context *ctx)
+{
+	ctx->sample_cnt = 0;
+	ctx->run_duration = 0;
+#if ONLINE_KMEANS
+	kmeans_online_init(&ctx->kmeans);
+#endif
+}
+/*---------------------------------------------------------------------------*/
+static void context_reset(struct channel_context *ctx, uint8_t channel)
+{
+	rle_reset(ctx);
+	ctx->channel = channel;
+	ctx->specksense_loop = 0;
+	ctx->pre_rssi_val = 0;
+	memset(&ctx->suspicion, 0, sizeof(ctx->suspicion));
+	ctx->suspicion.channel = channel;
+}
+/*---------------------------------------------------------------------------*/
+/* Finds the context of a channel. If there is none and create is set, a
+ * free context is taken, or else the one with the fewest samples. */
+static struct channel_context *context_lookup(uint8_t channel, bool create)
+{
+	struct channel_context *ctx, *victim = NULL;
+
+	for(ctx = channel_contexts; ctx < channel_contexts + SPECKSENSE_CHANNEL_CONTEXTS; ctx++)
+	{
+		if(ctx->channel == channel)
+		{
+			return ctx;
+		}
+	}
+	if(!create)
+	{
+		return NULL;
+	}
+
+	for(ctx = channel_contexts; ctx < channel_contexts + SPECKSENSE_CHANNEL_CONTEXTS; ctx++)
+	{
+		if(ctx == classify_ctx)
+		{
+			continue;
+		}
+		if(ctx->channel == 0)
+		{
+			victim = ctx;
+			break;
+		}
+		if(victim == NULL || ctx->sample_cnt < victim->sample_cnt)
+		{
+			victim = ctx;
 		}
-		specksense_channel_remove();
+	}
+
+	if(victim != NULL)
+	{
+		if(victim->channel != 0)
+		{
+			LOG_INFO("CH%d: context reused for CH%d, reset specksense!\n", victim->channel, channel);
+		}
+		context_reset(victim, channel);
+	}
+	return victim;
+}
+/*---------------------------------------------------------------------------*/
+/* Stops scanning a channel and frees its context */
+static void channel_release(int channel)
+{
+	struct channel_context *ctx = context_lookup(channel, false);
+
+#if SPECKSENSE_RSSI_CAPTURE
+	if(ctx != NULL && ctx == capture_ctx)
+	{
+		rssi_capture_cancel();
+	}
+#endif
+	if(ctx != NULL && ctx != classify_ctx)
+	{
+		context_reset(ctx, 0);
+	}
+	queue_remove(jamsense_queue, channel);
+}
+/*---------------------------------------------------------------------------*/
+/* Hands a finished RLE run to the classifier. In streaming mode the run
+ * updates the centroids right away and is not stored. */
+static void rle_run_complete(struct channel_context *ctx, int level, int duration)
+{
+#if ONLINE_KMEANS
+	kmeans_online_update(&ctx->kmeans, level, duration);
+#else
+	record.rssi_rle[rle_ptr][0] = level;
+	record.rssi_rle[rle_ptr][1] = duration;
+#endif
+	rle_ptr++;
+}
+/*---------------------------------------------------------------------------*/
+/* Maps one RSSI reading to a power level and extends or closes the open run */
+static void rle_encode_sample(struct channel_context *ctx, int rssi)
+{
+	int rssi_mod;
+
+	rssi -= 45; /* compensation offset */
+	int16_t debug_rssi = rssi;
+
+	/*If power level is <= 2 set it to power level 1*/
+	if (debug_rssi <= -132)
+	{
+		debug_rssi = -139;
+	}
+
+	/*Power level most be higher than one */
+	if (rssi_levels[-debug_rssi - 1] <= 1)
+	{
+		return;
+	}
+#if QUICK_PROACTIVE == 1
+	// Avoid energy fluctuations, may need to be fine-tuned	
+	if(rssi_levels[-debug_rssi - 1] > INTERFERENCE_POWER_LEVEL_THRESHOLD && (rssi - ctx->pre_rssi_val) < 3 && (rssi - ctx->pre_rssi_val) > -3)
+	{
+		rssi = ctx->pre_rssi_val;
+	}
+	else
+	{
+		ctx->pre_rssi_val = rssi;
+	}		
+#endif
+	rssi_mod = -rssi - 1;
+
+	/*Check out of bounds*/
+	if (rssi_mod >= 140)
+	{
+		rssi_mod = 139;
+	}
+
+	/*A new power level starts a new run, as does reaching MAX_DURATION*/
+	if (ctx->run_duration > 0 && (ctx->run_level != rssi_levels[rssi_mod] || ctx->run_duration >= MAX_DURATION))
+	{
+		rle_run_complete(ctx, ctx->run_level, ctx->run_duration);
+		ctx->run_duration = 0;
+	}
+	ctx->run_level = rssi_levels[rssi_mod];
+	ctx->run_duration++;
+	// LOG_DBG(" rle_ptr: %d  level: %d  duratuion: %d \n",rle_ptr,ctx->run_level,ctx->run_duration);
+}
+/*---------------------------------------------------------------------------*/
+#if SPECKSENSE_RSSI_CAPTURE
+/* Called by the radio driver's process with a batch of RSSI samples */
+static int rssi_capture_batch(const int8_t *samples, uint16_t count, void *ptr)
+{
+	struct channel_context *ctx = ptr;
+	uint16_t i;
+
+	for(i = 0; i < count && rle_ptr < capture_target; i++)
+	{
+		rle_encode_sample(ctx, samples[i]);
+	}
+	ctx->sample_cnt = rle_ptr;
+
+	/* quit rssi if doesnt have enough time */
+	return rle_ptr < capture_target && (RTIMER_NOW() + 200) <= rssi_stop_time;
+}
+/*---------------------------------------------------------------------------*/
+/* Starts a background capture, returns false if the radio cannot do it */
+static bool rssi_capture_begin(struct channel_context *ctx, int target)
+{
+	radio_result_t res;
+
+	if(!capture_supported)
+	{
+		return false;
+	}
+
+	capture_target = target;
+	rssi_capture.buf = capture_buf;
+	rssi_capture.len = SPECKSENSE_CAPTURE_BATCH;
+	rssi_capture.interval_us = SPECKSENSE_CAPTURE_INTERVAL_US;
+	rssi_capture.batch = rssi_capture_batch;
+	rssi_capture.ptr = ctx;
+
+	res = NETSTACK_RADIO.set_object(RADIO_PARAM_RSSI_CAPTURE, &rssi_capture, sizeof(rssi_capture));
+	if(res == RADIO_RESULT_NOT_SUPPORTED)
+	{
+		LOG_INFO("Radio has no RSSI capture, polling RSSI\n");
+		capture_supported = false;
+	}
+	if(res != RADIO_RESULT_OK)
+	{
+		return false;
+	}
+	capture_ctx = ctx;
+	return true;
+}
+/*---------------------------------------------------------------------------*/
+/* Returns true while a background capture is still running */
+static bool rssi_capture_pending(void)
+{
+	if(capture_ctx == NULL)
+	{
 		return false;
 	}
+	if(rssi_capture.active)
+	{
+		return true;
+	}
+#if TSCH_WITH_JAMSENSE == 1
+	NETSTACK_RADIO.set_value(RADIO_PARAM_CHANNEL, tsch_current_channel);
+#endif
+	LOG_INFO("CH%d: RSSI sample %d\n", capture_ctx->channel, capture_ctx->sample_cnt);
+	capture_ctx = NULL;
+	return false;
+}
+/*---------------------------------------------------------------------------*/
+/* Stops a running capture, the samples it already encoded are kept */
+static void rssi_capture_cancel(void)
+{
+	if(capture_ctx != NULL)
+	{
+		NETSTACK_RADIO.set_object(RADIO_PARAM_RSSI_CAPTURE, NULL, 0);
+		rssi_capture_pending();
+	}
 }
+#endif /* SPECKSENSE_RSSI_CAPTURE */
 /*---------------------------------------------------------------------------*/
 void rssi_sampler(int sample_amount, int channel, rtimer_clock_t rssi_stop_time)
 {
+	/*Samples accumulate in the context of the channel, so scans of different channels do not reset each other*/
+	struct channel_context *ctx = context_lookup(channel, true);
+
+	if(ctx == NULL || ctx == classify_ctx)
+	{
+		return;
+	}
+
 	/*sample_amount is the amount that is going to do, sample_cnt is the amount that already done, rle_ptr is sample amount for current loop*/
-	if(sample_amount + sample_cnt > RUN_LENGTH)
+	if(sample_amount + ctx->sample_cnt > RUN_LENGTH)
 	{
-		sample_amount = RUN_LENGTH - sample_cnt;
+		sample_amount = RUN_LENGTH - ctx->sample_cnt;
 	}
 	//LOG_INFO("START RSSI, Sample amount: %d  \n",sample_amount);
 	// sample_st = RTIMER_NOW();
 	rle_ptr = 0;
 
-	if(channel != pre_measurement_channel)
-		{
-			sample_cnt = 0;
-			reset_kmeans();
-			LOG_INFO("channel changed to %d, reset specksense!\n",channel);
-		}
-	pre_measurement_channel = channel;
-
 	//int times = 0;
 #if TSCH_WITH_JAMSENSE == 1
 	//if(!tsch_get_lock())
@@ -169,22 +454,29 @@ void rssi_sampler(int sample_amount, int channel, rtimer_clock_t rssi_stop_time)
 	if (NETSTACK_RADIO.set_value(RADIO_PARAM_CHANNEL, channel) != RADIO_RESULT_OK)
 	{
 		//LOG_ERR("ERROR: failed to change radio channel, RSSI Sampler failed!\n");
-		sample_cnt = 0;
+		rle_ptr = ctx->sample_cnt;
 	}
 	else
 	{
-		rle_ptr = rle_ptr + sample_cnt;
+		rle_ptr = rle_ptr + ctx->sample_cnt;
 		/* Need to explicitly turn on for Coojamotes */
   		NETSTACK_RADIO.on();
-		
-		while ((rle_ptr < sample_amount + sample_cnt))
+
+#if SPECKSENSE_RSSI_CAPTURE
+		/*The radio samples in the background and the driver process runs the encoder, channel is restored when the capture ends*/
+		if(rssi_capture_begin(ctx, sample_amount + ctx->sample_cnt))
+		{
+			return;
+		}
+#endif
+
+		while ((rle_ptr < sample_amount + ctx->sample_cnt))
 		{
 			watchdog_periodic();
 
 			/* quit rssi if doesnt have enough time */
 			if((RTIMER_NOW() + 200) > rssi_stop_time)
 			{
-				sample_cnt = rle_ptr > 0 ? rle_ptr : 0;
 				break;
 			}
 
@@ -194,57 +486,7 @@ void rssi_sampler(int sample_amount, int channel, rtimer_clock_t rssi_stop_time)
 				break;
 			}
 
-			rssi_val -= 45; /* compensation offset */
-			int16_t debug_rssi = rssi_val;
-
-			/*If power level is <= 2 set it to power level 1*/
-			if (debug_rssi <= -132)
-			{
-				debug_rssi = -139;
-			}
-
-			/*Power level most be higher than one */
-			if (rssi_levels[-debug_rssi - 1] > 1)
-			{
-#if QUICK_PROACTIVE == 1
-				// Avoid energy fluctuations, may need to be fine-tuned	
-				if(rssi_levels[-debug_rssi - 1] > INTERFERENCE_POWER_LEVEL_THRESHOLD && (rssi_val - pre_rssi_val) < 3 && (rssi_val - pre_rssi_val) > -3)
-				{
-					rssi_val = pre_rssi_val;
-				}
-				else
-				{
-					pre_rssi_val = rssi_val;
-				}		
-#endif
-				cond = 0x01 & ((record.rssi_rle[rle_ptr][0] != rssi_levels[-rssi_val - 1]) | (record.rssi_rle[rle_ptr][1] == 32767));
-
-				/*Max_duration achieved, move to next value*/
-				if (record.rssi_rle[rle_ptr][1] >= MAX_DURATION)
-				{
-					cond = 1; /*Jump to next value*/
-				}
-
-				/*Increase rle_ptr when new powerlevel starts recording.*/
-				rle_ptr = rle_ptr + cond;
-				rssi_val_mod = -rssi_val - 1;
-
-				/*Check out of bounds*/
-				if (rssi_val_mod >= 140)
-				{
-					rssi_val_mod = 139;
-					// printf("out of loop I guess\n");
-				}
-
-				/*Create 2D vector*/
-				record.rssi_rle[rle_ptr][0] = rssi_levels[rssi_val_mod];
-				record.rssi_rle[rle_ptr][1] = (record.rssi_rle[rle_ptr][1]) * (1 - cond) + 1;
-				// LOG_DBG(" rle_ptr: %d  level: %d  duratuion: %d \n",rle_ptr,record.rssi_rle[rle_ptr][0],	record.rssi_rle[rle_ptr][1]);
-			}
-			else
-			{ /*I think a problem might be that it loops here without printing anything for a very long amount of time. */
-				// if (rle_ptr == 498){}
-			}
+			rle_encode_sample(ctx, rssi_val);
 		}
 
 	}
@@ -256,8 +498,8 @@ void rssi_sampler(int sample_amount, int channel, rtimer_clock_t rssi_stop_time)
 
 	//LOG_INFO("This is how many times the loop looped: %d \n", times);
 	watchdog_start();
-	sample_cnt = rle_ptr > 0 ? rle_ptr : 0;
-	LOG_INFO("CH%d: RSSI sample %d\n", channel, sample_cnt);
+	ctx->sample_cnt = rle_ptr > 0 ? rle_ptr : 0;
+	LOG_INFO("CH%d: RSSI sample %d\n", channel, ctx->sample_cnt);
 }
 /*---------------------------------------------------------------------------*/
 
@@ -387,12 +629,43 @@ void init_power_levels()
 #else
 #error "Power levels should be one of the following values: 2, 4, 8, 16 or 120"
 #endif
-	queue_init(jamsense_queue);
-	init_jammer_queue();
+	specksense_reset();
 	// etimer_set(&jamsense_timer, CLOCK_SECOND * 3);
 	// process_start(&specksense, NULL);
 }
 /*---------------------------------------------------------------------------*/
+size_t specksense_state_size(void)
+{
+	size_t size;
+
+	size = sizeof(channel_contexts) + sizeof(rssi_levels) +
+	       sizeof(jammer_queue) + kmeans_state_size();
+#if !ONLINE_KMEANS
+	size += sizeof(record);
+#endif
+#if SPECKSENSE_RSSI_CAPTURE
+	size += sizeof(capture_buf);
+#endif
+	return size;
+}
+/*---------------------------------------------------------------------------*/
+void specksense_reset(void)
+{
+	int i;
+
+#if SPECKSENSE_RSSI_CAPTURE
+	rssi_capture_cancel();
+#endif
+	for(i = 0; i < SPECKSENSE_CHANNEL_CONTEXTS; i++)
+	{
+		context_reset(&channel_contexts[i], 0);
+	}
+	classify_ctx = NULL;
+	kmeans_set_suspicion(NULL);
+	queue_init(jamsense_queue);
+	init_jammer_queue();
+}
+/*---------------------------------------------------------------------------*/
 void specksense_channel_add(unsigned int channel)
 {
   queue_enqueue(jamsense_queue , channel);
@@ -400,7 +673,7 @@ void specksense_channel_add(unsigned int channel)
 /*---------------------------------------------------------------------------*/
 void specksense_channel_remove(void)
 {
-  queue_dequeue(jamsense_queue);
+  channel_release(specksense_channel_peek());
 }
 /*---------------------------------------------------------------------------*/
 int specksense_channel_peek(void)
@@ -470,43 +743,60 @@ PROCESS(classification, "classification process");
 PROCESS_THREAD(classification, ev, data)
 {
 	//static rtimer_clock_t start;
+	static uint8_t remove_channel;
 	PROCESS_BEGIN();
  
         classification_status = 1;
-		init_kmeans(&record, rle_ptr);
+		kmeans_set_suspicion(&classify_ctx->suspicion);
+#if ONLINE_KMEANS
+		/* Centroids are already up to date, only the open run is missing */
+		if(classify_ctx->run_duration > 0)
+		{
+			kmeans_online_update(&classify_ctx->kmeans, classify_ctx->run_level, classify_ctx->run_duration);
+		}
+		n_clusters = kmeans_online_classify(&classify_ctx->kmeans);
+#else
+		init_kmeans(&record, classify_ctx->sample_cnt);
 		while(n_clusters == -1)
 		{
-			n_clusters = kmeans(&record, rle_ptr);
+			n_clusters = kmeans(&record, classify_ctx->sample_cnt);
 			if(n_clusters == -1)
 			{
 				PROCESS_WAIT_EVENT_UNTIL(ev == PROCESS_EVENT_POLL);
 			}
 		}
-		LOG_INFO("kmeans %d clusters!\n",n_clusters);
-		specksense_loop++;
+#endif
+		LOG_INFO("CH%d: kmeans %d clusters!\n",classify_ctx->channel,n_clusters);
+		classify_ctx->specksense_loop++;
         if((RTIMER_NOW() + 4000) > rssi_stop_time)
 		{
 			PROCESS_WAIT_EVENT_UNTIL(ev == PROCESS_EVENT_POLL);
 		}
 
+		remove_channel = 0;
 		if (n_clusters > 0 )
 		{
 			//if find jammer, remove channel
 			if(check_similarity(/*PROFILING*/ 0))
 			{
-				specksense_loop = 0;
-				specksense_channel_remove();
+				remove_channel = 1;
 			}
 		}
 
 		//if havent found jammer within 2 specksense loop, remove channel
-		if(specksense_loop >= 2)
+		if(classify_ctx->specksense_loop >= 2)
 		{
-			specksense_loop = 0;
-			specksense_channel_remove();
+			remove_channel = 1;
 		}
 
-		sample_cnt = 0;
+		rle_reset(classify_ctx);
+		if(remove_channel)
+		{
+			queue_remove(jamsense_queue, classify_ctx->channel);
+			context_reset(classify_ctx, 0);
+		}
+		classify_ctx = NULL;
+		kmeans_set_suspicion(NULL);
 		n_clusters = -1;
         classification_status = 0;
 
@@ -528,40 +818,61 @@ void classification_process()
 /*---------------------------------------------------------------------------*/
 int specksense_process()
 {
+	struct channel_context *ctx;
+	int channel_rssi;
+
 	//LOG_INFO("specksense!\n");
-	//When there is enough samples, do kmeans. Otherwise do RSSI
-	if (sample_cnt >= RUN_LENGTH)
-	{		
+#if SPECKSENSE_RSSI_CAPTURE
+	//Scan still running in the background
+	if (rssi_capture_pending())
+	{
+		return 0;
+	}
+#endif
+	//Classification still running, let it continue
+	if (classify_ctx != NULL)
+	{
 		classification_process();
 		return 1;
 	}
-	else
-	{
-#if TSCH_WITH_JAMSENSE == 1
-		int channel_rssi = specksense_channel_peek();
-		if (channel_rssi != 0 && check_jammer_status(channel_rssi))
-		{
-			rssi_sampler(SAMPLE_AMOUNT,channel_rssi,rssi_stop_time);
-		}
 
-		/*Doing Rssi when target channel is curent tsch channel*/
-		// if (channel_rssi == tsch_current_channel && check_jammer_status(channel_rssi))
-		// {
-		// 	rssi_sampler(SAMPLE_AMOUNT,channel_rssi,rssi_stop_time);
-		// }
+#if TSCH_WITH_JAMSENSE == 1
+	channel_rssi = specksense_channel_peek();
+	if (channel_rssi == 0 || !check_jammer_status(channel_rssi))
+	{
+		return 0;
+	}
+	/*Rotate the queue so that every queued channel keeps building its own model*/
+	queue_remove(jamsense_queue, channel_rssi);
+	queue_enqueue(jamsense_queue, channel_rssi);
+
+	/*Doing Rssi when target channel is curent tsch channel*/
+	// if (channel_rssi == tsch_current_channel && check_jammer_status(channel_rssi))
+	// {
+	// 	rssi_sampler(SAMPLE_AMOUNT,channel_rssi,rssi_stop_time);
+	// }
 #else
-		rssi_stop_time = RTIMER_NOW() + 1000000;
-		specksense_channel_add(26);
-		int channel_rssi = specksense_channel_peek();
-		if (channel_rssi != 0)
-		{
-			rssi_sampler(SAMPLE_AMOUNT,channel_rssi,rssi_stop_time);
-		}
-		if(0)
-		{
-			check_jammer_status(channel_rssi);
-		}
-#endif
+	rssi_stop_time = RTIMER_NOW() + 1000000;
+	specksense_channel_add(26);
+	channel_rssi = specksense_channel_peek();
+	if (channel_rssi == 0)
+	{
 		return 0;
 	}
-}
\ No newline at end of file
+	if(0)
+	{
+		check_jammer_status(channel_rssi);
+	}
+#endif
+
+	//When there is enough samples of this channel, do kmeans. Otherwise do RSSI
+	ctx = context_lookup(channel_rssi, true);
+	if (ctx != NULL && ctx->sample_cnt >= RUN_LENGTH)
+	{
+		classify_ctx = ctx;
+		classification_process();
+		return 1;
+	}
+	rssi_sampler(SAMPLE_AMOUNT,channel_rssi,rssi_stop_time);
+	return 0;
+}
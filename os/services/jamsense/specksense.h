@@ -37,8 +37,14 @@
 #ifndef SPECKSENSE_H__
 #define SPECKSENSE_H__
 
+#include <stddef.h>
+
 extern rtimer_clock_t rssi_stop_time;
 
+/* #define this callback to act on jammer verdicts, e.g. to report them to the
+ * TSCH coordinator for tsch_cs_channel_jammed() */
+/* SPECKSENSE_CALLBACK_JAMMER_DETECTED(channel, type); */
+
 /**
  * \brief update time and type for jammer in the channel
  * \param channel     jammer channel
@@ -46,10 +52,29 @@ extern rtimer_clock_t rssi_stop_time;
  */
 void update_jammer_status(int channel, int type);
 
+/**
+ * \brief Latest jammer verdict for a channel
+ * \param channel     channel to look up
+ * \retval 1 for proactive jammer, 2 for reactive jammer, 0 if none was classified within the last minute
+ */
+int specksense_jammer_type(int channel);
+
 /**
  * \brief Initializes the rssi quantization levels.
  */
 void init_power_levels(void);
+
+/**
+ * \brief Drops all channel contexts, queued channels and jammer records.
+ */
+void specksense_reset(void);
+
+/**
+ * \brief Static RAM of the sampler and classifier buffers, including the
+ *        RSSI capture batch. Stack usage is not included.
+ * \retval size in bytes
+ */
+size_t specksense_state_size(void);
     
 /**
  * \brief RSSI sampler stores power level and duration into 2D vector, will stop if time is not enough for another sample.
@@ -48,6 +48,7 @@
 #include "lib/list.h"
 #include "sys/log.h"
 #include "dev/watchdog.h"
+#include "sys/profile.h"
 #include "net/ipv6/uip.h"
 #include "net/ipv6/uiplib.h"
 #include "net/ipv6/uip-icmp6.h"
@@ -796,6 +797,57 @@ PT_THREAD(cmd_reboot(struct pt *pt, shell_output_func output, char *args))
   watchdog_reboot();
   PT_END(pt);
 }
+#if PROFILE_ON
+/*---------------------------------------------------------------------------*/
+static unsigned long
+profile_ticks_to_us(uint32_t ticks)
+{
+  return (unsigned long)((uint64_t)ticks * 1000000 / PROFILE_SECOND);
+}
+/*---------------------------------------------------------------------------*/
+static
+PT_THREAD(cmd_profile(struct pt *pt, shell_output_func output, char *args))
+{
+  struct profile_probe *probe;
+  char *next_args;
+  int i;
+
+  PT_BEGIN(pt);
+
+  SHELL_ARGS_INIT(args, next_args);
+  SHELL_ARGS_NEXT(args, next_args);
+  if(args != NULL && !strcmp(args, "reset")) {
+    profile_reset();
+    SHELL_OUTPUT(output, "Profile cleared\n");
+    PT_EXIT(pt);
+  }
+
+  SHELL_OUTPUT(output, "Profile (us): probe, count, min, mean, max, histogram\n");
+  for(probe = profile_head(); probe != NULL; probe = probe->next) {
+    SHELL_OUTPUT(output, "-- %-16s %8lu %8lu %8lu %8lu\n", probe->name,
+                 (unsigned long)probe->count,
+                 profile_ticks_to_us(probe->min),
+                 profile_ticks_to_us(probe->count ? probe->total / probe->count : 0),
+                 profile_ticks_to_us(probe->max));
+    /* The upper bound of each bin that is not empty, and its count */
+    SHELL_OUTPUT(output, "  ");
+    for(i = 0; i < PROFILE_HISTOGRAM_BINS; i++) {
+      if(probe->histogram[i] != 0) {
+        if(i < PROFILE_HISTOGRAM_BINS - 1) {
+          SHELL_OUTPUT(output, " <%lu:%u",
+                       profile_ticks_to_us(2UL << i), probe->histogram[i]);
+        } else {
+          SHELL_OUTPUT(output, " >=%lu:%u",
+                       profile_ticks_to_us(1UL << i), probe->histogram[i]);
+        }
+      }
+    }
+    SHELL_OUTPUT(output, "\n");
+  }
+
+  PT_END(pt);
+}
+#endif /* PROFILE_ON */
 #if MAC_CONF_WITH_TSCH
 /*---------------------------------------------------------------------------*/
 static
@@ -981,6 +1033,9 @@ const struct shell_command_t builtin_shell_commands[] = {
   { "reboot",               cmd_reboot,               "'> reboot': Reboot the board by watchdog_reboot()" },
   { "log",                  cmd_log,                  "'> log module level': Sets log level (0--4) for a given module (or \"all\"). For module \"mac\", level 4 also enables per-slot logging." },
   { "mac-addr",             cmd_macaddr,               "'> mac-addr': Shows the node's MAC address" },
+#if PROFILE_ON
+  { "profile",              cmd_profile,              "'> profile [reset]': Shows the execution times measured by the profiler probes, or clears them" },
+#endif /* PROFILE_ON */
 #if NETSTACK_CONF_WITH_IPV6
   { "ip-addr",              cmd_ipaddr,               "'> ip-addr': Shows all IPv6 addresses" },
   { "ip-nbr",               cmd_ip_neighbors,         "'> ip-nbr': Shows all IPv6 neighbors" },
@@ -60,6 +60,12 @@
 /* A potential for change detected? */
 static bool recaculation_requested;
 
+/* A jammer was reported: replace channels regardless of the update interval */
+static bool jamming_reported;
+
+/* Time (in seconds) when channels were reported as jammed; 0 if they are not */
+static uint32_t tsch_cs_jammed_since[TSCH_STATS_NUM_CHANNELS];
+
 /* Time (in seconds) when channels were marked as busy; 0 if they are not busy */
 static uint32_t tsch_cs_busy_since[TSCH_STATS_NUM_CHANNELS];
 
@@ -104,6 +110,27 @@ tsch_cs_bitmap_calc(void)
   return result;
 }
 /*---------------------------------------------------------------------------*/
+static bool
+tsch_cs_is_jammed(uint8_t channel, uint32_t now)
+{
+  uint32_t since = tsch_cs_jammed_since[channel - TSCH_STATS_FIRST_CHANNEL];
+  return since != 0 && since + TSCH_CS_JAMMED_DURATION_SEC > now;
+}
+/*---------------------------------------------------------------------------*/
+static tsch_cs_bitmap_t
+tsch_cs_jammed_bitmap(void)
+{
+  tsch_cs_bitmap_t result = 0;
+  uint32_t now = clock_seconds();
+  int i;
+  for(i = 0; i < TSCH_STATS_NUM_CHANNELS; ++i) {
+    if(tsch_cs_is_jammed(i + TSCH_STATS_FIRST_CHANNEL, now)) {
+      result = tsch_cs_bitmap_set(result, i + TSCH_STATS_FIRST_CHANNEL);
+    }
+  }
+  return result;
+}
+/*---------------------------------------------------------------------------*/
 void
 tsch_cs_adaptations_init(void)
 {
@@ -198,6 +225,7 @@ tsch_cs_process(void)
   struct tsch_cs_quality qualities[TSCH_STATS_NUM_CHANNELS];
   uint8_t is_channel_busy[TSCH_STATS_NUM_CHANNELS];
   uint8_t is_in_sequence[TSCH_STATS_NUM_CHANNELS];
+  tsch_cs_bitmap_t jammed;
   static uint32_t last_time_changed;
 
   if(!recaculation_requested) {
@@ -205,17 +233,23 @@ tsch_cs_process(void)
     return false;
   }
 
-  if(last_time_changed != 0 && last_time_changed + TSCH_CS_MIN_UPDATE_INTERVAL_SEC > clock_seconds()) {
+  if(!jamming_reported && last_time_changed != 0
+     && last_time_changed + TSCH_CS_MIN_UPDATE_INTERVAL_SEC > clock_seconds()) {
     /* too soon */
     return false;
   }
 
-  /* reset the flag */
+  /* reset the flags */
   recaculation_requested = false;
+  jamming_reported = false;
+
+  jammed = tsch_cs_jammed_bitmap();
 
   for(i = 0; i < TSCH_STATS_NUM_CHANNELS; ++i) {
     qualities[i].channel = i + TSCH_STATS_FIRST_CHANNEL;
-    qualities[i].metric = tsch_stats.channel_free_ewma[i];
+    /* a jammed channel is as bad as a channel can get */
+    qualities[i].metric = tsch_cs_bitmap_contains(jammed, qualities[i].channel) ?
+        0 : tsch_stats.channel_free_ewma[i];
   }
 
   /* bubble sort the channels */
@@ -223,7 +257,8 @@ tsch_cs_process(void)
 
   /* start with the threshold values */
   for(i = 0; i < TSCH_STATS_NUM_CHANNELS; ++i) {
-    is_channel_busy[i] = (tsch_stats.channel_free_ewma[i] < TSCH_CS_FREE_THRESHOLD);
+    is_channel_busy[i] = (tsch_stats.channel_free_ewma[i] < TSCH_CS_FREE_THRESHOLD)
+        || tsch_cs_bitmap_contains(jammed, i + TSCH_STATS_FIRST_CHANNEL);
   }
   memset(is_in_sequence, 0xff, sizeof(is_in_sequence));
   for(i = 0; i < tsch_hopping_sequence_length.val; ++i) {
@@ -285,6 +320,11 @@ tsch_cs_process(void)
 
   if(has_replaced) {
     last_time_changed = clock_seconds();
+    if(tsch_cs_current_bitmap & jammed) {
+      /* more jammed channels to replace, one per call */
+      recaculation_requested = true;
+      jamming_reported = true;
+    }
     return true;
   }
 
@@ -326,3 +366,35 @@ tsch_cs_channel_stats_updated(uint8_t updated_channel, uint16_t old_busyness_met
     }
   }
 }
+/*---------------------------------------------------------------------------*/
+void
+tsch_cs_channel_jammed(uint8_t channel, uint8_t jammer_type, uint16_t age_sec)
+{
+  uint32_t now = clock_seconds();
+  uint32_t since;
+
+  /* Enable this only on the coordinator node */
+  if(!tsch_is_coordinator) {
+    return;
+  }
+
+  if(channel < TSCH_STATS_FIRST_CHANNEL
+     || channel >= TSCH_STATS_FIRST_CHANNEL + TSCH_STATS_NUM_CHANNELS
+     || age_sec >= TSCH_CS_JAMMED_DURATION_SEC) {
+    return;
+  }
+
+  LOG_INFO("ch %u: %s jammer reported %us ago\n", channel,
+           jammer_type == 2 ? "reactive" : "proactive", age_sec);
+
+  /* keep the most recent detection; 0 is reserved for "not jammed" */
+  since = now > age_sec ? now - age_sec : 1;
+  if(since > tsch_cs_jammed_since[channel - TSCH_STATS_FIRST_CHANNEL]) {
+    tsch_cs_jammed_since[channel - TSCH_STATS_FIRST_CHANNEL] = since;
+  }
+
+  if(tsch_cs_bitmap_contains(tsch_cs_current_bitmap, channel)) {
+    recaculation_requested = true;
+    jamming_reported = true;
+  }
+}
@@ -50,6 +50,13 @@
 
 #define TSCH_CS_LEARNING_PERIOD_SEC 30
 
+/* How long a channel reported as jammed is kept out of the hopping sequence */
+#ifdef TSCH_CS_CONF_JAMMED_DURATION_SEC
+#define TSCH_CS_JAMMED_DURATION_SEC TSCH_CS_CONF_JAMMED_DURATION_SEC
+#else
+#define TSCH_CS_JAMMED_DURATION_SEC 60
+#endif
+
 /**
  * \brief Initializes the TSCH hopping sequence selection module.
  */
@@ -68,6 +75,20 @@ void tsch_cs_channel_stats_updated(uint8_t updated_channel, uint16_t old_busynes
  */
 bool tsch_cs_process(void);
 
+/**
+ * \brief Report a jammer on a channel, e.g. a jamsense verdict.
+ * \param channel     The jammed channel
+ * \param jammer_type 1 for a proactive jammer, 2 for a reactive one
+ * \param age_sec     Seconds since the jammer was classified
+ *
+ * Only has an effect on the coordinator. The channel is treated as fully
+ * busy for TSCH_CS_JAMMED_DURATION_SEC after detection, and it is replaced
+ * in the hopping sequence without waiting for the learning period or the
+ * minimum update interval. The new sequence reaches the rest of the
+ * network in EBs (TSCH_PACKET_CONF_EB_WITH_HOPPING_SEQUENCE).
+ */
+void tsch_cs_channel_jammed(uint8_t channel, uint8_t jammer_type, uint16_t age_sec);
+
 
 /* A bit corresponds to a channel; `uint16_t` value is OK for up to 16 channels. */
 typedef uint16_t tsch_cs_bitmap_t;
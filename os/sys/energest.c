@@ -46,6 +46,18 @@ uint64_t energest_total_time[ENERGEST_TYPE_MAX];
 ENERGEST_TIME_T energest_current_time[ENERGEST_TYPE_MAX];
 unsigned char energest_current_mode[ENERGEST_TYPE_MAX];
 
+#if ENERGEST_WITH_PROCESSES
+uint32_t energest_process_times[ENERGEST_PROCESSES_MAX + 1][ENERGEST_TYPE_MAX];
+unsigned char energest_process_current;
+/* The process of each entry, NULL for entry 0 */
+static struct process *processes[ENERGEST_PROCESSES_MAX + 1];
+static unsigned char processes_count = 1;
+static struct process *current;
+
+/* The entry of a process that has none */
+#define ENTRY_NONE 0xff
+#endif /* ENERGEST_WITH_PROCESSES */
+
 /*---------------------------------------------------------------------------*/
 void
 energest_init(void)
@@ -62,17 +74,63 @@ void
 energest_flush(void)
 {
   uint64_t now;
+  ENERGEST_TIME_T elapsed;
   int i;
   for(i = 0; i < ENERGEST_TYPE_MAX; i++) {
     if(energest_current_mode[i]) {
       now = ENERGEST_CURRENT_TIME();
-      energest_total_time[i] +=
-        (ENERGEST_TIME_T)(now - energest_current_time[i]);
+      elapsed = (ENERGEST_TIME_T)(now - energest_current_time[i]);
+      energest_total_time[i] += elapsed;
+      ENERGEST_ATTRIBUTE(i, elapsed);
       energest_current_time[i] = now;
     }
   }
 }
 /*---------------------------------------------------------------------------*/
+#if ENERGEST_WITH_PROCESSES
+struct process *
+energest_process_switch(struct process *p)
+{
+  struct process *prev = current;
+
+  if(p == current) {
+    return prev;
+  }
+
+  /* Attribute the time so far to the previous process */
+  energest_flush();
+  current = p;
+
+  if(p == NULL) {
+    energest_process_current = 0;
+    return prev;
+  }
+  if(p->energest_entry == 0) {
+    if(processes_count <= ENERGEST_PROCESSES_MAX) {
+      processes[processes_count] = p;
+      p->energest_entry = processes_count++;
+    } else {
+      p->energest_entry = ENTRY_NONE;
+    }
+  }
+  energest_process_current =
+    p->energest_entry == ENTRY_NONE ? 0 : p->energest_entry;
+  return prev;
+}
+/*---------------------------------------------------------------------------*/
+int
+energest_process_count(void)
+{
+  return processes_count;
+}
+/*---------------------------------------------------------------------------*/
+struct process *
+energest_process_get(int index)
+{
+  return index < processes_count ? processes[index] : NULL;
+}
+#endif /* ENERGEST_WITH_PROCESSES */
+/*---------------------------------------------------------------------------*/
 uint64_t
 energest_get_total_time(void)
 {
@@ -73,6 +73,26 @@
 #endif /* ENERGEST_CONF_SECOND */
 #endif /* ENERGEST_SECOND */
 
+/*
+ * Attribute the energest times to the process running, or in whose
+ * context (PROCESS_CONTEXT_BEGIN()) the code runs. Time spent outside
+ * processes, e.g. in interrupts between two processes or in low power
+ * mode, is attributed to entry 0.
+ */
+#ifdef ENERGEST_CONF_WITH_PROCESSES
+#define ENERGEST_WITH_PROCESSES (ENERGEST_CONF_WITH_PROCESSES && ENERGEST_CONF_ON)
+#else /* ENERGEST_CONF_WITH_PROCESSES */
+#define ENERGEST_WITH_PROCESSES 0
+#endif /* ENERGEST_CONF_WITH_PROCESSES */
+
+/* The number of processes with their own entry. The processes started
+ * after these are attributed to entry 0. */
+#ifdef ENERGEST_CONF_PROCESSES_MAX
+#define ENERGEST_PROCESSES_MAX ENERGEST_CONF_PROCESSES_MAX
+#else /* ENERGEST_CONF_PROCESSES_MAX */
+#define ENERGEST_PROCESSES_MAX 8
+#endif /* ENERGEST_CONF_PROCESSES_MAX */
+
 #ifndef ENERGEST_GET_TOTAL_TIME
 #ifdef ENERGEST_CONF_GET_TOTAL_TIME
 #define ENERGEST_GET_TOTAL_TIME ENERGEST_CONF_GET_TOTAL_TIME
@@ -111,6 +131,52 @@ void energest_flush(void);
 
 uint64_t ENERGEST_GET_TOTAL_TIME(void);
 
+#if ENERGEST_WITH_PROCESSES
+
+/* Times per process, wrapping, in ENERGEST_SECOND ticks */
+extern uint32_t energest_process_times[ENERGEST_PROCESSES_MAX + 1][ENERGEST_TYPE_MAX];
+extern unsigned char energest_process_current;
+
+#define ENERGEST_ATTRIBUTE(type, time) \
+  energest_process_times[energest_process_current][type] += (time)
+
+/**
+ * Attribute the energest times from now on to a process
+ * \param p The process, or NULL for time outside processes
+ * \return The process that the times were attributed to so far
+ */
+struct process *energest_process_switch(struct process *p);
+
+/**
+ * The number of entries of the per-process times, including entry 0
+ */
+int energest_process_count(void);
+
+/**
+ * The process of an entry of the per-process times
+ * \param index The entry, from 0 to energest_process_count() - 1
+ * \return The process, or NULL for entry 0
+ */
+struct process *energest_process_get(int index);
+
+/**
+ * The time attributed to the process of an entry, for a type
+ *
+ * The time wraps around, call energest_flush() first to include the
+ * time spent since the last energest update.
+ */
+static inline uint32_t
+energest_process_time(int index, energest_type_t type)
+{
+  return energest_process_times[index][type];
+}
+
+#else /* ENERGEST_WITH_PROCESSES */
+
+#define ENERGEST_ATTRIBUTE(type, time)
+
+#endif /* ENERGEST_WITH_PROCESSES */
+
 #if ENERGEST_CONF_ON
 
 extern uint64_t energest_total_time[ENERGEST_TYPE_MAX];
@@ -143,8 +209,10 @@ static inline void
 energest_off(energest_type_t type)
 {
  if(energest_current_mode[type] != 0) {
-   energest_total_time[type] +=
+   ENERGEST_TIME_T elapsed =
      (ENERGEST_TIME_T)(ENERGEST_CURRENT_TIME() - energest_current_time[type]);
+   energest_total_time[type] += elapsed;
+   ENERGEST_ATTRIBUTE(type, elapsed);
    energest_current_mode[type] = 0;
  }
 }
@@ -155,8 +223,10 @@ energest_switch(energest_type_t type_off, energest_type_t type_on)
 {
   ENERGEST_TIME_T energest_local_variable_now = ENERGEST_CURRENT_TIME();
   if(energest_current_mode[type_off] != 0) {
-    energest_total_time[type_off] += (ENERGEST_TIME_T)
+    ENERGEST_TIME_T elapsed = (ENERGEST_TIME_T)
       (energest_local_variable_now - energest_current_time[type_off]);
+    energest_total_time[type_off] += elapsed;
+    ENERGEST_ATTRIBUTE(type_off, elapsed);
     energest_current_mode[type_off] = 0;
   }
   if(energest_current_mode[type_on] == 0) {
@@ -54,6 +54,220 @@ static clock_time_t next_expiration;
 
 PROCESS(etimer_process, "Event timer");
 /*---------------------------------------------------------------------------*/
+#if ETIMER_WITH_HEAP
+/* The heap is ordered by time left at heap_now. Time left only goes
+   down, by the same amount for all timers and stopping at zero, so the
+   order holds whenever it is compared. The exception is a timer that
+   is expired when it is added, for instance reset before it expired:
+   its start time is ahead, and once that is reached the timer is no
+   longer expired. heap_resort tells the next poll to rebuild the heap
+   in case this happened. */
+static clock_time_t heap_now;
+static bool heap_resort;
+/*---------------------------------------------------------------------------*/
+static clock_time_t
+time_left(struct etimer *t)
+{
+  clock_time_t passed = heap_now - t->timer.start;
+
+  /* Expired as in timer_expired() */
+  if(t->timer.interval < (clock_time_t)(passed + 1)) {
+    return 0;
+  }
+  return t->timer.interval - passed;
+}
+/*---------------------------------------------------------------------------*/
+/* Whether a expires before b. Expired timers are kept in the order of
+   their expiration times, so that they fire in that order. */
+static bool
+heap_before(struct etimer *a, struct etimer *b)
+{
+  clock_time_t left_a = time_left(a);
+  clock_time_t left_b = time_left(b);
+
+  if(left_a == 0 && left_b == 0) {
+    return (clock_time_t)(a->timer.start + a->timer.interval -
+                          b->timer.start - b->timer.interval) >
+      (clock_time_t)(b->timer.start + b->timer.interval -
+                     a->timer.start - a->timer.interval);
+  }
+  return left_a < left_b;
+}
+/*---------------------------------------------------------------------------*/
+/* Merge two heaps, the one with more time left becomes the first child
+   of the other */
+static struct etimer *
+heap_meld(struct etimer *a, struct etimer *b)
+{
+  struct etimer *t;
+
+  if(a == NULL) {
+    return b;
+  }
+  if(b == NULL) {
+    return a;
+  }
+  if(heap_before(b, a)) {
+    t = a;
+    a = b;
+    b = t;
+  }
+  b->prev = a;
+  b->next = a->child;
+  if(a->child != NULL) {
+    a->child->prev = b;
+  }
+  a->child = b;
+  return a;
+}
+/*---------------------------------------------------------------------------*/
+/* Merge a list of sibling heaps into one: meld them in pairs from left
+   to right, then meld the pairs from right to left */
+static struct etimer *
+heap_merge_pairs(struct etimer *t)
+{
+  struct etimer *a, *b;
+  struct etimer *pairs = NULL;
+
+  while(t != NULL) {
+    a = t;
+    b = t->next;
+    t = b != NULL ? b->next : NULL;
+    a->next = a->prev = NULL;
+    if(b != NULL) {
+      b->next = b->prev = NULL;
+    }
+    a = heap_meld(a, b);
+    a->next = pairs;
+    pairs = a;
+  }
+
+  while(pairs != NULL) {
+    a = pairs;
+    pairs = pairs->next;
+    a->next = NULL;
+    t = heap_meld(t, a);
+  }
+  return t;
+}
+/*---------------------------------------------------------------------------*/
+static void
+heap_add(struct etimer *t)
+{
+  t->child = t->next = t->prev = NULL;
+  t->in_heap = 1;
+  if(time_left(t) == 0) {
+    heap_resort = true;
+  }
+  timerlist = heap_meld(timerlist, t);
+}
+/*---------------------------------------------------------------------------*/
+static void
+heap_remove(struct etimer *t)
+{
+  struct etimer *children = t->child;
+
+  if(t == timerlist) {
+    timerlist = heap_merge_pairs(children);
+  } else {
+    /* Unlink from the parent or previous sibling */
+    if(t->prev->child == t) {
+      t->prev->child = t->next;
+    } else {
+      t->prev->next = t->next;
+    }
+    if(t->next != NULL) {
+      t->next->prev = t->prev;
+    }
+    timerlist = heap_meld(timerlist, heap_merge_pairs(children));
+  }
+  t->child = t->next = t->prev = NULL;
+  t->in_heap = 0;
+}
+/*---------------------------------------------------------------------------*/
+/* Take all timers apart and merge them again, in the order of time
+   left at heap_now */
+static void
+heap_rebuild(void)
+{
+  struct etimer *todo = timerlist;
+  struct etimer *all = NULL;
+  struct etimer *t, *c, *next;
+
+  while(todo != NULL) {
+    t = todo;
+    todo = t->next;
+    for(c = t->child; c != NULL; c = next) {
+      next = c->next;
+      c->next = todo;
+      todo = c;
+    }
+    t->child = t->prev = NULL;
+    t->next = all;
+    all = t;
+  }
+
+  timerlist = NULL;
+  while(all != NULL) {
+    t = all;
+    all = all->next;
+    t->next = NULL;
+    timerlist = heap_meld(timerlist, t);
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* Whether the timer is in the heap. The flag alone is not trusted, as a
+   timer that was never set may hold leftovers in it: every timer in the
+   heap is either its root or linked to a parent or previous sibling */
+static int
+heap_contains(struct etimer *t)
+{
+  return t->in_heap && (t == timerlist || t->prev != NULL);
+}
+/*---------------------------------------------------------------------------*/
+/* Find a timer of process p, walking the heap in preorder */
+static struct etimer *
+heap_find(struct process *p)
+{
+  struct etimer *t = timerlist;
+
+  while(t != NULL) {
+    if(t->p == p) {
+      return t;
+    }
+    if(t->child != NULL) {
+      t = t->child;
+    } else {
+      /* Go up until there is a next sibling. The parent is the prev of
+         the first sibling. */
+      while(t != NULL && t->next == NULL) {
+        while(t->prev != NULL && t->prev->child != t) {
+          t = t->prev;
+        }
+        t = t->prev;
+      }
+      if(t != NULL) {
+        t = t->next;
+      }
+    }
+  }
+  return NULL;
+}
+/*---------------------------------------------------------------------------*/
+static void
+update_time(void)
+{
+  if(timerlist == NULL) {
+    next_expiration = 0;
+  } else if(heap_resort) {
+    /* The order is not known until the next poll, which is due now */
+    next_expiration = heap_now;
+  } else {
+    next_expiration = timerlist->timer.start + timerlist->timer.interval;
+  }
+}
+#else /* ETIMER_WITH_HEAP */
+/*---------------------------------------------------------------------------*/
 static void
 update_time(void)
 {
@@ -76,10 +290,14 @@ update_time(void)
     next_expiration = now + tdist;
   }
 }
+#endif /* ETIMER_WITH_HEAP */
 /*---------------------------------------------------------------------------*/
 PROCESS_THREAD(etimer_process, ev, data)
 {
-  struct etimer *t, *u;
+  struct etimer *t;
+#if !ETIMER_WITH_HEAP
+  struct etimer *u;
+#endif /* !ETIMER_WITH_HEAP */
 
   PROCESS_BEGIN();
 
@@ -91,6 +309,13 @@ PROCESS_THREAD(etimer_process, ev, data)
     if(ev == PROCESS_EVENT_EXITED) {
       struct process *p = data;
 
+#if ETIMER_WITH_HEAP
+      heap_now = clock_time();
+      while((t = heap_find(p)) != NULL) {
+        heap_remove(t);
+      }
+      update_time();
+#else /* ETIMER_WITH_HEAP */
       while(timerlist != NULL && timerlist->p == p) {
         timerlist = timerlist->next;
       }
@@ -105,11 +330,36 @@ PROCESS_THREAD(etimer_process, ev, data)
           }
         }
       }
+#endif /* ETIMER_WITH_HEAP */
       continue;
     } else if(ev != PROCESS_EVENT_POLL) {
       continue;
     }
 
+#if ETIMER_WITH_HEAP
+    /* Expired timers are at the root, earliest expiration first */
+    heap_now = clock_time();
+    if(heap_resort) {
+      heap_resort = false;
+      heap_rebuild();
+    }
+    while(timerlist != NULL && timer_expired(&timerlist->timer)) {
+      t = timerlist;
+      if(process_post(t->p, PROCESS_EVENT_TIMER, t) == PROCESS_ERR_OK) {
+        /* Reset the process ID of the event timer, to signal that the
+           etimer has expired. This is later checked in the
+           etimer_expired() function. */
+        t->p = PROCESS_NONE;
+        heap_remove(t);
+      } else {
+        /* Try again later, the timers may be reordered by then */
+        heap_resort = true;
+        etimer_request_poll();
+        break;
+      }
+    }
+    update_time();
+#else /* ETIMER_WITH_HEAP */
 again:
 
     u = NULL;
@@ -136,6 +386,7 @@ again:
       }
       u = t;
     }
+#endif /* ETIMER_WITH_HEAP */
   }
 
   PROCESS_END();
@@ -150,6 +401,19 @@ etimer_request_poll(void)
 static void
 add_timer(struct etimer *timer)
 {
+#if ETIMER_WITH_HEAP
+  etimer_request_poll();
+
+  heap_now = clock_time();
+  if(timer->p != PROCESS_NONE && heap_contains(timer)) {
+    /* Timer already in the heap, its expiration time may have changed */
+    heap_remove(timer);
+  }
+  timer->p = PROCESS_CURRENT();
+  heap_add(timer);
+
+  update_time();
+#else /* ETIMER_WITH_HEAP */
   struct etimer *t;
 
   etimer_request_poll();
@@ -171,6 +435,7 @@ add_timer(struct etimer *timer)
   timerlist = timer;
 
   update_time();
+#endif /* ETIMER_WITH_HEAP */
 }
 /*---------------------------------------------------------------------------*/
 void
@@ -205,7 +470,19 @@ etimer_restart(struct etimer *et)
 void
 etimer_adjust(struct etimer *et, int timediff)
 {
+#if ETIMER_WITH_HEAP
+  heap_now = clock_time();
+  if(et->p != PROCESS_NONE && heap_contains(et)) {
+    /* Move the timer to its new place in the heap */
+    heap_remove(et);
+    et->timer.start += timediff;
+    heap_add(et);
+  } else {
+    et->timer.start += timediff;
+  }
+#else /* ETIMER_WITH_HEAP */
   et->timer.start += timediff;
+#endif /* ETIMER_WITH_HEAP */
   update_time();
 }
 /*---------------------------------------------------------------------------*/
@@ -242,6 +519,13 @@ etimer_next_expiration_time(void)
 void
 etimer_stop(struct etimer *et)
 {
+#if ETIMER_WITH_HEAP
+  heap_now = clock_time();
+  if(et->p != PROCESS_NONE && heap_contains(et)) {
+    heap_remove(et);
+    update_time();
+  }
+#else /* ETIMER_WITH_HEAP */
   struct etimer *t;
 
   /* First check if et is the first event timer on the list. */
@@ -263,6 +547,7 @@ etimer_stop(struct etimer *et)
       update_time();
     }
   }
+#endif /* ETIMER_WITH_HEAP */
 
   /* Remove the next pointer from the item to be removed. */
   et->next = NULL;
@@ -65,6 +65,18 @@
 
 #include "contiki.h"
 
+/*
+ * Keep the pending event timers in a pairing heap ordered by time left,
+ * instead of an unsorted list. Timers are added in constant time,
+ * removed in logarithmic amortized time, and the next expiration time
+ * is always at the root.
+ */
+#ifdef ETIMER_CONF_WITH_HEAP
+#define ETIMER_WITH_HEAP ETIMER_CONF_WITH_HEAP
+#else
+#define ETIMER_WITH_HEAP 0
+#endif
+
 /**
  * A timer.
  *
@@ -77,6 +89,15 @@ struct etimer {
   struct timer timer;
   struct etimer *next;
   struct process *p;
+#if ETIMER_WITH_HEAP
+  /* First child in the heap, and previous sibling or parent. next is
+     the next sibling. */
+  struct etimer *child;
+  struct etimer *prev;
+  /* Set while the timer is in the heap, the links are only followed
+     then */
+  uint8_t in_heap;
+#endif /* ETIMER_WITH_HEAP */
 };
 
 /**
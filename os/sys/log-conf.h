@@ -75,13 +75,27 @@
 #define LOG_WITH_ANNOTATE 0
 #endif /* LOG_CONF_WITH_ANNOTATE */
 
+/* Defer formatting: logs are stored in binary form in a ring buffer and
+ * printed later by a process, see log-deferred.h */
+#ifdef LOG_CONF_DEFERRED
+#define LOG_DEFERRED LOG_CONF_DEFERRED
+#else /* LOG_CONF_DEFERRED */
+#define LOG_DEFERRED 0
+#endif /* LOG_CONF_DEFERRED */
+
 /* Custom output function -- default is printf */
 #ifdef LOG_CONF_OUTPUT
-#define LOG_OUTPUT(...) LOG_CONF_OUTPUT(__VA_ARGS__)
+#define LOG_OUTPUT_DIRECT(...) LOG_CONF_OUTPUT(__VA_ARGS__)
 #else /* LOG_CONF_OUTPUT */
-#define LOG_OUTPUT(...) printf(__VA_ARGS__)
+#define LOG_OUTPUT_DIRECT(...) printf(__VA_ARGS__)
 #endif /* LOG_CONF_OUTPUT */
 
+#if LOG_DEFERRED
+#define LOG_OUTPUT(...) log_deferred_printf(__VA_ARGS__)
+#else /* LOG_DEFERRED */
+#define LOG_OUTPUT(...) LOG_OUTPUT_DIRECT(__VA_ARGS__)
+#endif /* LOG_DEFERRED */
+
 /* Color the prefix based on the log level. Disabled by default */
 #ifdef LOG_CONF_WITH_COLOR
 #define LOG_WITH_COLOR LOG_CONF_WITH_COLOR
@@ -101,6 +115,8 @@
  */
 #ifdef LOG_CONF_OUTPUT_PREFIX
 #define LOG_OUTPUT_PREFIX(level, levelstr, module) LOG_CONF_OUTPUT_PREFIX(level, levelstr, module)
+#elif LOG_DEFERRED
+#define LOG_OUTPUT_PREFIX(level, levelstr, module) log_deferred_prefix(levelstr, module)
 #else /* LOG_CONF_OUTPUT_PREFIX */
 #define LOG_OUTPUT_PREFIX(level, levelstr, module) LOG_OUTPUT("[%-4s: %-10s] ", levelstr, module)
 #endif /* LOG_CONF_OUTPUT_PREFIX */
@@ -0,0 +1,499 @@
+/*
+ * Copyright (c) 2026, Contiki-NG contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \addtogroup log
+ * @{
+ *
+ * \file
+ *         Deferred logging to a lock-free ring buffer
+ */
+
+#include "contiki.h"
+#include "sys/log.h"
+#include "sys/memory-barrier.h"
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#if LOG_DEFERRED
+
+#if (LOG_DEFERRED_BUF_SIZE & (LOG_DEFERRED_BUF_SIZE - 1)) != 0
+#error LOG_DEFERRED_BUF_SIZE must be power of two
+#endif
+
+#if LOG_DEFERRED_BUF_SIZE > 32768
+#error LOG_DEFERRED_BUF_SIZE must be 32768 at most
+#endif
+
+#define RING_MASK (LOG_DEFERRED_BUF_SIZE - 1)
+
+/* A record is a length byte, a kind byte, one or two string pointers
+ * and, for printf records, the raw arguments in format string order.
+ * String arguments are copied, null-terminated. */
+#define MAX_RECORD_LEN 255
+#define RECORD_HDR_LEN 2
+#define KIND_PRINTF 0
+#define KIND_PREFIX 1
+
+/* Argument types, as given by the length modifier and conversion */
+enum arg_type {
+  ARG_NONE,
+  ARG_INT,
+  ARG_LONG,
+  ARG_LLONG,
+  ARG_SIZE,
+  ARG_INTMAX,
+  ARG_PTRDIFF,
+  ARG_PTR,
+  ARG_DOUBLE,
+  ARG_STR,
+};
+
+/* A conversion specification of the format string */
+struct spec {
+  const char *start; /* the '%' */
+  uint8_t len; /* length, from '%' to the conversion character */
+  uint8_t type; /* enum arg_type */
+  uint8_t width_star; /* width given as an argument */
+  uint8_t prec_star; /* precision given as an argument */
+  int precision; /* -1 if none */
+};
+
+union arg {
+  int i;
+  long l;
+  long long ll;
+  size_t z;
+  intmax_t j;
+  ptrdiff_t t;
+  void *p;
+  double d;
+};
+
+static const uint8_t arg_size[] = {
+  0, sizeof(int), sizeof(long), sizeof(long long), sizeof(size_t),
+  sizeof(intmax_t), sizeof(ptrdiff_t), sizeof(void *), sizeof(double), 0
+};
+
+static uint8_t ring[LOG_DEFERRED_BUF_SIZE];
+/* Free-running indices: head is written by the producer only, tail by
+ * the consumer only */
+static volatile uint16_t head;
+static volatile uint16_t tail;
+/* The drop count reported last by the consumer */
+static uint32_t dropped_reported;
+
+struct log_deferred_stats log_deferred_stats;
+
+PROCESS(log_deferred_process, "Deferred log");
+/*---------------------------------------------------------------------------*/
+/* Parse the conversion specification after a '%' */
+static const char *
+parse_spec(const char *p, struct spec *s)
+{
+  int lmod = 0;
+
+  s->start = p - 1;
+  s->width_star = 0;
+  s->prec_star = 0;
+  s->precision = -1;
+
+  while(*p == '-' || *p == '+' || *p == ' ' || *p == '#' || *p == '0') {
+    p++;
+  }
+  if(*p == '*') {
+    s->width_star = 1;
+    p++;
+  }
+  while(*p >= '0' && *p <= '9') {
+    p++;
+  }
+  if(*p == '.') {
+    p++;
+    s->precision = 0;
+    if(*p == '*') {
+      s->prec_star = 1;
+      p++;
+    }
+    while(*p >= '0' && *p <= '9') {
+      s->precision = s->precision * 10 + (*p++ - '0');
+    }
+  }
+  /* Length modifier: 'l' counts up, 'h' does not change promoted types */
+  for(;; p++) {
+    if(*p == 'h') {
+      continue;
+    } else if(*p == 'l') {
+      lmod++;
+    } else if(*p == 'z' || *p == 'j' || *p == 't' || *p == 'L') {
+      lmod = *p;
+    } else {
+      break;
+    }
+  }
+
+  switch(*p) {
+  case 'd': case 'i': case 'u': case 'x': case 'X': case 'o': case 'c':
+    s->type = lmod == 1 ? ARG_LONG : lmod == 2 ? ARG_LLONG
+      : lmod == 'z' ? ARG_SIZE : lmod == 'j' ? ARG_INTMAX
+      : lmod == 't' ? ARG_PTRDIFF : ARG_INT;
+    break;
+  case 'e': case 'E': case 'f': case 'F': case 'g': case 'G': case 'a': case 'A':
+    s->type = ARG_DOUBLE;
+    break;
+  case 's':
+    s->type = ARG_STR;
+    break;
+  case 'p': case 'n':
+    s->type = ARG_PTR;
+    break;
+  case '\0':
+    /* Truncated specification */
+    s->type = ARG_NONE;
+    s->len = p - s->start;
+    return p;
+  default:
+    /* "%%" and unknown conversions take no argument */
+    s->type = ARG_NONE;
+    break;
+  }
+  p++;
+  s->len = p - s->start;
+  return p;
+}
+/*---------------------------------------------------------------------------*/
+/* Append to the record being written, of which *used out of room bytes
+   are taken already */
+static int
+put(uint8_t *used, uint8_t room, const void *data, uint8_t len)
+{
+  uint16_t offset = (head + *used) & RING_MASK;
+  uint16_t first = MIN(len, LOG_DEFERRED_BUF_SIZE - offset);
+
+  if(len > room - *used) {
+    return 0;
+  }
+  memcpy(&ring[offset], data, first);
+  memcpy(&ring[0], (const uint8_t *)data + first, len - first);
+  *used += len;
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+/* Read from the record being rendered at *pos */
+static void
+get(uint16_t *pos, void *data, uint8_t len)
+{
+  uint16_t offset = *pos & RING_MASK;
+  uint16_t first = MIN(len, LOG_DEFERRED_BUF_SIZE - offset);
+
+  memcpy(data, &ring[offset], first);
+  memcpy((uint8_t *)data + first, &ring[0], len - first);
+  *pos += len;
+}
+/*---------------------------------------------------------------------------*/
+/* The number of bytes available for a new record, header included */
+static uint8_t
+record_room(void)
+{
+  uint16_t space = LOG_DEFERRED_BUF_SIZE - (uint16_t)(head - tail);
+  return MIN(space, MAX_RECORD_LEN);
+}
+/*---------------------------------------------------------------------------*/
+/* Publish the record of len bytes written at head */
+static void
+commit(uint8_t len, uint8_t kind)
+{
+  uint16_t used;
+
+  ring[head & RING_MASK] = len;
+  ring[(head + 1) & RING_MASK] = kind;
+  /* Make the record visible to the consumer only once it is complete */
+  memory_barrier();
+  head += len;
+
+  used = head - tail;
+  log_deferred_stats.records++;
+  if(used > log_deferred_stats.max_used) {
+    log_deferred_stats.max_used = used;
+  }
+  process_poll(&log_deferred_process);
+}
+/*---------------------------------------------------------------------------*/
+void
+log_deferred_printf(const char *fmt, ...)
+{
+  va_list ap;
+  uint8_t room = record_room();
+  uint8_t used = RECORD_HDR_LEN;
+  const char *p = fmt;
+  int ok;
+
+  if(room < RECORD_HDR_LEN + sizeof(fmt)) {
+    log_deferred_stats.dropped++;
+    return;
+  }
+
+  va_start(ap, fmt);
+  ok = put(&used, room, &fmt, sizeof(fmt));
+  while(ok && *p != '\0') {
+    struct spec s;
+    union arg a;
+    int width_or_prec;
+
+    if(*p++ != '%') {
+      continue;
+    }
+    p = parse_spec(p, &s);
+    if(s.width_star) {
+      width_or_prec = va_arg(ap, int);
+      ok = ok && put(&used, room, &width_or_prec, sizeof(int));
+    }
+    if(s.prec_star) {
+      width_or_prec = va_arg(ap, int);
+      s.precision = width_or_prec;
+      ok = ok && put(&used, room, &width_or_prec, sizeof(int));
+    }
+    switch(s.type) {
+    case ARG_INT: a.i = va_arg(ap, int); break;
+    case ARG_LONG: a.l = va_arg(ap, long); break;
+    case ARG_LLONG: a.ll = va_arg(ap, long long); break;
+    case ARG_SIZE: a.z = va_arg(ap, size_t); break;
+    case ARG_INTMAX: a.j = va_arg(ap, intmax_t); break;
+    case ARG_PTRDIFF: a.t = va_arg(ap, ptrdiff_t); break;
+    case ARG_PTR: a.p = va_arg(ap, void *); break;
+    case ARG_DOUBLE: a.d = va_arg(ap, double); break;
+    case ARG_STR:
+      {
+        const char *str = va_arg(ap, const char *);
+        uint8_t len = 0;
+        uint8_t max = LOG_DEFERRED_MAX_STRLEN;
+        if(s.precision >= 0 && s.precision < max) {
+          max = s.precision;
+        }
+        if(str == NULL) {
+          str = "(null)";
+        }
+        while(len < max && str[len] != '\0') {
+          len++;
+        }
+        ok = ok && put(&used, room, str, len) && put(&used, room, "", 1);
+      }
+      continue;
+    default:
+      continue;
+    }
+    ok = ok && put(&used, room, &a, arg_size[s.type]);
+  }
+  va_end(ap);
+
+  if(ok) {
+    commit(used, KIND_PRINTF);
+  } else {
+    log_deferred_stats.dropped++;
+  }
+}
+/*---------------------------------------------------------------------------*/
+void
+log_deferred_prefix(const char *levelstr, const char *module)
+{
+  uint8_t room = record_room();
+  uint8_t used = RECORD_HDR_LEN;
+
+  if(room >= RECORD_HDR_LEN + sizeof(levelstr) + sizeof(module)
+     && put(&used, room, &levelstr, sizeof(levelstr))
+     && put(&used, room, &module, sizeof(module))) {
+    commit(used, KIND_PREFIX);
+  } else {
+    log_deferred_stats.dropped++;
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* Print one conversion with its stored argument */
+static void
+render_spec(const struct spec *s, uint16_t *pos)
+{
+  char spec[16];
+  int star[2];
+  int nstars = 0;
+  union arg a;
+  char str[LOG_DEFERRED_MAX_STRLEN + 1];
+
+  if(s->width_star) {
+    get(pos, &star[nstars++], sizeof(int));
+  }
+  if(s->prec_star) {
+    get(pos, &star[nstars++], sizeof(int));
+  }
+  if(s->type == ARG_STR) {
+    uint8_t len = 0;
+    do {
+      get(pos, &str[len], 1);
+    } while(str[len++] != '\0');
+    a.p = str;
+  } else {
+    get(pos, &a, arg_size[s->type]);
+  }
+
+  if(s->len >= sizeof(spec)) {
+    /* Too long to render, skip the argument */
+    return;
+  }
+  memcpy(spec, s->start, s->len);
+  spec[s->len] = '\0';
+
+#define RENDER(arg) do { \
+    if(nstars == 2) { \
+      LOG_OUTPUT_DIRECT(spec, star[0], star[1], arg); \
+    } else if(nstars == 1) { \
+      LOG_OUTPUT_DIRECT(spec, star[0], arg); \
+    } else { \
+      LOG_OUTPUT_DIRECT(spec, arg); \
+    } \
+  } while(0)
+
+  switch(s->type) {
+  case ARG_INT: RENDER(a.i); break;
+  case ARG_LONG: RENDER(a.l); break;
+  case ARG_LLONG: RENDER(a.ll); break;
+  case ARG_SIZE: RENDER(a.z); break;
+  case ARG_INTMAX: RENDER(a.j); break;
+  case ARG_PTRDIFF: RENDER(a.t); break;
+  case ARG_DOUBLE: RENDER(a.d); break;
+  case ARG_STR: RENDER((char *)a.p); break;
+  case ARG_PTR:
+    if(spec[s->len - 1] == 'p') {
+      RENDER(a.p);
+    }
+    break;
+  default:
+    /* "%%" */
+    LOG_OUTPUT_DIRECT("%s", spec[s->len - 1] == '%' ? "%" : spec);
+    break;
+  }
+#undef RENDER
+}
+/*---------------------------------------------------------------------------*/
+int
+log_deferred_render(void)
+{
+  uint16_t pos = tail;
+  uint16_t end;
+  uint8_t kind;
+  const char *fmt;
+
+  if(dropped_reported != log_deferred_stats.dropped) {
+    LOG_OUTPUT_DIRECT("[log: %lu records dropped]\n",
+                      (unsigned long)(log_deferred_stats.dropped - dropped_reported));
+    dropped_reported = log_deferred_stats.dropped;
+  }
+
+  if(pos == head) {
+    return 0;
+  }
+  memory_barrier();
+
+  end = pos + ring[pos & RING_MASK];
+  kind = ring[(pos + 1) & RING_MASK];
+  pos += RECORD_HDR_LEN;
+  get(&pos, &fmt, sizeof(fmt));
+
+  if(kind == KIND_PREFIX) {
+    const char *module;
+    get(&pos, &module, sizeof(module));
+    LOG_OUTPUT_DIRECT("[%-4s: %-10s] ", fmt, module);
+  } else {
+    const char *p = fmt;
+    const char *text = fmt;
+    while(*p != '\0') {
+      struct spec s;
+      if(*p != '%') {
+        p++;
+        continue;
+      }
+      if(p > text) {
+        LOG_OUTPUT_DIRECT("%.*s", (int)(p - text), text);
+      }
+      p = parse_spec(p + 1, &s);
+      render_spec(&s, &pos);
+      text = p;
+    }
+    if(p > text) {
+      LOG_OUTPUT_DIRECT("%s", text);
+    }
+  }
+
+  /* Release the record to the producer */
+  memory_barrier();
+  tail = end;
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+void
+log_deferred_flush(void)
+{
+  while(log_deferred_render());
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(log_deferred_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  while(1) {
+    int i;
+    PROCESS_WAIT_EVENT_UNTIL(ev == PROCESS_EVENT_POLL);
+    /* Render a few records at a time, let other processes run in between */
+    for(i = 0; i < LOG_DEFERRED_BATCH; i++) {
+      if(!log_deferred_render()) {
+        break;
+      }
+    }
+    if(tail != head) {
+      process_poll(&log_deferred_process);
+    }
+  }
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
+void
+log_deferred_init(void)
+{
+  process_start(&log_deferred_process, NULL);
+  if(tail != head) {
+    /* Render the logs stored during startup */
+    process_poll(&log_deferred_process);
+  }
+}
+/*---------------------------------------------------------------------------*/
+#endif /* LOG_DEFERRED */
+/** @} */
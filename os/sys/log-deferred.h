@@ -0,0 +1,113 @@
+/*
+ * Copyright (c) 2026, Contiki-NG contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \addtogroup log
+ * @{
+ *
+ * \file
+ *         Deferred logging: LOG_* calls store the format string and
+ *         the raw arguments in a ring buffer, which a process renders
+ *         with LOG_OUTPUT_DIRECT later.
+ *
+ *         The ring has a single producer and a single consumer. Logging
+ *         from interrupt context while the main thread logs is not
+ *         supported. Format strings must be string constants, since
+ *         only their address is stored.
+ */
+
+#ifndef LOG_DEFERRED_H_
+#define LOG_DEFERRED_H_
+
+#include "contiki.h"
+
+/* Size of the log ring buffer in bytes. Must be a power of two, 32768 at most */
+#ifdef LOG_DEFERRED_CONF_BUF_SIZE
+#define LOG_DEFERRED_BUF_SIZE LOG_DEFERRED_CONF_BUF_SIZE
+#else /* LOG_DEFERRED_CONF_BUF_SIZE */
+#define LOG_DEFERRED_BUF_SIZE 1024
+#endif /* LOG_DEFERRED_CONF_BUF_SIZE */
+
+/* The longest string argument stored, longer strings are truncated */
+#ifdef LOG_DEFERRED_CONF_MAX_STRLEN
+#define LOG_DEFERRED_MAX_STRLEN LOG_DEFERRED_CONF_MAX_STRLEN
+#else /* LOG_DEFERRED_CONF_MAX_STRLEN */
+#define LOG_DEFERRED_MAX_STRLEN 40
+#endif /* LOG_DEFERRED_CONF_MAX_STRLEN */
+
+/* The number of records rendered each time the log process runs */
+#ifdef LOG_DEFERRED_CONF_BATCH
+#define LOG_DEFERRED_BATCH LOG_DEFERRED_CONF_BATCH
+#else /* LOG_DEFERRED_CONF_BATCH */
+#define LOG_DEFERRED_BATCH 4
+#endif /* LOG_DEFERRED_CONF_BATCH */
+
+struct log_deferred_stats {
+  uint32_t records; /* records stored */
+  uint32_t dropped; /* records dropped because the ring was full */
+  uint16_t max_used; /* high-water mark of the ring, in bytes */
+};
+
+extern struct log_deferred_stats log_deferred_stats;
+
+PROCESS_NAME(log_deferred_process);
+
+/**
+ * Store a printf-style log record in the ring
+ * \param fmt The format string, which must be a constant
+*/
+void log_deferred_printf(const char *fmt, ...)
+     __attribute__ ((__format__ (__printf__, 1, 2)));
+
+/**
+ * Store a module prefix record in the ring
+ * \param levelstr The log level string, a constant
+ * \param module The module name, a constant
+*/
+void log_deferred_prefix(const char *levelstr, const char *module);
+
+/**
+ * Render the oldest record of the ring
+ * \return 1 if a record was rendered, 0 if the ring was empty
+*/
+int log_deferred_render(void);
+
+/**
+ * Render all records of the ring, e.g. before a reset
+*/
+void log_deferred_flush(void);
+
+/**
+ * Start the process that renders the log records
+*/
+void log_deferred_init(void);
+
+#endif /* LOG_DEFERRED_H_ */
+/** @} */
@@ -47,6 +47,10 @@
 
 #include "contiki.h"
 #include "sys/process.h"
+#include "sys/energest.h"
+#if PROCESS_WITH_PRIORITIES
+#include "sys/critical.h"
+#endif /* PROCESS_WITH_PRIORITIES */
 
 /*
  * Pointer to the currently running process structure.
@@ -63,13 +67,38 @@ struct event_data {
   process_event_t ev;
   process_data_t data;
   struct process *p;
+#if PROCESS_WITH_PRIORITIES
+  process_num_events_t next;
+#endif /* PROCESS_WITH_PRIORITIES */
 };
 
 static process_num_events_t nevents, fevent;
 static struct event_data events[PROCESS_CONF_NUMEVENTS];
 
+#if PROCESS_WITH_PRIORITIES
+#if PROCESS_CONF_NUMEVENTS > 255
+#error PROCESS_CONF_NUMEVENTS must be at most 255 with PROCESS_CONF_WITH_PRIORITIES
+#endif
+#if PROCESS_PRIORITY_LEVELS < 1
+#error PROCESS_CONF_PRIORITY_LEVELS must be at least 1
+#endif
+
+/* One FIFO of events per priority, linked through the event slots.
+   fevent is the first free slot. */
+#define EVENT_NONE PROCESS_CONF_NUMEVENTS
+static process_num_events_t first_event[PROCESS_PRIORITY_LEVELS];
+static process_num_events_t last_event[PROCESS_PRIORITY_LEVELS];
+static process_num_events_t nevents_priority[PROCESS_PRIORITY_LEVELS];
+
+/* Processes that need to be polled, in the order they were polled */
+static struct process *first_poll, *last_poll;
+#endif /* PROCESS_WITH_PRIORITIES */
+
 #if PROCESS_CONF_STATS
 process_num_events_t process_maxevents;
+#if PROCESS_WITH_PRIORITIES
+process_num_events_t process_maxevents_priority[PROCESS_PRIORITY_LEVELS];
+#endif /* PROCESS_WITH_PRIORITIES */
 #endif
 
 static volatile unsigned char poll_requested;
@@ -175,6 +204,9 @@ static void
 call_process(struct process *p, process_event_t ev, process_data_t data)
 {
   int ret;
+#if ENERGEST_WITH_PROCESSES
+  struct process *energest_prev;
+#endif /* ENERGEST_WITH_PROCESSES */
 
 #if DEBUG
   if(p->state == PROCESS_STATE_CALLED) {
@@ -187,7 +219,13 @@ call_process(struct process *p, process_event_t ev, process_data_t data)
     PRINTF("process: calling process '%s' with event %d\n", PROCESS_NAME_STRING(p), ev);
     process_current = p;
     p->state = PROCESS_STATE_CALLED;
+#if ENERGEST_WITH_PROCESSES
+    energest_prev = energest_process_switch(p);
     ret = p->thread(&p->pt, ev, data);
+    energest_process_switch(energest_prev);
+#else /* ENERGEST_WITH_PROCESSES */
+    ret = p->thread(&p->pt, ev, data);
+#endif /* ENERGEST_WITH_PROCESSES */
     if(ret == PT_EXITED ||
        ret == PT_ENDED ||
        ev == PROCESS_EVENT_EXIT) {
@@ -207,6 +245,10 @@ process_exit(struct process *p)
 void
 process_init(void)
 {
+#if PROCESS_WITH_PRIORITIES
+  int i;
+#endif /* PROCESS_WITH_PRIORITIES */
+
   lastevent = PROCESS_EVENT_MAX;
 
   nevents = fevent = 0;
@@ -214,6 +256,20 @@ process_init(void)
   process_maxevents = 0;
 #endif /* PROCESS_CONF_STATS */
 
+#if PROCESS_WITH_PRIORITIES
+  for(i = 0; i < PROCESS_CONF_NUMEVENTS; i++) {
+    events[i].next = i + 1;
+  }
+  for(i = 0; i < PROCESS_PRIORITY_LEVELS; i++) {
+    first_event[i] = last_event[i] = EVENT_NONE;
+    nevents_priority[i] = 0;
+#if PROCESS_CONF_STATS
+    process_maxevents_priority[i] = 0;
+#endif /* PROCESS_CONF_STATS */
+  }
+  first_poll = last_poll = NULL;
+#endif /* PROCESS_WITH_PRIORITIES */
+
   process_current = process_list = NULL;
 }
 /*---------------------------------------------------------------------------*/
@@ -226,6 +282,28 @@ do_poll(void)
 {
   struct process *p;
 
+#if PROCESS_WITH_PRIORITIES
+  struct process *next;
+  int_master_status_t status;
+
+  /* Take the processes polled so far, polls from here on go to a new
+     list */
+  status = critical_enter();
+  p = first_poll;
+  first_poll = last_poll = NULL;
+  poll_requested = 0;
+  critical_exit(status);
+
+  for(; p != NULL; p = next) {
+    next = p->next_poll;
+    p->needspoll = 0;
+    /* The process may have exited since it was polled */
+    if(p->state != PROCESS_STATE_NONE) {
+      p->state = PROCESS_STATE_RUNNING;
+      call_process(p, PROCESS_EVENT_POLL, NULL);
+    }
+  }
+#else /* PROCESS_WITH_PRIORITIES */
   poll_requested = 0;
   /* Call the processes that needs to be polled. */
   for(p = process_list; p != NULL; p = p->next) {
@@ -235,6 +313,7 @@ do_poll(void)
       call_process(p, PROCESS_EVENT_POLL, NULL);
     }
   }
+#endif /* PROCESS_WITH_PRIORITIES */
 }
 /*---------------------------------------------------------------------------*/
 /*
@@ -260,6 +339,28 @@ do_event(void)
 
   if(nevents > 0) {
 
+#if PROCESS_WITH_PRIORITIES
+    process_num_events_t i;
+    int priority;
+
+    /* Take the first event of the highest priority, and put its
+       slot on the free list. */
+    for(priority = PROCESS_PRIORITY_LEVELS - 1;
+        first_event[priority] == EVENT_NONE; priority--);
+    i = first_event[priority];
+    ev = events[i].ev;
+    data = events[i].data;
+    receiver = events[i].p;
+
+    first_event[priority] = events[i].next;
+    if(first_event[priority] == EVENT_NONE) {
+      last_event[priority] = EVENT_NONE;
+    }
+    events[i].next = fevent;
+    fevent = i;
+    --nevents_priority[priority];
+    --nevents;
+#else /* PROCESS_WITH_PRIORITIES */
     /* There are events that we should deliver. */
     ev = events[fevent].ev;
 
@@ -270,6 +371,7 @@ do_event(void)
        and decrease the number of events. */
     fevent = (fevent + 1) % PROCESS_CONF_NUMEVENTS;
     --nevents;
+#endif /* PROCESS_WITH_PRIORITIES */
 
     /* If this is a broadcast event, we deliver it to all events, in
        order of their priority. */
@@ -322,6 +424,9 @@ int
 process_post(struct process *p, process_event_t ev, process_data_t data)
 {
   process_num_events_t snum;
+#if PROCESS_WITH_PRIORITIES
+  unsigned char priority;
+#endif /* PROCESS_WITH_PRIORITIES */
 
   if(PROCESS_CURRENT() == NULL) {
     PRINTF("process_post: NULL process posts event %d to process '%s', nevents %d\n",
@@ -343,7 +448,23 @@ process_post(struct process *p, process_event_t ev, process_data_t data)
     return PROCESS_ERR_FULL;
   }
 
+#if PROCESS_WITH_PRIORITIES
+  /* Take a free slot and append it to the queue of the receiver's
+     priority */
+  priority = p == PROCESS_BROADCAST ? PROCESS_PRIORITY_NORMAL : p->priority;
+  snum = fevent;
+  fevent = events[snum].next;
+  events[snum].next = EVENT_NONE;
+  if(last_event[priority] == EVENT_NONE) {
+    first_event[priority] = snum;
+  } else {
+    events[last_event[priority]].next = snum;
+  }
+  last_event[priority] = snum;
+  ++nevents_priority[priority];
+#else /* PROCESS_WITH_PRIORITIES */
   snum = (process_num_events_t)(fevent + nevents) % PROCESS_CONF_NUMEVENTS;
+#endif /* PROCESS_WITH_PRIORITIES */
   events[snum].ev = ev;
   events[snum].data = data;
   events[snum].p = p;
@@ -353,6 +474,11 @@ process_post(struct process *p, process_event_t ev, process_data_t data)
   if(nevents > process_maxevents) {
     process_maxevents = nevents;
   }
+#if PROCESS_WITH_PRIORITIES
+  if(nevents_priority[priority] > process_maxevents_priority[priority]) {
+    process_maxevents_priority[priority] = nevents_priority[priority];
+  }
+#endif /* PROCESS_WITH_PRIORITIES */
 #endif /* PROCESS_CONF_STATS */
 
   return PROCESS_ERR_OK;
@@ -373,8 +499,25 @@ process_poll(struct process *p)
   if(p != NULL) {
     if(p->state == PROCESS_STATE_RUNNING ||
        p->state == PROCESS_STATE_CALLED) {
+#if PROCESS_WITH_PRIORITIES
+      /* May be called from an interrupt handler */
+      int_master_status_t status = critical_enter();
+      if(!p->needspoll) {
+        p->next_poll = NULL;
+        if(last_poll == NULL) {
+          first_poll = p;
+        } else {
+          last_poll->next_poll = p;
+        }
+        last_poll = p;
+      }
+      p->needspoll = 1;
+      poll_requested = 1;
+      critical_exit(status);
+#else /* PROCESS_WITH_PRIORITIES */
       p->needspoll = 1;
       poll_requested = 1;
+#endif /* PROCESS_WITH_PRIORITIES */
     }
   }
 }
@@ -385,4 +528,18 @@ process_is_running(struct process *p)
   return p->state != PROCESS_STATE_NONE;
 }
 /*---------------------------------------------------------------------------*/
+#if PROCESS_WITH_PRIORITIES
+void
+process_set_priority(struct process *p, unsigned char priority)
+{
+  p->priority = MIN(priority, PROCESS_PRIORITY_HIGH);
+}
+/*---------------------------------------------------------------------------*/
+int
+process_nevents_priority(unsigned char priority)
+{
+  return priority < PROCESS_PRIORITY_LEVELS ? nevents_priority[priority] : 0;
+}
+#endif /* PROCESS_WITH_PRIORITIES */
+/*---------------------------------------------------------------------------*/
 /** @} */
@@ -88,6 +88,29 @@ typedef unsigned char process_num_events_t;
 #define PROCESS_CONF_NUMEVENTS 32
 #endif /* PROCESS_CONF_NUMEVENTS */
 
+/*
+ * With priorities, events are queued per priority of the receiving
+ * process and the highest priority event is delivered first. Polled
+ * processes are kept on a list, so polls are dispatched without
+ * walking all processes.
+ */
+#ifdef PROCESS_CONF_WITH_PRIORITIES
+#define PROCESS_WITH_PRIORITIES PROCESS_CONF_WITH_PRIORITIES
+#else
+#define PROCESS_WITH_PRIORITIES 0
+#endif
+
+#ifdef PROCESS_CONF_PRIORITY_LEVELS
+#define PROCESS_PRIORITY_LEVELS PROCESS_CONF_PRIORITY_LEVELS
+#else
+#define PROCESS_PRIORITY_LEVELS 2
+#endif
+
+/* Default priority of processes and of broadcast events */
+#define PROCESS_PRIORITY_NORMAL       0
+/* Priority of latency-critical processes such as the network stack */
+#define PROCESS_PRIORITY_HIGH         (PROCESS_PRIORITY_LEVELS - 1)
+
 #define PROCESS_EVENT_NONE            0x80
 #define PROCESS_EVENT_INIT            0x81
 #define PROCESS_EVENT_POLL            0x82
@@ -323,6 +346,13 @@ struct process {
   PT_THREAD((* thread)(struct pt *, process_event_t, process_data_t));
   struct pt pt;
   unsigned char state, needspoll;
+#if PROCESS_WITH_PRIORITIES
+  unsigned char priority;
+  struct process *next_poll;
+#endif /* PROCESS_WITH_PRIORITIES */
+#if ENERGEST_CONF_ON && ENERGEST_CONF_WITH_PROCESSES
+  unsigned char energest_entry;
+#endif /* ENERGEST_CONF_ON && ENERGEST_CONF_WITH_PROCESSES */
 };
 
 /**
@@ -423,9 +453,18 @@ extern struct process *process_current;
  * \sa PROCESS_CONTEXT_END()
  * \sa PROCESS_CURRENT()
  */
+#if ENERGEST_CONF_ON && ENERGEST_CONF_WITH_PROCESSES
+/* Declared in sys/energest.h */
+struct process *energest_process_switch(struct process *p);
+#define PROCESS_CONTEXT_BEGIN(p) {\
+struct process *tmp_current = PROCESS_CURRENT();\
+struct process *tmp_energest = energest_process_switch(p);\
+process_current = p
+#else /* ENERGEST_CONF_ON && ENERGEST_CONF_WITH_PROCESSES */
 #define PROCESS_CONTEXT_BEGIN(p) {\
 struct process *tmp_current = PROCESS_CURRENT();\
 process_current = p
+#endif /* ENERGEST_CONF_ON && ENERGEST_CONF_WITH_PROCESSES */
 
 /**
  * End a context switch
@@ -437,7 +476,12 @@ process_current = p
  *
  * \sa PROCESS_CONTEXT_START()
  */
+#if ENERGEST_CONF_ON && ENERGEST_CONF_WITH_PROCESSES
+#define PROCESS_CONTEXT_END(p) energest_process_switch(tmp_energest); \
+process_current = tmp_current; }
+#else /* ENERGEST_CONF_ON && ENERGEST_CONF_WITH_PROCESSES */
 #define PROCESS_CONTEXT_END(p) process_current = tmp_current; }
+#endif /* ENERGEST_CONF_ON && ENERGEST_CONF_WITH_PROCESSES */
 
 /**
  * \brief      Allocate a global event number.
@@ -519,8 +563,42 @@ int process_is_running(struct process *p);
  */
 int process_nevents(void);
 
+#if PROCESS_WITH_PRIORITIES
+/**
+ * Set the priority of a process.
+ *
+ * Events posted to the process are delivered before events posted
+ * to processes with a lower priority. Without PROCESS_CONF_WITH_PRIORITIES
+ * all events are delivered in the order they were posted.
+ *
+ * \param p The process.
+ * \param priority From PROCESS_PRIORITY_NORMAL to PROCESS_PRIORITY_HIGH.
+ */
+void process_set_priority(struct process *p, unsigned char priority);
+
+/**
+ * Number of events of a priority waiting to be processed.
+ *
+ * \param priority The priority.
+ * \return The number of events that are currently waiting to be
+ * processed with this priority.
+ */
+int process_nevents_priority(unsigned char priority);
+#else /* PROCESS_WITH_PRIORITIES */
+#define process_set_priority(p, priority)
+#endif /* PROCESS_WITH_PRIORITIES */
+
 /** @} */
 
+#if PROCESS_CONF_STATS
+/** Largest number of events waiting in the queue */
+extern process_num_events_t process_maxevents;
+#if PROCESS_WITH_PRIORITIES
+/** Largest number of events waiting, per priority */
+extern process_num_events_t process_maxevents_priority[PROCESS_PRIORITY_LEVELS];
+#endif /* PROCESS_WITH_PRIORITIES */
+#endif /* PROCESS_CONF_STATS */
+
 extern struct process *process_list;
 
 #define PROCESS_LIST() process_list
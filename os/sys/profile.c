@@ -0,0 +1,107 @@
+/*
+ * Copyright (c) 2026, Contiki-NG contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \addtogroup profile
+ * @{
+ *
+ * \file
+ *         Execution time profiler
+ */
+
+#include "contiki.h"
+#include "sys/profile.h"
+#include "sys/critical.h"
+
+#include <string.h>
+
+#if PROFILE_ON
+
+static struct profile_probe *probes;
+/*---------------------------------------------------------------------------*/
+void
+profile_record(struct profile_probe *probe, PROFILE_TIME_T time)
+{
+  PROFILE_TIME_T t;
+  int_master_status_t status;
+  int bin;
+
+  if(!probe->registered) {
+    /* The first time may come from an interrupt handler */
+    status = critical_enter();
+    if(!probe->registered) {
+      probe->registered = 1;
+      probe->next = probes;
+      probes = probe;
+    }
+    critical_exit(status);
+  }
+
+  if(probe->count == 0 || time < probe->min) {
+    probe->min = time;
+  }
+  if(probe->count == 0 || time > probe->max) {
+    probe->max = time;
+  }
+  probe->count++;
+  probe->total += time;
+
+  /* The bin is the position of the highest bit set */
+  for(bin = 0, t = time >> 1; t != 0 && bin < PROFILE_HISTOGRAM_BINS - 1;
+      t >>= 1) {
+    bin++;
+  }
+  if(probe->histogram[bin] != UINT16_MAX) {
+    probe->histogram[bin]++;
+  }
+}
+/*---------------------------------------------------------------------------*/
+struct profile_probe *
+profile_head(void)
+{
+  return probes;
+}
+/*---------------------------------------------------------------------------*/
+void
+profile_reset(void)
+{
+  struct profile_probe *probe;
+
+  for(probe = probes; probe != NULL; probe = probe->next) {
+    probe->count = 0;
+    probe->total = 0;
+    probe->min = 0;
+    probe->max = 0;
+    memset(probe->histogram, 0, sizeof(probe->histogram));
+  }
+}
+/*---------------------------------------------------------------------------*/
+#endif /* PROFILE_ON */
+/** @} */
@@ -0,0 +1,138 @@
+/*
+ * Copyright (c) 2026, Contiki-NG contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \addtogroup sys
+ * @{
+ *
+ * \defgroup profile Execution time profiling
+ *
+ * Named probes measure the time spent between PROFILE_BEGIN() and
+ * PROFILE_END(), and keep the count, minimum, mean, maximum and a
+ * histogram of the times. The network stack has probes at the layer
+ * boundaries. The probes are dumped with the shell command "profile".
+ *
+ * A probe has one start time, so it must not be nested in itself, e.g.
+ * in code that runs both from a process and from an interrupt.
+ * @{
+ *
+ * \file
+ *         Header file for the execution time profiler
+ */
+
+#ifndef PROFILE_H_
+#define PROFILE_H_
+
+#include "contiki.h"
+
+/* Enable the profiler probes */
+#ifdef PROFILE_CONF_ON
+#define PROFILE_ON PROFILE_CONF_ON
+#else /* PROFILE_CONF_ON */
+#define PROFILE_ON 0
+#endif /* PROFILE_CONF_ON */
+
+/* The timestamps of the probes, e.g. a cycle counter. RTIMER_NOW() by default. */
+#ifdef PROFILE_CONF_NOW
+#define PROFILE_NOW() PROFILE_CONF_NOW()
+#define PROFILE_SECOND PROFILE_CONF_SECOND
+#define PROFILE_TIME_T PROFILE_CONF_TIME_T
+#else /* PROFILE_CONF_NOW */
+#define PROFILE_NOW() RTIMER_NOW()
+#define PROFILE_SECOND RTIMER_SECOND
+#define PROFILE_TIME_T rtimer_clock_t
+#endif /* PROFILE_CONF_NOW */
+
+/* The number of histogram bins. Bin i > 0 counts the times from 2^i to
+ * 2^(i+1) - 1 ticks, the last one all longer times as well. */
+#ifdef PROFILE_CONF_HISTOGRAM_BINS
+#define PROFILE_HISTOGRAM_BINS PROFILE_CONF_HISTOGRAM_BINS
+#else /* PROFILE_CONF_HISTOGRAM_BINS */
+#define PROFILE_HISTOGRAM_BINS 16
+#endif /* PROFILE_CONF_HISTOGRAM_BINS */
+
+struct profile_probe {
+  struct profile_probe *next;
+  const char *name;
+  PROFILE_TIME_T start;
+  PROFILE_TIME_T min;
+  PROFILE_TIME_T max;
+  uint32_t count;
+  uint32_t total; /* in ticks, wraps around */
+  uint16_t histogram[PROFILE_HISTOGRAM_BINS]; /* saturates */
+  uint8_t registered;
+};
+
+#if PROFILE_ON
+
+/** Define a probe, with a name for the report */
+#define PROFILE_PROBE(probe, probe_name) \
+  static struct profile_probe probe = { .name = probe_name }
+/** Start a measurement */
+#define PROFILE_BEGIN(probe) do { (probe).start = PROFILE_NOW(); } while(0)
+/** End the measurement started by PROFILE_BEGIN() */
+#define PROFILE_END(probe) \
+  profile_record(&(probe), (PROFILE_TIME_T)(PROFILE_NOW() - (probe).start))
+/** Record a time measured otherwise, e.g. from per-packet timestamps */
+#define PROFILE_RECORD(probe, time) profile_record(&(probe), (time))
+
+#else /* PROFILE_ON */
+
+#define PROFILE_PROBE(probe, probe_name) \
+  extern struct profile_probe probe
+#define PROFILE_BEGIN(probe) do { } while(0)
+#define PROFILE_END(probe) do { } while(0)
+#define PROFILE_RECORD(probe, time) do { } while(0)
+
+#endif /* PROFILE_ON */
+
+/**
+ * Add a time to a probe
+ * \param probe The probe
+ * \param time The time, in PROFILE_SECOND ticks
+ */
+void profile_record(struct profile_probe *probe, PROFILE_TIME_T time);
+
+/**
+ * The first probe of the report. Probes appear once they have recorded
+ * a time; use probe->next for the following ones.
+ */
+struct profile_probe *profile_head(void);
+
+/**
+ * Clear the times of all probes
+ */
+void profile_reset(void);
+
+#endif /* PROFILE_H_ */
+/**
+ * @}
+ * @}
+ */
@@ -45,22 +45,23 @@ typedef struct test_struct {
 } test_struct_t;
 
 MEMB(memb_pool, test_struct_t, NUM_MEMB_BLOCKS);
+MEMB_FREELIST(memb_freelist_pool, test_struct_t, NUM_MEMB_BLOCKS);
 
-int
-main(void)
+static int
+test_memb(struct memb *m)
 {
   int ret;
   test_struct_t *memb_block_p;
   test_struct_t *memb_block_list[NUM_MEMB_BLOCKS];
 
   /* initialize the memory blocks */
-  memb_init(&memb_pool);
+  memb_init(m);
 
   /*
    * all the blocks should be "unused"; memb_numfree() should return
    * NUM_MEMB_BLOCKS
    */
-  if((ret = memb_numfree(&memb_pool)) != NUM_MEMB_BLOCKS) {
+  if((ret = memb_numfree(m)) != NUM_MEMB_BLOCKS) {
     printf("test failed: memb_numfree() returns %d, which should be %d\n",
            ret, NUM_MEMB_BLOCKS);
     return -1;
@@ -71,15 +72,15 @@ main(void)
   /* allocate memory blocks */
   memset(memb_block_list, 0, sizeof(memb_block_list));
   for(int i = 0; i < NUM_MEMB_BLOCKS; i++) {
-    memb_block_p = (test_struct_t *)memb_alloc(&memb_pool);
+    memb_block_p = (test_struct_t *)memb_alloc(m);
     if(memb_block_p == NULL) {
       printf("test failed: memb_alloc() returns NULL with i==%d\n", i);
       return -1;
-    } else if((ret = memb_inmemb(&memb_pool, memb_block_p)) != 1) {
+    } else if((ret = memb_inmemb(m, memb_block_p)) != 1) {
       printf("test failed: %p returned memb_alloc() is invalid\n",
              memb_block_p);
       return -1;
-    } else if((ret = memb_numfree(&memb_pool)) != NUM_MEMB_BLOCKS - i - 1) {
+    } else if((ret = memb_numfree(m)) != NUM_MEMB_BLOCKS - i - 1) {
       printf("test failed: memb_numfree() returns an invalid value %d, "
              "which should be %d\n", ret, NUM_MEMB_BLOCKS - i - 1);
       return -1;
@@ -91,7 +92,7 @@ main(void)
   }
 
   /* try to allocate another memory block, which should fail */
-  if((memb_block_p = (test_struct_t *)memb_alloc(&memb_pool)) != NULL) {
+  if((memb_block_p = (test_struct_t *)memb_alloc(m)) != NULL) {
     printf("test failed: memb_alloc() allocates more memory than defined\n");
     return -1;
   } else {
@@ -101,11 +102,11 @@ main(void)
   /* free the allocated memory blocks */
   for(int i = 0; i < NUM_MEMB_BLOCKS; i++) {
     memb_block_p = memb_block_list[i];
-    if((ret = memb_free(&memb_pool, memb_block_p)) != 0) {
+    if((ret = memb_free(m, memb_block_p)) != 0) {
       printf("test failed: cannot memb_free() to %p, return value is %d\n",
              memb_block_p, ret);
       return -1;
-    } else if((ret = memb_numfree(&memb_pool)) != i + 1) {
+    } else if((ret = memb_numfree(m)) != i + 1) {
       printf("test failed: memb_numfree() returns an invalid value %d, "
              "which should be %d\n", ret, i + 1);
       return -1;
@@ -120,12 +121,12 @@ main(void)
    */
   for(int i = 0; i < NUM_MEMB_BLOCKS; i++) {
     memb_block_p = memb_block_list[i];
-    if((ret = memb_free(&memb_pool, memb_block_p)) != -1) {
+    if((ret = memb_free(m, memb_block_p)) != -1) {
       /* double free shouldn't succeed (we should have -1 returned) */
       printf("test failed: cannot double free to %p, return value is %d\n",
              memb_block_p, ret);
       return -1;
-    } else if((ret = memb_numfree(&memb_pool)) != NUM_MEMB_BLOCKS) {
+    } else if((ret = memb_numfree(m)) != NUM_MEMB_BLOCKS) {
       /* memb_numfree() should return NUM_MEMB_BLOCKS as no memory is used */
       printf("test failed: memb_numfree() returns an invalid value %d, "
              "which should be %d\n", ret, NUM_MEMB_BLOCKS);
@@ -137,10 +138,10 @@ main(void)
   }
 
   /* free with a invalid address, which are not the beginning of a block */
-  if((memb_block_p = memb_alloc(&memb_pool)) == NULL) {
+  if((memb_block_p = memb_alloc(m)) == NULL) {
     printf("test failed: memb_alloc() returns NULL while no memory is used\n");
     return -1;
-  } else if(memb_free(&memb_pool, ONE_BYTE_OFF_ADDR(memb_block_p)) != -1) {
+  } else if(memb_free(m, ONE_BYTE_OFF_ADDR(memb_block_p)) != -1) {
     printf("test failed: memb_free accepts an invalid address %p, "
            "which is one byte off from memory block starting at %p\n",
            ONE_BYTE_OFF_ADDR(memb_block_p), memb_block_p);
@@ -148,8 +149,19 @@ main(void)
   } else {
     printf("- memb_free is OK: reject an invalid address %p\n",
            ONE_BYTE_OFF_ADDR(memb_block_p));
-    (void)memb_free(&memb_pool, memb_block_p);
+    (void)memb_free(m, memb_block_p);
   }
 
   return 0;
 }
+/*---------------------------------------------------------------------------*/
+int
+main(void)
+{
+  printf("MEMB:\n");
+  if(test_memb(&memb_pool) != 0) {
+    return -1;
+  }
+  printf("MEMB_FREELIST:\n");
+  return test_memb(&memb_freelist_pool);
+}
@@ -0,0 +1,45 @@
+#!/bin/bash
+source ../utils.sh
+
+# Contiki directory
+CONTIKI=$1
+
+# Example code directory
+CODE_DIR=$CONTIKI/examples/JamSense-replay
+CODE=jamsense-replay
+
+echo "Building replay tool"
+make -C $CODE_DIR TARGET=native > make.log 2> make.err
+
+echo "Generating and replaying synthetic traces"
+for TYPE in none constant reactive ; do
+  $CODE_DIR/$CODE.native -g $TYPE $CODE-$TYPE.csv >> make.log 2>> make.err
+done
+timeout 120 $CODE_DIR/$CODE.native $CODE-none.csv $CODE-constant.csv $CODE-reactive.csv > $CODE.log 2> $CODE.err
+STATUS=$?
+
+echo "Replaying through the RSSI capture path"
+timeout 120 $CODE_DIR/$CODE.native -c $CODE-none.csv $CODE-constant.csv $CODE-reactive.csv >> $CODE.log 2>> $CODE.err
+STATUS=$(( STATUS | $? ))
+
+if [ $STATUS -ne 0 ] || [ $(grep -c "Accuracy: 3/3" $CODE.log) -ne 2 ] ; then
+  echo "==== make.log ====" ; cat make.log;
+  echo "==== make.err ====" ; cat make.err;
+  echo "==== $CODE.log ====" ; cat $CODE.log;
+  echo "==== $CODE.err ====" ; cat $CODE.err;
+
+  printf "%-32s TEST FAIL\n" "$CODE" | tee $CODE.testlog;
+else
+  cp $CODE.log $CODE.testlog
+  printf "%-32s TEST OK\n" "$CODE" | tee $CODE.testlog;
+fi
+
+rm make.log
+rm make.err
+rm $CODE.log
+rm $CODE.err
+rm $CODE-*.csv
+
+# We do not want Make to stop -> Return 0
+# The Makefile will check if a log contains FAIL at the end
+exit 0
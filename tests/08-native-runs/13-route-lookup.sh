@@ -0,0 +1,40 @@
+#!/bin/bash
+source ../utils.sh
+
+# Contiki directory
+CONTIKI=$1
+
+# Example code directory
+CODE_DIR=$CONTIKI/examples/benchmarks/route-lookup
+CODE=route-lookup
+
+STATUS=0
+for INDEX in 0 1 ; do
+  echo "Running route lookup benchmark, route index $INDEX"
+  make -C $CODE_DIR clean > /dev/null 2>&1
+  make -C $CODE_DIR TARGET=native DEFINES=UIP_DS6_ROUTE_CONF_INDEX=$INDEX >> make.log 2>> make.err
+  timeout 120 $CODE_DIR/$CODE.native >> $CODE.log 2>> $CODE.err
+  STATUS=$(( STATUS | $? ))
+done
+make -C $CODE_DIR clean > /dev/null 2>&1
+
+if [ $STATUS -ne 0 ] || [ $(grep -c "Result: OK" $CODE.log) -ne 2 ] ; then
+  echo "==== make.log ====" ; cat make.log;
+  echo "==== make.err ====" ; cat make.err;
+  echo "==== $CODE.log ====" ; cat $CODE.log;
+  echo "==== $CODE.err ====" ; cat $CODE.err;
+
+  printf "%-32s TEST FAIL\n" "$CODE" | tee $CODE.testlog;
+else
+  cp $CODE.log $CODE.testlog
+  printf "%-32s TEST OK\n" "$CODE" | tee $CODE.testlog;
+fi
+
+rm make.log
+rm make.err
+rm $CODE.log
+rm $CODE.err
+
+# We do not want Make to stop -> Return 0
+# The Makefile will check if a log contains FAIL at the end
+exit 0
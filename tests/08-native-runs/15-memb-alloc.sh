@@ -0,0 +1,37 @@
+#!/bin/bash
+source ../utils.sh
+
+# Contiki directory
+CONTIKI=$1
+
+# Example code directory
+CODE_DIR=$CONTIKI/examples/benchmarks/memb-alloc
+CODE=memb-alloc
+
+echo "Running MEMB benchmark"
+make -C $CODE_DIR clean > /dev/null 2>&1
+make -C $CODE_DIR TARGET=native >> make.log 2>> make.err
+timeout 120 $CODE_DIR/$CODE.native >> $CODE.log 2>> $CODE.err
+STATUS=$?
+make -C $CODE_DIR clean > /dev/null 2>&1
+
+if [ $STATUS -ne 0 ] || [ $(grep -c "Result: OK" $CODE.log) -ne 1 ] ; then
+  echo "==== make.log ====" ; cat make.log;
+  echo "==== make.err ====" ; cat make.err;
+  echo "==== $CODE.log ====" ; cat $CODE.log;
+  echo "==== $CODE.err ====" ; cat $CODE.err;
+
+  printf "%-32s TEST FAIL\n" "$CODE" | tee $CODE.testlog;
+else
+  cp $CODE.log $CODE.testlog
+  printf "%-32s TEST OK\n" "$CODE" | tee $CODE.testlog;
+fi
+
+rm make.log
+rm make.err
+rm $CODE.log
+rm $CODE.err
+
+# We do not want Make to stop -> Return 0
+# The Makefile will check if a log contains FAIL at the end
+exit 0
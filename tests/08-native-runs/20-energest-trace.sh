@@ -0,0 +1,50 @@
+#!/bin/bash
+source ../utils.sh
+
+# Contiki directory
+CONTIKI=$1
+
+# Example code directory
+CODE_DIR=$CONTIKI/examples/libs/energest-trace
+CODE=energest-trace
+DECODER_DIR=$CONTIKI/tools/energest-trace
+
+echo "Running Energest trace example"
+make -C $CODE_DIR clean > /dev/null 2>&1
+make -C $CODE_DIR TARGET=native >> make.log 2>> make.err
+make -C $DECODER_DIR >> make.log 2>> make.err
+rm -f energest.trc
+# The example runs until it is stopped
+timeout 7 $CODE_DIR/example.native >> $CODE.log 2>> $CODE.err
+$DECODER_DIR/energest-decode -c energest.trc > $CODE.csv 2>> $CODE.err
+STATUS=$?
+make -C $CODE_DIR clean > /dev/null 2>&1
+make -C $DECODER_DIR clean > /dev/null 2>&1
+
+# The CPU time of Busy and the radio time of Listen must show up
+BUSY=$(awk -F, '$4 == "\"Busy\"" && $5 > 0' $CODE.csv | wc -l)
+LISTEN=$(awk -F, '$4 == "\"Listen\"" && $9 > 0' $CODE.csv | wc -l)
+
+if [ $STATUS -ne 0 ] || [ $BUSY -eq 0 ] || [ $LISTEN -eq 0 ] ; then
+  echo "==== make.log ====" ; cat make.log;
+  echo "==== make.err ====" ; cat make.err;
+  echo "==== $CODE.log ====" ; cat $CODE.log;
+  echo "==== $CODE.err ====" ; cat $CODE.err;
+  echo "==== $CODE.csv ====" ; cat $CODE.csv;
+
+  printf "%-32s TEST FAIL\n" "$CODE" | tee $CODE.testlog;
+else
+  cp $CODE.csv $CODE.testlog
+  printf "%-32s TEST OK\n" "$CODE" | tee $CODE.testlog;
+fi
+
+rm make.log
+rm make.err
+rm $CODE.log
+rm $CODE.err
+rm $CODE.csv
+rm -f energest.trc
+
+# We do not want Make to stop -> Return 0
+# The Makefile will check if a log contains FAIL at the end
+exit 0
@@ -0,0 +1,134 @@
+#!/bin/bash
+source ../utils.sh
+
+# Contiki directory
+CONTIKI=$1
+
+# Example code directory
+CODE_DIR=$CONTIKI/examples/benchmarks/mqtt-stream
+CODE=mqtt-stream
+
+# A broker that only knows the exchange the check makes: it checks the
+# streamed PUBLISH from the node and answers with one of the same size.
+# MQTTv5 packets carry properties, the inbound PUBLISH a non-empty set.
+cat > mqtt-stream-broker.py <<'BROKER'
+import socket, struct, sys
+
+v5 = sys.argv[1] == "5"
+size = 70000
+pattern = bytes(((i * 7 + (i >> 8)) & 0xff) for i in range(size))
+
+def encode_len(n):
+    out = bytearray()
+    while True:
+        b = n % 128
+        n //= 128
+        out.append(b | (0x80 if n else 0))
+        if not n:
+            return bytes(out)
+
+def read_exact(c, n):
+    data = b""
+    while len(data) < n:
+        chunk = c.recv(n - len(data))
+        if not chunk:
+            raise EOFError
+        data += chunk
+    return data
+
+def read_packet(c):
+    fhdr = read_exact(c, 1)[0]
+    length, mult = 0, 1
+    while True:
+        b = read_exact(c, 1)[0]
+        length += (b & 0x7f) * mult
+        mult *= 128
+        if not b & 0x80:
+            break
+    return fhdr, read_exact(c, length)
+
+def skip_props(body, pos):
+    length, mult = 0, 1
+    while True:
+        b = body[pos]
+        pos += 1
+        length += (b & 0x7f) * mult
+        mult *= 128
+        if not b & 0x80:
+            return pos + length
+
+s = socket.socket(socket.AF_INET6, socket.SOCK_STREAM)
+s.setsockopt(socket.SOL_SOCKET, socket.SO_REUSEADDR, 1)
+s.bind(("::", 1883))
+s.listen(1)
+s.settimeout(60)
+c, _ = s.accept()
+c.settimeout(30)
+# Reset on exit: the next run's node reuses the same address and port
+c.setsockopt(socket.SOL_SOCKET, socket.SO_LINGER, struct.pack("ii", 1, 0))
+while True:
+    fhdr, body = read_packet(c)
+    kind = fhdr & 0xf0
+    if kind == 0x10:
+        c.sendall(b"\x20\x03\x00\x00\x00" if v5 else b"\x20\x02\x00\x00")
+    elif kind == 0x80:
+        c.sendall(b"\x90\x04" + body[:2] + b"\x00\x00" if v5
+                  else b"\x90\x03" + body[:2] + b"\x00")
+    elif kind == 0xc0:
+        c.sendall(b"\xd0\x00")
+    elif kind == 0x30:
+        pos = 2 + (body[0] << 8 | body[1])
+        topic = body[2:pos].decode()
+        if v5:
+            pos = skip_props(body, pos)
+        ok = topic == "bench/out" and body[pos:] == pattern
+        print("broker: PUBLISH on %s, %d bytes, %s"
+              % (topic, len(body) - pos, "OK" if ok else "MISMATCH"))
+        topic = b"bench/in"
+        vhdr = len(topic).to_bytes(2, "big") + topic
+        if v5:
+            vhdr += b"\x02\x01\x01"
+        c.sendall(b"\x30" + encode_len(len(vhdr) + size) + vhdr + pattern)
+BROKER
+
+for VERSION in 3_1 3_1_1 5
+do
+  echo "Running streaming MQTT check, version $VERSION"
+  make -C $CODE_DIR clean > /dev/null 2>&1
+  make -C $CODE_DIR TARGET=native \
+    DEFINES=MQTT_CONF_VERSION=MQTT_PROTOCOL_VERSION_$VERSION \
+    >> make.log 2>> make.err
+  python3 mqtt-stream-broker.py $VERSION >> $CODE.log 2>> $CODE.err &
+  BROKERID=$!
+  sleep 1
+  sudo timeout 60 $CODE_DIR/$CODE.native >> $CODE.log 2>> $CODE.err
+  STATUS=$?
+  kill_bg $BROKERID
+  if [ $STATUS -ne 0 ] ; then
+    break
+  fi
+done
+make -C $CODE_DIR clean > /dev/null 2>&1
+
+if [ $STATUS -ne 0 ] || [ $(grep -c "Result: OK" $CODE.log) -ne 3 ] ||
+   [ $(grep -c "broker: .* OK" $CODE.log) -ne 3 ] ; then
+  echo "==== make.log ====" ; cat make.log;
+  echo "==== make.err ====" ; cat make.err;
+  echo "==== $CODE.log ====" ; cat $CODE.log;
+  echo "==== $CODE.err ====" ; cat $CODE.err;
+
+  printf "%-32s TEST FAIL\n" "$CODE" | tee $CODE.testlog;
+else
+  cp $CODE.log $CODE.testlog
+  printf "%-32s TEST OK\n" "$CODE" | tee $CODE.testlog;
+fi
+
+rm make.log
+rm make.err
+rm $CODE.log
+rm $CODE.err
+rm mqtt-stream-broker.py
+
+# We do not want Make to stop -> Return 0
+# The Makefile will check if a log contains FAIL at the end
+exit 0
@@ -0,0 +1,254 @@
+/*
+ * Copyright (c) 2026, Contiki-NG contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *         Decodes the binary Energest trace of os/services/energest-trace.
+ *         Frames are searched for in the input, so that a serial stream
+ *         with log output in between can be decoded as well.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+/*---------------------------------------------------------------------------*/
+#define SYNC1         0xe5
+#define SYNC2         0x7e
+#define VERSION       1
+#define HEADER_LEN    5
+#define CRC_LEN       2
+#define PAYLOAD_MIN   14
+
+static const char *type_names[] = {
+  "CPU", "LPM", "Deep LPM", "Radio Tx", "Radio Rx"
+};
+#define NUM_TYPE_NAMES (sizeof(type_names) / sizeof(type_names[0]))
+
+static int csv;
+/*---------------------------------------------------------------------------*/
+static int
+usage(int result)
+{
+  printf("Usage: energest-decode [-c] [FILE]\n");
+  printf("       -c for comma-separated output, in ticks\n");
+  printf("       Reads the standard input if no file is given\n");
+  return result;
+}
+/*---------------------------------------------------------------------------*/
+/* The CRC-16 of os/lib/crc16.c */
+static uint16_t
+crc16_data(const uint8_t *data, int len, uint16_t acc)
+{
+  while(len--) {
+    acc ^= *data++;
+    acc = (acc >> 8) | (acc << 8);
+    acc ^= (acc & 0xff00) << 4;
+    acc ^= (acc >> 8) >> 4;
+    acc ^= (acc & 0xff00) >> 5;
+  }
+  return acc;
+}
+/*---------------------------------------------------------------------------*/
+static uint16_t
+get_u16(const uint8_t *p)
+{
+  return p[0] | (p[1] << 8);
+}
+/*---------------------------------------------------------------------------*/
+static uint32_t
+get_u32(const uint8_t *p)
+{
+  return get_u16(p) | ((uint32_t)get_u16(p + 2) << 16);
+}
+/*---------------------------------------------------------------------------*/
+static const char *
+type_name(int type, char *buf, size_t len)
+{
+  if(type < NUM_TYPE_NAMES) {
+    return type_names[type];
+  }
+  snprintf(buf, len, "Type %d", type);
+  return buf;
+}
+/*---------------------------------------------------------------------------*/
+/* Check that the entries fit the payload exactly */
+static int
+check_entries(const uint8_t *p, const uint8_t *end, int types, int entries)
+{
+  while(entries--) {
+    if(p >= end || end - p < 1 + p[0] + 4 * types) {
+      return 0;
+    }
+    p += 1 + p[0] + 4 * types;
+  }
+  return p == end;
+}
+/*---------------------------------------------------------------------------*/
+static void
+print_frame(const uint8_t *payload, const uint8_t *end)
+{
+  uint32_t sequence = get_u32(payload);
+  uint32_t second = get_u32(payload + 4);
+  uint32_t period = get_u32(payload + 8);
+  int types = payload[12];
+  int entries = payload[13];
+  const uint8_t *p = payload + PAYLOAD_MIN;
+  char buf[16];
+  char name[256];
+  int i;
+  int t;
+
+  if(!csv) {
+    printf("Frame %lu: %.3f s\n", (unsigned long)sequence,
+           second ? (double)period / second : 0.0);
+    printf("  %-16s", "Process");
+    for(t = 0; t < types; t++) {
+      printf(" %17s", type_name(t, buf, sizeof(buf)));
+    }
+    printf("\n");
+  }
+
+  for(i = 0; i < entries; i++) {
+    memcpy(name, p + 1, p[0]);
+    name[p[0]] = '\0';
+    p += 1 + p[0];
+    if(i == 0) {
+      strcpy(name, "(none)");
+    }
+    if(csv) {
+      printf("%lu,%lu,%lu,\"%s\"", (unsigned long)sequence,
+             (unsigned long)second, (unsigned long)period, name);
+    } else {
+      printf("  %-16s", name);
+    }
+    for(t = 0; t < types; t++) {
+      uint32_t time = get_u32(p);
+      p += 4;
+      if(csv) {
+        printf(",%lu", (unsigned long)time);
+      } else {
+        printf(" %9.1f ms %3lu%%", second ? 1000.0 * time / second : 0.0,
+               period ? (unsigned long)(100ull * time / period) : 0);
+      }
+    }
+    printf("\n");
+  }
+}
+/*---------------------------------------------------------------------------*/
+int
+main(int argc, char **argv)
+{
+  FILE *in = stdin;
+  uint8_t *data = NULL;
+  size_t len = 0;
+  size_t size = 0;
+  size_t pos;
+  size_t n;
+  int frames = 0;
+  int errors = 0;
+  int i;
+
+  for(i = 1; i < argc && argv[i][0] == '-' && argv[i][1] != '\0'; i++) {
+    if(strcmp(argv[i], "-c") == 0) {
+      csv = 1;
+    } else if(strcmp(argv[i], "-h") == 0) {
+      return usage(0);
+    } else {
+      fprintf(stderr, "energest-decode: unknown option %s\n", argv[i]);
+      return usage(1);
+    }
+  }
+  if(i < argc) {
+    in = fopen(argv[i], "rb");
+    if(in == NULL) {
+      perror(argv[i]);
+      return 1;
+    }
+  }
+
+  do {
+    if(len == size) {
+      size = size ? size * 2 : 4096;
+      data = realloc(data, size);
+      if(data == NULL) {
+        perror("energest-decode");
+        return 1;
+      }
+    }
+    n = fread(data + len, 1, size - len, in);
+    len += n;
+  } while(n > 0);
+
+  if(csv) {
+    printf("frame,second,period,process");
+    for(i = 0; i < NUM_TYPE_NAMES; i++) {
+      printf(",%s", type_names[i]);
+    }
+    printf("\n");
+  }
+
+  for(pos = 0; pos + HEADER_LEN + PAYLOAD_MIN + CRC_LEN <= len; pos++) {
+    const uint8_t *frame = data + pos;
+    size_t payload_len;
+
+    if(frame[0] != SYNC1 || frame[1] != SYNC2 || frame[2] != VERSION) {
+      continue;
+    }
+    payload_len = get_u16(frame + 3);
+    if(payload_len < PAYLOAD_MIN
+       || pos + HEADER_LEN + payload_len + CRC_LEN > len) {
+      continue;
+    }
+    if(crc16_data(frame + 2, HEADER_LEN - 2 + payload_len, 0)
+       != get_u16(frame + HEADER_LEN + payload_len)) {
+      /* Sync bytes in the log output, or a damaged frame */
+      errors++;
+      continue;
+    }
+    if(!check_entries(frame + HEADER_LEN + PAYLOAD_MIN,
+                      frame + HEADER_LEN + payload_len,
+                      frame[HEADER_LEN + 12], frame[HEADER_LEN + 13])) {
+      errors++;
+      continue;
+    }
+    print_frame(frame + HEADER_LEN, frame + HEADER_LEN + payload_len);
+    frames++;
+    pos += HEADER_LEN + payload_len + CRC_LEN - 1;
+  }
+
+  if(!csv) {
+    printf("%d frames, %d errors\n", frames, errors);
+  }
+  free(data);
+  return frames > 0 ? 0 : 1;
+}
+/*---------------------------------------------------------------------------*/